@@ -12,3 +12,4 @@
 #include <common/multi_threading.h>
 #include <common/types.h>
 #include <common/xml_loader.h>
+#include <common/xml_schema.h>
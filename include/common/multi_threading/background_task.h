@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QtCore/QList>
 #include <QtCore/QMutex>
 #include <QtCore/QQueue>
 #include <QtCore/QThread>
@@ -66,6 +67,7 @@ class BackgroundTask : public QObject {
     QWaitCondition m_waitCondition; ///< Contidional vatiable for \c wait().
     ::std::function<void()>         m_newestTask; ///< Newest task.
     QQueue<::std::function<void()>> m_taskQueue;  ///< Task queue.
+    QList<BackgroundTaskThread *>   m_threads;    ///< Running threads.
 
   public:
     /**
@@ -89,7 +91,9 @@ class BackgroundTask : public QObject {
     void cancle();
 
     /**
-     * @brief		Wait until all tasks has been finished.
+     * @brief		Wait until all tasks has been finished. If it is called in
+     *				the thread of the object, the finished callbacks of the
+     *				tasks are dispatched while waiting.
      */
     void wait();
 
@@ -2,45 +2,15 @@
 
 #include <functional>
 
-#include <QtCore/QThread>
-#include <QtCore/QVector>
+#include <QtCore/QObject>
 
 /**
- * @brief	Thread to run task.
- */
-class MultiRunThread : public QThread {
-    Q_OBJECT
-  private:
-    ::std::function<void()> m_task; ///< Tash to run.
-
-  public:
-    /**
-     * @brief		Constructor.
-     *
-     * @param[in]	task			Tash to run.
-     * @param[in]	parent			Parent object.
-     */
-    MultiRunThread(::std::function<void()> task, QObject *parent);
-
-    /**
-     * @brief	Destructor.
-     */
-    virtual ~MultiRunThread();
-
-  protected:
-    /**
-     * @brief	Thread functiuon
-     */
-    virtual void run() override;
-};
-
-/**
- * @brief	Run task in multiple threads.
+ * @brief	Run task in multiple threads of the task pool.
  */
 class MultiRun : public QObject {
     Q_OBJECT
   private:
-    QVector<MultiRunThread *> m_threads; ///< Threads.
+    ::std::function<void()> m_task; ///< Task to run.
 
   public:
     /**
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <common/multi_threading/task_pool.h>
+
+/**
+ * @brief	Run stages in the task pool. Each stage starts as soon as all
+ *			the stages it depends on have been finished.
+ */
+class TaskGraph {
+  public:
+    /**
+     * @brief	Status of stage.
+     */
+    enum class StageStatus {
+        Waiting,  ///< Waiting for dependencies.
+        Running,  ///< Running.
+        Finished, ///< Finished.
+        Failed,   ///< Failed.
+        Skipped   ///< Skipped because a dependency failed.
+    };
+
+  private:
+    /**
+     * @brief	Stage.
+     */
+    struct Stage {
+        QString                 name;         ///< Name.
+        ::std::function<bool()> task;         ///< Task.
+        QVector<int>            dependents;   ///< Stages depend on this one.
+        int                     dependencies; ///< Number of dependencies.
+        int                     waiting;      ///< Dependencies unfinished.
+        StageStatus             status;       ///< Status.
+    };
+
+  private:
+    QVector<Stage>                          m_stages;     ///< Stages.
+    ::std::function<void(int, StageStatus)> m_statusFunc; ///< Status callback.
+    QMutex                                  m_lock;       ///< Lock.
+
+  public:
+    /**
+     * @brief		Constructor.
+     *
+     * @param[in]	statusFunc		Callback when the status of a stage
+     *								changed, it may be called in any thread.
+     */
+    TaskGraph(::std::function<void(int, StageStatus)> statusFunc = nullptr);
+
+    /**
+     * @brief		Add stage.
+     *
+     * @param[in]	name			Name of the stage.
+     * @param[in]	task			Task of the stage, returns false if
+     *								failed.
+     * @param[in]	dependencies	Stages the new stage depends on, all of
+     *								them must have been added.
+     *
+     * @return		On success, ID of the new stage is returned. Otherwise
+     *				returns -1.
+     */
+    int addStage(const QString &         name,
+                 ::std::function<bool()> task,
+                 const QVector<int> &    dependencies = {});
+
+    /**
+     * @brief		Get name of stage.
+     *
+     * @param[in]	stage		ID of stage.
+     *
+     * @return		Name of stage.
+     */
+    const QString &name(int stage) const;
+
+    /**
+     * @brief		Get status of stage.
+     *
+     * @param[in]	stage		ID of stage.
+     *
+     * @return		Status of stage.
+     */
+    StageStatus status(int stage);
+
+    /**
+     * @brief		Run all stages and wait until finished.
+     *
+     * @param[in]	signleThread	True if run in signle thread.
+     *
+     * @return		If all stages finished, true is returned. Otherwise
+     *				returns false.
+     */
+    bool run(bool signleThread = false);
+
+    /**
+     * @brief	Destructor.
+     */
+    virtual ~TaskGraph();
+
+  private:
+    /**
+     * @brief		Run stage.
+     *
+     * @param[in]	id			ID of the stage.
+     * @param[in]	group		Task group to run the dependents of the
+     *							stage, \c nullptr if run in signle thread.
+     */
+    void runStage(int id, TaskGroup *group);
+
+    /**
+     * @brief		Skip all stages depends on a failed stage.
+     *
+     * @param[in]	stage		ID of failed stage.
+     * @param[out]	changes		Status changed.
+     */
+    void skipDependents(int stage, QVector<QPair<int, StageStatus>> &changes);
+
+    /**
+     * @brief		Call status callback.
+     *
+     * @param[in]	changes		Status changed.
+     */
+    void notify(const QVector<QPair<int, StageStatus>> &changes);
+};
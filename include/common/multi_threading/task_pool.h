@@ -0,0 +1,226 @@
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include <interfaces/i_singleton.h>
+
+class TaskGroup;
+
+/**
+ * @brief	Worker thread of task pool.
+ */
+class TaskPoolThread : public QThread {
+    Q_OBJECT
+  private:
+    ::std::function<void()> m_task; ///< Task to run.
+
+  public:
+    /**
+     * @brief		Constructor.
+     *
+     * @param[in]	task			Task to run.
+     */
+    TaskPoolThread(::std::function<void()> task);
+
+    /**
+     * @brief	Destructor.
+     */
+    virtual ~TaskPoolThread();
+
+  protected:
+    /**
+     * @brief	Thread functiuon
+     */
+    virtual void run() override;
+};
+
+/**
+ * @brief	Process-wide work-stealing task pool. Each worker has its own
+ *			queue, it runs the newest task in its own queue first and steals
+ *			the oldest task from the other queues when its own queue is
+ *			empty.
+ */
+class TaskPool : public ISingleton<TaskPool> {
+    SIGNLETON_OBJECT(TaskPool)
+    friend class TaskGroup;
+
+  private:
+    /**
+     * @brief	Task.
+     */
+    struct Task {
+        ::std::function<void()> func;  ///< Function.
+        TaskGroup *             group; ///< Group of the task.
+    };
+
+    /**
+     * @brief	Task queue.
+     */
+    struct TaskQueue {
+        QMutex      lock;  ///< Lock.
+        QList<Task> tasks; ///< Tasks.
+    };
+
+  private:
+    QVector<TaskPoolThread *> m_threads;   ///< Worker threads.
+    QVector<TaskQueue *>      m_queues;    ///< Task queues.
+    QAtomicInt                m_pending;   ///< Count of queued tasks.
+    QAtomicInt                m_nextQueue; ///< Queue for external threads.
+    QMutex                    m_sleepLock; ///< Lock of idle workers.
+    QWaitCondition            m_sleepCond; ///< Condition of idle workers.
+    bool                      m_stop;      ///< Stop flag.
+    QAtomicInteger<quint64>   m_executed;  ///< Count of executed tasks.
+    QAtomicInteger<quint64>   m_stolen;    ///< Count of stolen tasks.
+
+    static thread_local int _workerIndex; ///< Worker index of current thread.
+
+  protected:
+    /**
+     * @brief		Constructor.
+     */
+    TaskPool();
+
+  public:
+    /**
+     * @brief		Get count of worker threads.
+     *
+     * @return		Count of worker threads.
+     */
+    int threadCount() const;
+
+    /**
+     * @brief		Call \c func for sub ranges of [begin, end) in parallel
+     *				and wait until finished.
+     *
+     * @param[in]	begin		Begin of the range.
+     * @param[in]	end			End of the range.
+     * @param[in]	func		Function to call with the sub range.
+     * @param[in]	grain		Maximum size of the sub ranges.
+     */
+    static void parallelFor(int                                    begin,
+                            int                                    end,
+                            const ::std::function<void(int, int)> &func,
+                            int                                    grain = 1);
+
+    /**
+     * @brief	Destructor.
+     */
+    virtual ~TaskPool();
+
+  private:
+    /**
+     * @brief		Put task into queue.
+     *
+     * @param[in]	task		Task to put.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief		Take a task and run it.
+     *
+     * @param[in]	group		If not \c nullptr, only the tasks in the
+     *							group are taken.
+     *
+     * @return		If a task has been run, \c true is returned. Otherwise
+     *				returns \c false.
+     */
+    bool runOne(TaskGroup *group);
+
+    /**
+     * @brief		Take a task.
+     *
+     * @param[in]	group		If not \c nullptr, only the tasks in the
+     *							group are taken.
+     * @param[out]	task		Task taken.
+     *
+     * @return		If a task has been taken, \c true is returned. Otherwise
+     *				returns \c false.
+     */
+    bool take(TaskGroup *group, Task &task);
+
+    /**
+     * @brief		Worker thread.
+     *
+     * @param[in]	index		Index of the worker.
+     */
+    void workerThread(int index);
+};
+
+/**
+ * @brief	Group of tasks run in the task pool.
+ */
+class TaskGroup {
+    friend class TaskPool;
+
+  private:
+    QAtomicInt     m_pending;  ///< Count of unfinished tasks.
+    QAtomicInt     m_canceled; ///< Canceled flag.
+    QMutex         m_lock;     ///< Lock.
+    QWaitCondition m_cond;     ///< Condition of finished.
+
+  public:
+    /**
+     * @brief		Constructor.
+     */
+    TaskGroup();
+
+    /**
+     * @brief		Run task in the task pool. If the task pool has not been
+     *				initialized, the task runs immediately in current thread.
+     *
+     * @param[in]	task		Task to run.
+     */
+    void run(::std::function<void()> task);
+
+    /**
+     * @brief		Call \c func for sub ranges of [begin, end) in parallel
+     *				and wait until finished.
+     *
+     * @param[in]	begin		Begin of the range.
+     * @param[in]	end			End of the range.
+     * @param[in]	func		Function to call with the sub range.
+     * @param[in]	grain		Maximum size of the sub ranges.
+     */
+    void parallelFor(int                                    begin,
+                     int                                    end,
+                     const ::std::function<void(int, int)> &func,
+                     int                                    grain = 1);
+
+    /**
+     * @brief		Wait until all tasks finished. Current thread runs the
+     *				queued tasks of the group while waiting.
+     */
+    void wait();
+
+    /**
+     * @brief		Cancel the group. The queued tasks will be dropped, the
+     *				running tasks may check \c canceled() to stop early.
+     */
+    void cancel();
+
+    /**
+     * @brief		Check if the group has been canceled.
+     *
+     * @return		If the group has been canceled, \c true is returned.
+     *				Otherwise returns \c false.
+     */
+    bool canceled() const;
+
+    /**
+     * @brief		Destructor, wait until all tasks finished.
+     */
+    virtual ~TaskGroup();
+
+  private:
+    /**
+     * @brief		Called when a task has been finished.
+     */
+    void finishTask();
+};
@@ -5,7 +5,9 @@
 #include <memory>
 #include <vector>
 
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QString>
+#include <QtCore/QVector>
 #include <QtCore/QXmlStreamReader>
 
 /**
@@ -18,9 +20,27 @@ class XMLLoader {
      */
     class Context;
 
+    /**
+     * @brief		Attributes of element.
+     */
+    class Attributes;
+
+  private:
+    /**
+     * @brief		Hash table of element names.
+     */
+    class NameTable;
+
   protected:
     ::std::vector<::std::unique_ptr<Context>> m_contextStack; ///< Contexts.
+    ::std::vector<::std::unique_ptr<Context>> m_freeContexts; ///< Recycled.
     ::std::map<QString, ::std::any>           m_values;       ///< Values.
+    bool                                      m_skipElement;  ///< Skip element.
+
+    static QReadWriteLock         _nameLock;   ///< Lock of interned names.
+    static NameTable              _names;      ///< Interned names.
+    static thread_local NameTable _localNames; ///< Interned names seen by
+                                               ///< current thread.
 
   public:
     /**
@@ -28,6 +48,14 @@ class XMLLoader {
      */
     XMLLoader();
 
+    /**
+     * @brief		Create context, the contexts popped by the loader are
+     *				reused.
+     *
+     * @return		Context created.
+     */
+    ::std::unique_ptr<Context> createContext();
+
     /**
      * @brief		Push context.
      *
@@ -35,6 +63,15 @@ class XMLLoader {
      */
     void pushContext(::std::unique_ptr<Context> context);
 
+    /**
+     * @brief		Skip current element, it should be called in the start
+     *				element callback instead of pushing a context. The
+     *				reader is fast-forwarded to the matching end tag without
+     *				calling any callbacks, then the stop element callback of
+     *				current context is called.
+     */
+    void skipElement();
+
     /**
      * @brief	Parse XML.
      *
@@ -59,6 +96,44 @@ class XMLLoader {
      * @return		Value.
      */
     ::std::any &operator[](const QString &key);
+
+  public:
+    /**
+     * @brief		Intern element name. The names interned by current
+     *				thread are cached in the thread, so only the first
+     *				occurrence of a name in each thread takes the global
+     *				lock.
+     *
+     * @param[in]	name		Name of element.
+     * @param[out]	id			ID of the name, the IDs are shared by all
+     *							threads.
+     *
+     * @return		Interned name, it shares the data with the table.
+     */
+    static QString internName(const QStringRef &name, int &id);
+
+  private:
+    /**
+     * @brief		Recycle context.
+     *
+     * @param[in]	context		Context to recycle.
+     */
+    void recycleContext(::std::unique_ptr<Context> context);
+
+    /**
+     * @brief		Intern element name in the global table.
+     *
+     * @param[in]	name		Name of element.
+     * @param[in]	hash		Hash of the name.
+     * @param[out]	internedName	Interned name.
+     *
+     * @return		ID of the name.
+     */
+    static int internGlobalName(const QStringRef &name,
+                                uint              hash,
+                                QString &         internedName);
 };
 
+#include <common/xml_loader_attributes.h>
 #include <common/xml_loader_context.h>
+#include <common/xml_loader_name_table.h>
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QXmlStreamAttributes>
+
+#include <common/xml_loader.h>
+
+/**
+ * @brief	Attributes of element. It is a view of the attributes read by
+ *			\c QXmlStreamReader, the values are copied only when they are
+ *			used.
+ */
+class XMLLoader::Attributes {
+  public:
+    /**
+     * @brief	Iterator.
+     */
+    class const_iterator {
+      private:
+        QXmlStreamAttributes::const_iterator m_iter; ///< Iterator.
+
+      public:
+        /**
+         * @brief		Constructor.
+         *
+         * @param[in]	iter		Iterator of attributes.
+         */
+        const_iterator(QXmlStreamAttributes::const_iterator iter);
+
+        /**
+         * @brief		Get name of the attribute.
+         *
+         * @return		Name of the attribute.
+         */
+        QString key() const;
+
+        /**
+         * @brief		Get value of the attribute.
+         *
+         * @return		Value of the attribute.
+         */
+        QString value() const;
+
+        /**
+         * @brief		Get value of the attribute.
+         *
+         * @return		Value of the attribute.
+         */
+        QString operator*() const;
+
+        /**
+         * @brief		Move to next attribute.
+         *
+         * @return		Reference of current iterator.
+         */
+        const_iterator &operator++();
+
+        /**
+         * @brief		Operator ==.
+         *
+         * @param[in]	iter		Iterator to compare.
+         *
+         * @return		Returns \c true if two iterators are equal.
+         */
+        bool operator==(const const_iterator &iter) const;
+
+        /**
+         * @brief		Operator !=.
+         *
+         * @param[in]	iter		Iterator to compare.
+         *
+         * @return		Returns \c true if two iterators are not equal.
+         */
+        bool operator!=(const const_iterator &iter) const;
+    };
+
+  private:
+    QXmlStreamAttributes m_attributes; ///< Attributes.
+
+  public:
+    /**
+     * @brief		Constructor.
+     *
+     * @param[in]	attributes	Attributes read by \c QXmlStreamReader.
+     */
+    Attributes(const QXmlStreamAttributes &attributes);
+
+    /**
+     * @brief		Get count of attributes.
+     *
+     * @return		Count of attributes.
+     */
+    int size() const;
+
+    /**
+     * @brief		Find attribute.
+     *
+     * @param[in]	name		Name of the attribute.
+     *
+     * @return		Iterator of the attribute, \c end() if not found.
+     */
+    const_iterator find(const char *name) const;
+
+    /**
+     * @brief		Find attribute.
+     *
+     * @param[in]	name		Name of the attribute.
+     *
+     * @return		Iterator of the attribute, \c end() if not found.
+     */
+    const_iterator find(const QString &name) const;
+
+    /**
+     * @brief		Check if the attribute exists.
+     *
+     * @param[in]	name		Name of the attribute.
+     *
+     * @return		Returns \c true if the attribute exists.
+     */
+    bool contains(const char *name) const;
+
+    /**
+     * @brief		Check if the attribute exists.
+     *
+     * @param[in]	name		Name of the attribute.
+     *
+     * @return		Returns \c true if the attribute exists.
+     */
+    bool contains(const QString &name) const;
+
+    /**
+     * @brief		Get begin iterator.
+     *
+     * @return		Begin iterator.
+     */
+    const_iterator begin() const;
+
+    /**
+     * @brief		Get end iterator.
+     *
+     * @return		End iterator.
+     */
+    const_iterator end() const;
+
+    /**
+     * @brief		Get value of the attribute.
+     *
+     * @param[in]	name		Name of the attribute.
+     *
+     * @return		Value of the attribute, empty string if not found.
+     */
+    QString operator[](const char *name) const;
+
+    /**
+     * @brief		Get value of the attribute.
+     *
+     * @param[in]	name		Name of the attribute.
+     *
+     * @return		Value of the attribute, empty string if not found.
+     */
+    QString operator[](const QString &name) const;
+};
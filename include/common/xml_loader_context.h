@@ -3,8 +3,8 @@
 #include <functional>
 #include <memory>
 
-#include <QtCore/QMap>
 #include <QtCore/QString>
+#include <QtCore/QVector>
 
 #include <common/xml_loader.h>
 
@@ -14,7 +14,7 @@
 class XMLLoader::Context {
   protected:
     // Stack
-    QVector<QString> m_elementStack; ///< Element stack.
+    QVector<int> m_elementStack; ///< Element stack, IDs of interned names.
 
     // Document
     ::std::function<bool(XMLLoader &, Context &)>
@@ -26,7 +26,7 @@ class XMLLoader::Context {
     ::std::function<bool(XMLLoader &,
                          Context &,
                          const QString &,
-                         const QMap<QString, QString> &)>
+                         const XMLLoader::Attributes &)>
         m_onStartElement; ///< Start element.
     ::std::function<bool(XMLLoader &, Context &, const QString &)>
         m_onStopElement; ///< Stop element.
@@ -51,22 +51,35 @@ class XMLLoader::Context {
      */
     static ::std::unique_ptr<Context> create();
 
+    /**
+     * @brief		Reset context, remove all elements and callbacks.
+     */
+    void reset();
+
     /**
      * @brief		Push element.
      *
-     * @param[in]	name		Name of element.
+     * @param[in]	name		ID of the interned name of element.
      */
-    void pushElement(const QString &name);
+    void pushElement(int name);
 
     /**
      * @brief		Pop element.
      *
-     * @param[in]	name		Name of element.
+     * @param[in]	name		ID of the interned name of element.
      *
      * @return		If the name of element found, \c true is returned,
      *				otherwise returns \c false.
      */
-    bool popElement(const QString &name);
+    bool popElement(int name);
+
+    /**
+     * @brief		Check if any callback has been set.
+     *
+     * @return		Returns \c true if any callback has been set, otherwise
+     *				returns \c false.
+     */
+    bool hasCallbacks() const;
 
     // Document
     /**
@@ -117,7 +130,7 @@ class XMLLoader::Context {
         ::std::function<bool(XMLLoader &,
                              Context &,
                              const QString &,
-                             const QMap<QString, QString> &)> onStartElement);
+                             const XMLLoader::Attributes &)> onStartElement);
 
     /**
      * @brief		On start element callback.
@@ -130,10 +143,10 @@ class XMLLoader::Context {
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElement(XMLLoader &                   loader,
-                        Context &                     context,
-                        const QString &               name,
-                        const QMap<QString, QString> &attr);
+    bool onStartElement(XMLLoader &                  loader,
+                        Context &                    context,
+                        const QString &              name,
+                        const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Set on stop element callback.
@@ -172,12 +185,15 @@ class XMLLoader::Context {
      *
      * @param[in]	loader		XML loader.
      * @param[in]	context		Context.
-     * @param[in]	text		Text.
+     * @param[in]	text		Text, it is copied only if the callback has
+     *							been set.
      *
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onCharacters(XMLLoader &loader, Context &context, const QString &text);
+    bool onCharacters(XMLLoader &       loader,
+                      Context &         context,
+                      const QStringRef &text);
 
     /**
      * @brief		Destructor..
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringRef>
+#include <QtCore/QVector>
+
+#include <common/xml_loader.h>
+
+/**
+ * @brief	Open-addressing hash table of element names, the names can be
+ *			found by \c QStringRef without building a \c QString. It is not
+ *			thread-safe.
+ */
+class XMLLoader::NameTable {
+  private:
+    QVector<QString> m_names;   ///< Names.
+    QVector<uint>    m_hashes;  ///< Hashes of names.
+    QVector<int>     m_ids;     ///< IDs of names.
+    QVector<int>     m_buckets; ///< Hash buckets.
+
+  public:
+    /**
+     * @brief		Constructor.
+     */
+    NameTable();
+
+    /**
+     * @brief		Find name.
+     *
+     * @param[in]	name		Name of element.
+     * @param[in]	hash		Hash of the name.
+     *
+     * @return		On success, index of the name is returned. Otherwise
+     *				returns -1.
+     */
+    int find(const QStringRef &name, uint hash) const;
+
+    /**
+     * @brief		Insert name, the name must not be in the table.
+     *
+     * @param[in]	name		Name of element.
+     * @param[in]	hash		Hash of the name.
+     * @param[in]	id			ID of the name.
+     *
+     * @return		Index of the name.
+     */
+    int insert(const QString &name, uint hash, int id);
+
+    /**
+     * @brief		Get count of names.
+     *
+     * @return		Count of names.
+     */
+    inline int size() const
+    {
+        return m_names.size();
+    }
+
+    /**
+     * @brief		Get name.
+     *
+     * @param[in]	index		Index of the name.
+     *
+     * @return		Name of element.
+     */
+    inline const QString &name(int index) const
+    {
+        return m_names[index];
+    }
+
+    /**
+     * @brief		Get ID of name.
+     *
+     * @param[in]	index		Index of the name.
+     *
+     * @return		ID of the name.
+     */
+    inline int id(int index) const
+    {
+        return m_ids[index];
+    }
+
+  private:
+    /**
+     * @brief		Put index of name into hash buckets.
+     *
+     * @param[in]	index		Index of the name.
+     */
+    void putBucket(int index);
+};
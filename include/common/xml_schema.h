@@ -0,0 +1,304 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+
+#include <QtCore/QDebug>
+#include <QtCore/QLatin1String>
+#include <QtCore/QStringRef>
+#include <QtCore/QXmlStreamReader>
+
+/**
+ * @brief	Compile time parser of schema patterns.
+ *
+ *			A pattern is the path of the element to read, followed by the
+ *			attributes to bind, such as "/index/entry@name,@value".
+ */
+class XMLSchemaPattern {
+  public:
+    /**
+     * @brief		Get count of elements in the path.
+     *
+     * @param[in]	pattern		Pattern.
+     *
+     * @return		Count of elements.
+     */
+    static constexpr size_t depth(::std::string_view pattern)
+    {
+        size_t ret = 0;
+        for (char c : XMLSchemaPattern::path(pattern)) {
+            if (c == '/') {
+                ++ret;
+            }
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief		Get count of attributes.
+     *
+     * @param[in]	pattern		Pattern.
+     *
+     * @return		Count of attributes.
+     */
+    static constexpr size_t attributeCount(::std::string_view pattern)
+    {
+        size_t ret = 0;
+        for (char c : pattern) {
+            if (c == '@') {
+                ++ret;
+            }
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief		Get name of element.
+     *
+     * @param[in]	pattern		Pattern.
+     * @param[in]	index		Index of element.
+     *
+     * @return		Name of element.
+     */
+    static constexpr ::std::string_view element(::std::string_view pattern,
+                                                size_t             index)
+    {
+        return XMLSchemaPattern::field(XMLSchemaPattern::path(pattern), '/',
+                                       index + 1);
+    }
+
+    /**
+     * @brief		Get name of attribute.
+     *
+     * @param[in]	pattern		Pattern.
+     * @param[in]	index		Index of attribute.
+     *
+     * @return		Name of attribute.
+     */
+    static constexpr ::std::string_view attribute(::std::string_view pattern,
+                                                  size_t             index)
+    {
+        ::std::string_view ret = XMLSchemaPattern::field(
+            XMLSchemaPattern::attributes(pattern), ',', index);
+        if (! ret.empty() && ret.front() == '@') {
+            ret.remove_prefix(1);
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief		Check if the pattern is legal.
+     *
+     * @param[in]	pattern		Pattern.
+     *
+     * @return		Returns \c true if the pattern is legal.
+     */
+    static constexpr bool check(::std::string_view pattern)
+    {
+        if (pattern.empty() || pattern.front() != '/') {
+            return false;
+        }
+
+        for (size_t i = 0; i < XMLSchemaPattern::depth(pattern); ++i) {
+            if (XMLSchemaPattern::element(pattern, i).empty()) {
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < XMLSchemaPattern::attributeCount(pattern);
+             ++i) {
+            if (XMLSchemaPattern::attribute(pattern, i).empty()) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+  private:
+    /**
+     * @brief		Get path part of pattern.
+     *
+     * @param[in]	pattern		Pattern.
+     *
+     * @return		Path.
+     */
+    static constexpr ::std::string_view path(::std::string_view pattern)
+    {
+        return pattern.substr(0, pattern.find('@'));
+    }
+
+    /**
+     * @brief		Get attributes part of pattern.
+     *
+     * @param[in]	pattern		Pattern.
+     *
+     * @return		Attributes.
+     */
+    static constexpr ::std::string_view attributes(::std::string_view pattern)
+    {
+        size_t pos = pattern.find('@');
+        if (pos == ::std::string_view::npos) {
+            return ::std::string_view();
+        } else {
+            return pattern.substr(pos);
+        }
+    }
+
+    /**
+     * @brief		Get field in string.
+     *
+     * @param[in]	str			String.
+     * @param[in]	separator	Separator of fields.
+     * @param[in]	index		Index of field.
+     *
+     * @return		Field.
+     */
+    static constexpr ::std::string_view
+        field(::std::string_view str, char separator, size_t index)
+    {
+        for (size_t i = 0; i < index; ++i) {
+            size_t pos = str.find(separator);
+            if (pos == ::std::string_view::npos) {
+                return ::std::string_view();
+            }
+            str.remove_prefix(pos + 1);
+        }
+
+        return str.substr(0, str.find(separator));
+    }
+};
+
+/**
+ * @brief	Schema handler, reads the attributes of the elements matching the
+ *			pattern. The pattern is compiled to a flat state machine, which
+ *			reads \c QXmlStreamReader directly without contexts and
+ *			callbacks of \c XMLLoader.
+ *
+ * @tparam	Pattern		Pattern, such as "/index/entry@name,@value".
+ */
+template<const char *Pattern>
+class XMLSchema {
+  public:
+    static constexpr size_t _depth
+        = XMLSchemaPattern::depth(Pattern); ///< Count of elements.
+    static constexpr size_t _attributeCount
+        = XMLSchemaPattern::attributeCount(Pattern); ///< Count of attributes.
+
+    /**
+     * @brief	Values of attributes, in the order of the pattern. The values
+     *			are valid until the handler returns.
+     */
+    typedef ::std::array<QStringRef, _attributeCount> Values;
+
+    static_assert(XMLSchemaPattern::check(Pattern), "Illegal schema pattern.");
+    static_assert(_depth > 0, "Empty schema path.");
+
+  private:
+    /**
+     * @brief	Names of elements.
+     */
+    struct Elements {
+        ::std::array<QLatin1String, _depth> names; ///< Names.
+
+        /**
+         * @brief	Constructor.
+         */
+        constexpr Elements() : names()
+        {
+            for (size_t i = 0; i < _depth; ++i) {
+                ::std::string_view name = XMLSchemaPattern::element(Pattern, i);
+                names[i] = QLatin1String(name.data(), (int)name.size());
+            }
+        }
+    };
+
+    /**
+     * @brief	Names of attributes.
+     */
+    struct Attributes {
+        ::std::array<QLatin1String, _attributeCount> names; ///< Names.
+
+        /**
+         * @brief	Constructor.
+         */
+        constexpr Attributes() : names()
+        {
+            for (size_t i = 0; i < _attributeCount; ++i) {
+                ::std::string_view name
+                    = XMLSchemaPattern::attribute(Pattern, i);
+                names[i] = QLatin1String(name.data(), (int)name.size());
+            }
+        }
+    };
+
+  public:
+    /**
+     * @brief		Parse XML.
+     *
+     * @param[in]	reader		XML reader.
+     * @param[in]	handler		Handler of matching elements, it is called
+     *							as \c handler(const Values &) when all the
+     *							attributes exist.
+     *
+     * @return		Returns \c true if the whole file has been parsed,
+     *				otherwise returns false.
+     */
+    template<typename Handler>
+    static bool parse(QXmlStreamReader &reader, Handler &&handler)
+    {
+        static constexpr Elements   elements;
+        static constexpr Attributes attributes;
+
+        // Depth of current element and count of matched elements on the
+        // path, an element only matches if all its parents matched.
+        size_t depth   = 0;
+        size_t matched = 0;
+        while (! reader.atEnd()) {
+            switch (reader.readNext()) {
+                case QXmlStreamReader::TokenType::StartElement:
+                    if (matched == depth && depth < _depth
+                        && reader.name() == elements.names[depth]) {
+                        ++matched;
+                        if (matched == _depth) {
+                            QXmlStreamAttributes attrs = reader.attributes();
+                            Values               values;
+                            bool                 found = true;
+                            for (size_t i = 0; i < _attributeCount; ++i) {
+                                values[i] = attrs.value(attributes.names[i]);
+                                if (values[i].isNull()) {
+                                    found = false;
+                                    break;
+                                }
+                            }
+                            if (found) {
+                                handler(values);
+                            }
+                        }
+                    }
+                    ++depth;
+                    break;
+
+                case QXmlStreamReader::TokenType::EndElement:
+                    if (matched == depth) {
+                        --matched;
+                    }
+                    --depth;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if (reader.hasError()) {
+            qWarning() << "Failed to parse XML :" << reader.errorString();
+            return false;
+        }
+
+        return true;
+    }
+};
@@ -3,6 +3,7 @@
 #include <functional>
 #include <memory>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
@@ -27,11 +28,14 @@ class GameComponents :
               ::std::function<void(const QString &)>);
 
   private:
+    static constexpr const char _indexSchema[]
+        = "/index/entry@name,@value"; ///< Schema of index files.
     QMap<QString, QString> m_components; ///< Components
 
   protected:
     /**
-     * @brief		Constructor.
+     * @brief		Constructor, load the components of the base game, the components
+     *				of extensions are loaded by \c applyExtensions().
      *
      * @param[in]	vfs				Virtual filesystem of the game.
      * @param[in]	setTextFunc		Callback to set text.
@@ -39,51 +43,64 @@ class GameComponents :
     GameComponents(::std::shared_ptr<GameVFS>             vfs,
                    ::std::function<void(const QString &)> setTextFunc);
 
+    /**
+     * @brief		Constructor, load components from snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     */
+    GameComponents(QDataStream &stream);
+
   public:
     /**
-     * @brief	Get component.
+     * @brief		Load components from snapshot.
      *
-     * @return	Value of component.
+     * @param[in]	stream			Stream of snapshot.
+     *
+     * @return		On success, a new object is reutnred. Otherwise returns
+     *				nullptr.
      */
-    QString component(const QString &id);
+    static ::std::shared_ptr<GameComponents> loadSnapshot(QDataStream &stream);
 
     /**
-     * @brief		Destructor.
+     * @brief		Save components to snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
      */
-    virtual ~GameComponents();
+    void saveSnapshot(QDataStream &stream);
 
-  protected:
     /**
-     * @brief		Start element callback in root.
+     * @brief		Load the components of extensions, the components of extensions
+     *				override the components loaded before.
+     *
+     * @param[in]	vfs				Virtual filesystem of the game.
      *
-     * @param[in]	loader			XML loader.
-     * @param[in]	context			Context.
-     * @param[in]	name			Name of the element.
-     * @param[in]	attr			Attributes.
+     * @return		Returns \c true if all index files of extensions have been
+     *				parsed, otherwise returns \c false.
+     */
+    bool applyExtensions(::std::shared_ptr<GameVFS> vfs);
+
+    /**
+     * @brief	Get component.
      *
-     * @return		Return \c true if the parsing should be continued.
-     *				otherwise returns \c false.
+     * @return	Value of component.
      */
-    bool onStartElementInRoot(XMLLoader &                   loader,
-                              XMLLoader::Context &          context,
-                              const QString &               name,
-                              const QMap<QString, QString> &attr);
+    QString component(const QString &id);
 
     /**
-     * @brief		Start element callback in index.
+     * @brief		Destructor.
+     */
+    virtual ~GameComponents();
+
+  private:
+    /**
+     * @brief		Parse index file.
      *
-     * @param[in]	loader			XML loader.
-     * @param[in]	context			Context.
-     * @param[in]	name			Name of the element.
-     * @param[in]	attr			Attributes.
+     * @param[in]	data			Content of the file.
      *
-     * @return		Return \c true if the parsing should be continued.
-     *				otherwise returns \c false.
+     * @return		Returns \c true if the whole file has been parsed,
+     *				otherwise returns false.
      */
-    bool onStartElementInIndex(XMLLoader &                   loader,
-                               XMLLoader::Context &          context,
-                               const QString &               name,
-                               const QMap<QString, QString> &attr);
+    bool parseIndex(const QByteArray &data);
 };
 
 #include <game_data/game_vfs.h>
@@ -29,6 +29,34 @@ class GameData : public QObject, public ISingleton<GameData, SplashWidget *> {
   private:
     SIGNLETON_OBJECT(GameData, SplashWidget *)
 
+  private:
+    /**
+     * @brief	Type of snapshot. There are only two layers, changes of any
+     *			extension invalidate the full snapshot and all extensions
+     *			are applied again on the base snapshot.
+     */
+    enum class SnapshotType {
+        Base, ///< Game data of the base game, without extensions.
+        Full  ///< Game data with extensions loaded.
+    };
+
+    /**
+     * @brief	Objects of game data.
+     */
+    struct Objects {
+        ::std::shared_ptr<GameVFS>            vfs;        ///< Game VFS
+        ::std::shared_ptr<GameTexts>          texts;      ///< Game texts.
+        ::std::shared_ptr<GameMacros>         macros;     ///< Game macros.
+        ::std::shared_ptr<GameComponents>     components; ///< Game components.
+        ::std::shared_ptr<GameRaces>          races;      ///< Game races.
+        ::std::shared_ptr<GameWares>          wares;      ///< Game wares
+        ::std::shared_ptr<GameStationModules> stationModules; ///< Modules.
+    };
+
+  private:
+    static const char    _snapshotMagic[8]; ///< Magic of snapshot.
+    static const quint32 _snapshotVersion;  ///< Version of snapshot.
+
   private:
     QString                           m_gamePath;   ///< Game path.
     ::std::shared_ptr<GameVFS>        m_vfs;        ///< Game VFS
@@ -141,6 +169,41 @@ class GameData : public QObject, public ISingleton<GameData, SplashWidget *> {
     bool checkGamePath(const QString &                      path,
                        QMap<QString, GameVFS::CatFileInfo> &catFiles);
 
+    /**
+     * @brief		Get path of snapshot file.
+     *
+     * @param[in]	type			Type of snapshot.
+     *
+     * @return		Path of snapshot file.
+     */
+    QString snapshotPath(SnapshotType type);
+
+    /**
+     * @brief		Load game data from snapshot, the objects are set only
+     *				if the whole snapshot has been loaded. The station
+     *				modules are only loaded from the full snapshot.
+     *
+     * @param[in]	type			Type of snapshot.
+     * @param[in]	objects			Objects of game data, the vfs must have
+     *								been loaded.
+     * @param[in]	setTextFunc		Callback to set text.
+     *
+     * @return		If the snapshot exists and matches the fingerprint of
+     *				the game files, true is returned. Otherwise returns
+     *				false.
+     */
+    bool loadSnapshot(SnapshotType                           type,
+                      Objects &                              objects,
+                      ::std::function<void(const QString &)> setTextFunc);
+
+    /**
+     * @brief		Save game data to snapshot.
+     *
+     * @param[in]	type			Type of snapshot.
+     * @param[in]	objects			Objects of game data.
+     */
+    void saveSnapshot(SnapshotType type, const Objects &objects);
+
     /**
      * @brief		Ask game path.
      *
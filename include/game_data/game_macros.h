@@ -3,6 +3,7 @@
 #include <functional>
 #include <memory>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
@@ -27,11 +28,14 @@ class GameMacros :
               ::std::function<void(const QString &)>);
 
   private:
+    static constexpr const char _indexSchema[]
+        = "/index/entry@name,@value"; ///< Schema of index files.
     QMap<QString, QString> m_macros; ///< Macros
 
   protected:
     /**
-     * @brief		Constructor.
+     * @brief		Constructor, load the macros of the base game, the macros
+     *				of extensions are loaded by \c applyExtensions().
      *
      * @param[in]	vfs				Virtual filesystem of the game.
      * @param[in]	setTextFunc		Callback to set text.
@@ -39,51 +43,64 @@ class GameMacros :
     GameMacros(::std::shared_ptr<GameVFS>             vfs,
                ::std::function<void(const QString &)> setTextFunc);
 
+    /**
+     * @brief		Constructor, load macros from snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     */
+    GameMacros(QDataStream &stream);
+
   public:
     /**
-     * @brief	Get macro.
+     * @brief		Load macros from snapshot.
      *
-     * @return	Value of macro.
+     * @param[in]	stream			Stream of snapshot.
+     *
+     * @return		On success, a new object is reutnred. Otherwise returns
+     *				nullptr.
      */
-    QString macro(const QString &id);
+    static ::std::shared_ptr<GameMacros> loadSnapshot(QDataStream &stream);
 
     /**
-     * @brief		Destructor.
+     * @brief		Save macros to snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
      */
-    virtual ~GameMacros();
+    void saveSnapshot(QDataStream &stream);
 
-  protected:
     /**
-     * @brief		Start element callback in root.
+     * @brief		Load the macros of extensions, the macros of extensions
+     *				override the macros loaded before.
+     *
+     * @param[in]	vfs				Virtual filesystem of the game.
      *
-     * @param[in]	loader			XML loader.
-     * @param[in]	context			Context.
-     * @param[in]	name			Name of the element.
-     * @param[in]	attr			Attributes.
+     * @return		Returns \c true if all index files of extensions have been
+     *				parsed, otherwise returns \c false.
+     */
+    bool applyExtensions(::std::shared_ptr<GameVFS> vfs);
+
+    /**
+     * @brief	Get macro.
      *
-     * @return		Return \c true if the parsing should be continued.
-     *				otherwise returns \c false.
+     * @return	Value of macro.
      */
-    bool onStartElementInRoot(XMLLoader &                   loader,
-                              XMLLoader::Context &          context,
-                              const QString &               name,
-                              const QMap<QString, QString> &attr);
+    QString macro(const QString &id);
 
     /**
-     * @brief		Start element callback in index.
+     * @brief		Destructor.
+     */
+    virtual ~GameMacros();
+
+  private:
+    /**
+     * @brief		Parse index file.
      *
-     * @param[in]	loader			XML loader.
-     * @param[in]	context			Context.
-     * @param[in]	name			Name of the element.
-     * @param[in]	attr			Attributes.
+     * @param[in]	data			Content of the file.
      *
-     * @return		Return \c true if the parsing should be continued.
-     *				otherwise returns \c false.
+     * @return		Returns \c true if the whole file has been parsed,
+     *				otherwise returns false.
      */
-    bool onStartElementInIndex(XMLLoader &                   loader,
-                               XMLLoader::Context &          context,
-                               const QString &               name,
-                               const QMap<QString, QString> &attr);
+    bool parseIndex(const QByteArray &data);
 };
 
 #include <game_data/game_vfs.h>
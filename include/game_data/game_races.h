@@ -3,6 +3,7 @@
 #include <functional>
 #include <memory>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
@@ -56,7 +57,31 @@ class GameRaces :
               ::std::shared_ptr<GameTexts>           texts,
               ::std::function<void(const QString &)> setTextFunc);
 
+    /**
+     * @brief		Constructor, load races from snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     */
+    GameRaces(QDataStream &stream);
+
   public:
+    /**
+     * @brief		Load races from snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     *
+     * @return		On success, a new object is reutnred. Otherwise returns
+     *				nullptr.
+     */
+    static ::std::shared_ptr<GameRaces> loadSnapshot(QDataStream &stream);
+
+    /**
+     * @brief		Save races to snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     */
+    void saveSnapshot(QDataStream &stream);
+
     /**
      * @brief	Get race information.
      *
@@ -88,10 +113,10 @@ class GameRaces :
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInRoot(XMLLoader &                   loader,
-                              XMLLoader::Context &          context,
-                              const QString &               name,
-                              const QMap<QString, QString> &attr);
+    bool onStartElementInRoot(XMLLoader &                  loader,
+                              XMLLoader::Context &         context,
+                              const QString &              name,
+                              const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in races.
@@ -104,10 +129,10 @@ class GameRaces :
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInRaces(XMLLoader &                   loader,
-                               XMLLoader::Context &          context,
-                               const QString &               name,
-                               const QMap<QString, QString> &attr);
+    bool onStartElementInRaces(XMLLoader &                  loader,
+                               XMLLoader::Context &         context,
+                               const QString &              name,
+                               const XMLLoader::Attributes &attr);
 };
 
 #include <game_data/game_vfs.h>
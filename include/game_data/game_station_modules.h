@@ -1,8 +1,10 @@
 #pragma once
 
+#include <array>
 #include <functional>
 #include <memory>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QMap>
 #include <QtCore/QMetaEnum>
 #include <QtCore/QMetaObject>
@@ -10,6 +12,7 @@
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QSet>
+#include <QtCore/QStringList>
 #include <QtCore/QVector>
 #include <QtCore/QXmlStreamReader>
 
@@ -120,8 +123,11 @@ class GameStationModules :
         QSet<QString>      races;           ///< Module race.
         quint32            hull;            ///< Hull.
         quint32            explosiondamage; ///< Explosion damage.
+        int                ordinal;         ///< Ordinal in module table.
         QMap<Property::Type, ::std::shared_ptr<Property>>
-            properties; ///< Properties.
+            properties; ///< Properties with non-numeric data, the
+                        ///< numeric-only properties are moved to the
+                        ///< module table after loading.
     };
 
     /**
@@ -434,12 +440,143 @@ class GameStationModules :
         enum { S, M, L, XL, L_XL } type; ///< Type.
     };
 
+    /**
+     * @brief	Numeric columns of module table.
+     */
+    enum class Column : size_t {
+        Hull,             ///< Hull.
+        ExplosionDamage,  ///< Explosion damage.
+        MTurret,          ///< Count of M turret.
+        MShield,          ///< Count of M shield.
+        LTurret,          ///< Count of L turret.
+        LShield,          ///< Count of L shield.
+        SDock,            ///< Count of S docking bay.
+        SShipCargo,       ///< S ship capacity.
+        MDock,            ///< Count of M docking bay.
+        MShipCargo,       ///< M ship capacity.
+        LDock,            ///< Count of L docking bay.
+        XLDock,           ///< Count of XL docking bay.
+        LXLDock,          ///< Count of L/XL docking bay.
+        SLaunchTube,      ///< Count of S launch tube.
+        MLaunchTube,      ///< Count of M launch tube.
+        SupplyWorkforce,  ///< Workforce supplied.
+        RequireWorkforce, ///< Workforce required.
+        ContainerCargo,   ///< Container cargo size.
+        SolidCargo,       ///< Solid cargo size.
+        LiquidCargo,      ///< Liquid cargo size.
+        Count             ///< Count of columns.
+    };
+
+    /**
+     * @brief	Values of all columns.
+     */
+    typedef ::std::array<quint64, (size_t)Column::Count> ColumnValues;
+
+    /**
+     * @brief	Types of storage.
+     */
+    enum class Storage : size_t {
+        Container, ///< Container.
+        Solid,     ///< Solid.
+        Liquid,    ///< Liquid.
+        Count      ///< Count of storage types.
+    };
+
+    /**
+     * @brief	Rate of ware of one module.
+     */
+    struct WareRate {
+        int         ware; ///< Ordinal of ware.
+        long double min;  ///< Minimum amount per hour.
+        long double max;  ///< Maximum amount per hour.
+    };
+
+    /**
+     * @brief	Contribution of one module to the station, which is built
+     *			when loading and never changed. The numeric properties are
+     *			in the columns of module table.
+     */
+    struct Contribution {
+        QVector<WareRate> products;            ///< Products.
+        QVector<WareRate> resources;           ///< Resources.
+        quint32           storageRequirements; ///< Storage requirements, bit
+                                               ///< n is set if storage type n
+                                               ///< is required.
+    };
+
+    /**
+     * @brief	Struct-of-arrays table of station modules. Each column is a
+     *			dense array indexed by the ordinal of module, the properties
+     *			a module does not have are 0 in the columns.
+     *
+     *			The table is the only storage of the numeric-only
+     *			properties. The workforce supplied and the cargo size are
+     *			also kept in \c SupplyWorkforce and \c HasCargo, because
+     *			the supply information and the cargo type are read together
+     *			with them.
+     */
+    struct ModuleTable {
+        QVector<quint32> masks; ///< Property masks, bit n is set if the
+                                ///< module has the property of type n.
+        ::std::array<QVector<quint64>, (size_t)Column::Count>
+            columns; ///< Columns.
+        QVector<Contribution>
+            contributions; ///< Contributions of modules.
+
+        /**
+         * @brief		Get count of modules.
+         *
+         * @return		Count of modules.
+         */
+        inline int size() const
+        {
+            return masks.size();
+        }
+
+        /**
+         * @brief		Check if the module has the property.
+         *
+         * @param[in]	ordinal		Ordinal of the module.
+         * @param[in]	type		Type of the property.
+         *
+         * @return		Returns \c true if the module has the property,
+         *				otherwise returns \c false.
+         */
+        inline bool hasProperty(int ordinal, Property::Type type) const
+        {
+            return (masks[ordinal] & ((quint32)1 << type)) != 0;
+        }
+
+        /**
+         * @brief		Get value in column.
+         *
+         * @param[in]	ordinal		Ordinal of the module.
+         * @param[in]	column		Column.
+         *
+         * @return		Value.
+         */
+        inline quint64 value(int ordinal, Column column) const
+        {
+            return columns[(size_t)column][ordinal];
+        }
+
+        /**
+         * @brief		Sum all columns weighted by amounts of modules.
+         *
+         * @param[in]	amounts		Amounts of modules, indexed by ordinal.
+         * @param[out]	totals		Sums of columns.
+         */
+        void sum(const QVector<quint64> &amounts, ColumnValues &totals) const;
+    };
+
   private:
     QVector<::std::shared_ptr<StationModule>> m_modules; ///< Station modules.
+    ModuleTable                               m_table;   ///< Module table.
     QMap<QString, ::std::shared_ptr<StationModule>>
         m_modulesIndex; ///< Station modules index.
     QMap<QString, QVector<::std::shared_ptr<StationModule>>>
-        m_componentTmpIndex; ///< Temporart component index.
+                m_componentTmpIndex;  ///< Temporart component index.
+    QStringList m_moduleMacroTmpList; ///< Temporart module macro list.
     static QMap<QString, StationModule::StationModuleClass>
         _classMap; ///< Station module class map.
 
@@ -461,7 +598,40 @@ class GameStationModules :
                        ::std::shared_ptr<GameComponents>      components,
                        ::std::function<void(const QString &)> setTextFunc);
 
+    /**
+     * @brief		Constructor, load station modules from snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     * @param[in]	texts			Game texts.
+     * @param[in]	wares			Game wares.
+     */
+    GameStationModules(QDataStream &                stream,
+                       ::std::shared_ptr<GameTexts> texts,
+                       ::std::shared_ptr<GameWares> wares);
+
   public:
+    /**
+     * @brief		Load station modules from snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     * @param[in]	texts			Game texts.
+     * @param[in]	wares			Game wares.
+     *
+     * @return		On success, a new object is reutnred. Otherwise returns
+     *				nullptr.
+     */
+    static ::std::shared_ptr<GameStationModules>
+        loadSnapshot(QDataStream &                stream,
+                     ::std::shared_ptr<GameTexts> texts,
+                     ::std::shared_ptr<GameWares> wares);
+
+    /**
+     * @brief		Save station modules to snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     */
+    void saveSnapshot(QDataStream &stream);
+
     /**
      * @brief		Get modules.
      *
@@ -476,6 +646,13 @@ class GameStationModules :
      */
     ::std::shared_ptr<StationModule> module(const QString &macro);
 
+    /**
+     * @brief		Get module table.
+     *
+     * @return		Module table.
+     */
+    const ModuleTable &table() const;
+
     /**
      * @brief		Destructor.
      */
@@ -496,7 +673,7 @@ class GameStationModules :
     bool onStartElementInRootOfModuleGroups(XMLLoader &         loader,
                                             XMLLoader::Context &context,
                                             const QString &     name,
-                                            const QMap<QString, QString> &attr);
+                                            const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in groups.
@@ -510,10 +687,10 @@ class GameStationModules :
      *				otherwise returns \c false.
      */
     bool onStartElementInGroupsOfModuleGroups(
-        XMLLoader &                   loader,
-        XMLLoader::Context &          context,
-        const QString &               name,
-        const QMap<QString, QString> &attr);
+        XMLLoader &                  loader,
+        XMLLoader::Context &         context,
+        const QString &              name,
+        const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in group.
@@ -530,24 +707,114 @@ class GameStationModules :
         onStartElementInGroupOfModuleGroups(XMLLoader &         loader,
                                             XMLLoader::Context &context,
                                             const QString &     name,
-                                            const QMap<QString, QString> &attr);
+                                            const XMLLoader::Attributes &attr);
 
     /**
-     * @brief		Load macro.
+     * @brief		Load macro, may be called in any thread.
      *
      * @param[in]	macro		Macro to load.
+     * @param[out]	modules		Modules loaded.
+     * @param[out]	unknowWares	IDs of the wares referenced but not found,
+     *							the placeholders of them are generated when
+     *							the modules are merged.
      * @param[in]	vfs			Virtual filesystem of the game.
      * @param[in]	macros		Game macros.
      * @param[in]	texts		Game texts.
      * @param[in]	wares		Game wares.
      * @param[in]	components	Game components.
      */
-    void loadMacro(const QString &                   macro,
-                   ::std::shared_ptr<GameVFS>        vfs,
-                   ::std::shared_ptr<GameMacros>     macros,
-                   ::std::shared_ptr<GameTexts>      texts,
-                   ::std::shared_ptr<GameWares>      wares,
-                   ::std::shared_ptr<GameComponents> components);
+    void loadMacro(const QString &                            macro,
+                   QVector<::std::shared_ptr<StationModule>> &modules,
+                   QStringList &                              unknowWares,
+                   ::std::shared_ptr<GameVFS>                 vfs,
+                   ::std::shared_ptr<GameMacros>              macros,
+                   ::std::shared_ptr<GameTexts>               texts,
+                   ::std::shared_ptr<GameWares>               wares,
+                   ::std::shared_ptr<GameComponents>          components);
+
+    /**
+     * @brief		Find ware when loading macro, the ID of unknow ware is
+     *				recorded instead of generating the placeholder, so the
+     *				placeholders do not depend on the order of threads.
+     *
+     * @param[in]	loader		XML loader of the macro.
+     * @param[in]	id			Ware ID.
+     *
+     * @return		Information of ware if found, otherwise returns nullptr.
+     */
+    ::std::shared_ptr<GameWares::Ware> findWare(XMLLoader &    loader,
+                                                const QString &id);
+
+    /**
+     * @brief		Merge loaded module.
+     *
+     * @param[in]	module		Module to merge.
+     * @param[in]	texts		Game texts.
+     */
+    void mergeModule(::std::shared_ptr<StationModule> module,
+                     ::std::shared_ptr<GameTexts>     texts);
+
+    /**
+     * @brief		Build module table from loaded modules.
+     *
+     * @param[in]	texts		Game texts.
+     * @param[in]	wares		Game wares.
+     */
+    void buildTable(::std::shared_ptr<GameTexts> texts,
+                    ::std::shared_ptr<GameWares> wares);
+
+    /**
+     * @brief		Get the column of a numeric-only property. The values of
+     *				these properties are only stored in the module table.
+     *
+     * @param[in]	type		Type of the property.
+     * @param[out]	column		Column of the property.
+     *
+     * @return		Returns \c true if the property is numeric-only,
+     *				otherwise returns \c false.
+     */
+    static bool tableColumn(Property::Type type, Column &column);
+
+    /**
+     * @brief		Build contribution of module.
+     *
+     * @param[in]	module		Module.
+     * @param[in]	texts		Game texts.
+     * @param[in]	wares		Game wares.
+     *
+     * @return		Contribution.
+     */
+    static Contribution
+        buildContribution(const StationModule &        module,
+                          ::std::shared_ptr<GameTexts> texts,
+                          ::std::shared_ptr<GameWares> wares);
+
+    /**
+     * @brief		Write property to snapshot.
+     *
+     * @param[in]	stream		Stream of snapshot.
+     * @param[in]	property	Property.
+     */
+    static void writeProperty(QDataStream &stream, const Property &property);
+
+    /**
+     * @brief		Read property from snapshot.
+     *
+     * @param[in]	stream		Stream of snapshot.
+     *
+     * @return		On success, the property is returned. Otherwise returns
+     *				nullptr.
+     */
+    static ::std::shared_ptr<Property> readProperty(QDataStream &stream);
+
+    /**
+     * @brief		Print module information.
+     *
+     * @param[in]	module		Module to print.
+     * @param[in]	texts		Game texts.
+     */
+    void printModule(::std::shared_ptr<StationModule> module,
+                     ::std::shared_ptr<GameTexts>     texts);
 
     /**
      * @brief		Start element callback in module macro.
@@ -563,7 +830,7 @@ class GameStationModules :
     bool onStartElementInRootOfModuleMacro(XMLLoader &         loader,
                                            XMLLoader::Context &context,
                                            const QString &     name,
-                                           const QMap<QString, QString> &attr);
+                                           const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in module macro.
@@ -580,7 +847,7 @@ class GameStationModules :
         onStartElementInMacrosOfModuleMacro(XMLLoader &         loader,
                                             XMLLoader::Context &context,
                                             const QString &     name,
-                                            const QMap<QString, QString> &attr);
+                                            const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in module macro.
@@ -598,7 +865,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -617,7 +884,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -636,7 +903,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -655,7 +922,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -674,7 +941,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -693,7 +960,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -712,7 +979,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -750,7 +1017,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -769,7 +1036,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -788,7 +1055,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -808,7 +1075,7 @@ class GameStationModules :
         XMLLoader &                          loader,
         XMLLoader::Context &                 context,
         const QString &                      name,
-        const QMap<QString, QString> &       attr,
+        const XMLLoader::Attributes &        attr,
         ::std::shared_ptr<StationModule>     module,
         ::std::shared_ptr<TmpDockingBayInfo> info);
 
@@ -817,6 +1084,7 @@ class GameStationModules :
      *
      * @param[in]	component	Component to load.
      * @param[in]	module		Station module.
+     * @param[out]	unknowWares	IDs of the wares referenced but not found.
      * @param[in]	vfs			Virtual filesystem of the game.
      * @param[in]	macros		Game macros.
      * @param[in]	texts		Game texts.
@@ -825,6 +1093,7 @@ class GameStationModules :
      */
     void loadComponent(const QString &                   component,
                        ::std::shared_ptr<StationModule>  module,
+                       QStringList &                     unknowWares,
                        ::std::shared_ptr<GameVFS>        vfs,
                        ::std::shared_ptr<GameMacros>     macros,
                        ::std::shared_ptr<GameTexts>      texts,
@@ -847,7 +1116,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -866,7 +1135,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -885,7 +1154,7 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 
     /**
@@ -904,6 +1173,6 @@ class GameStationModules :
         XMLLoader &                      loader,
         XMLLoader::Context &             context,
         const QString &                  name,
-        const QMap<QString, QString> &   attr,
+        const XMLLoader::Attributes &    attr,
         ::std::shared_ptr<StationModule> module);
 };
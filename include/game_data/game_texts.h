@@ -1,12 +1,17 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <functional>
 #include <memory>
 
+#include <QtCore/QDataStream>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSet>
 #include <QtCore/QVector>
 #include <QtCore/QXmlStreamReader>
 
@@ -60,48 +65,74 @@ class GameTexts :
         }
     };
 
+    /**
+     * @brief	Statistics of resolved text cache.
+     */
+    struct CacheStatistics {
+        quint64 hits;    ///< Count of cache hits.
+        quint64 misses;  ///< Count of cache misses.
+        quint64 cycles;  ///< Count of reference cycles found.
+        qint64  savedNs; ///< Time saved by the cache, in nanoseconds.
+    };
+
   private:
     /**
      * @brief	Text link.
      */
     struct TextLink {
-        bool    isRef; ///< True if the link is a reference.
-        QString text;  ///< String of the link if it is not a reference link.
-        struct {
-            qint32 pageID; ///< ID of referenced page.
-            qint32 textID; ///< ID of referenced text.
-        } refInfo;         /*< Information of referenced string if the link is
-                            *  a reference.
-                            */
+        bool   isRef;  ///< True if the link is a reference.
+        qint32 first;  ///< Offset in string pool, or ID of referenced page.
+        qint32 second; ///< Length of the string, or ID of referenced text.
     };
 
     /**
-     * @brief	Text link.
+     * @brief	Texts of a language. The texts are appended while loading,
+     *			and then compacted to arrays sorted by key.
      */
-    struct Text {
-        qint32                           pageID; ///< ID of page.
-        qint32                           textID; ///< ID of text.
-        QMutex                           lock;   ///< Lock.
-        QMap<quint32, QVector<TextLink>> links;  ///< Links.
+    struct TextStore {
+        QVector<quint64>  keys;   ///< Keys of texts, see \c textKey().
+        QVector<quint32>  orders; ///< Load orders, empty after compacted.
+        QVector<quint32>  ranges; ///< Index of first link, ends with count.
+        QVector<TextLink> links;  ///< Links.
+        QString           pool;   ///< String pool of non-reference links.
     };
 
     /**
-     * @brief	Text page.
+     * @brief	Resolved text.
      */
-    struct TextPage {
-        qint32                                pageID; ///< ID of page.
-        QMap<qint32, ::std::shared_ptr<Text>> texts;  ///< Texts.
-        QMutex                                lock;   ///< Lock.
+    struct ResolvedText {
+        QString text; ///< Text.
+        qint64  cost; ///< Time used to resolve the text, in nanoseconds.
     };
 
   private:
-    QMap<qint32, ::std::shared_ptr<TextPage>> m_textPages; ///< Text pages.
-    QMutex                                    m_pageLock;  ///< Test page lock.
-    QAtomicInt                                m_unknowIndex; ///< Unknow index.
+    QMap<quint32, TextStore> m_languages;    ///< Texts of each language.
+    TextStore                m_addedTexts;   ///< Texts added by addText().
+    QReadWriteLock           m_languageLock; ///< Lock of texts.
+    QAtomicInt               m_unknowIndex;  ///< Unknow index.
+
+    QMap<quint32, QHash<quint64, ResolvedText>>
+                   m_resolved;           ///< Resolved texts of each language.
+    quint64        m_resolvedGeneration; ///< Generation of resolved texts.
+    QReadWriteLock m_resolvedLock;       ///< Lock of resolved texts.
+
+    ::std::atomic<quint64> m_cacheHits;       ///< Count of cache hits.
+    ::std::atomic<quint64> m_cacheMisses;     ///< Count of cache misses.
+    ::std::atomic<quint64> m_referenceCycles; ///< Count of reference cycles.
+    ::std::atomic<qint64>  m_cacheSavedNs;    ///< Time saved by the cache.
+
+    ::std::shared_ptr<GameVFS> m_vfs;                ///< Virtual filesystem.
+    QMap<quint32, QStringList> m_languageFiles;      ///< Files of languages.
+    QMap<quint32, QStringList>
+        m_extensionLanguageFiles; ///< Files of languages in extensions.
+    QSet<quint32>              m_loadedLanguages;    ///< Loaded languages.
+    QMetaObject::Connection    m_languageConnection; ///< Language changed.
+    TaskGroup                  m_loadingTasks;       ///< Loading tasks.
 
   protected:
     /**
-     * @brief		Constructor.
+     * @brief		Constructor, load the texts of the base game, the texts
+     *				of extensions are loaded by \c applyExtensions().
      *
      * @param[in]	vfs				Virtual filesystem of the game.
      * @param[in]	setTextFunc		Callback to set text.
@@ -109,7 +140,54 @@ class GameTexts :
     GameTexts(::std::shared_ptr<GameVFS>             vfs,
               ::std::function<void(const QString &)> setTextFunc);
 
+    /**
+     * @brief		Constructor, load texts from snapshot.
+     *
+     * @param[in]	vfs				Virtual filesystem of the game.
+     * @param[in]	stream			Stream of snapshot.
+     * @param[in]	setTextFunc		Callback to set text.
+     */
+    GameTexts(::std::shared_ptr<GameVFS>             vfs,
+              QDataStream &                          stream,
+              ::std::function<void(const QString &)> setTextFunc);
+
   public:
+    /**
+     * @brief		Load texts from snapshot, the languages not in the
+     *				snapshot are loaded from the game files.
+     *
+     * @param[in]	vfs				Virtual filesystem of the game.
+     * @param[in]	stream			Stream of snapshot.
+     * @param[in]	setTextFunc		Callback to set text.
+     *
+     * @return		On success, a new object is reutnred. Otherwise returns
+     *				nullptr.
+     */
+    static ::std::shared_ptr<GameTexts>
+        loadSnapshot(::std::shared_ptr<GameVFS>             vfs,
+                     QDataStream &                          stream,
+                     ::std::function<void(const QString &)> setTextFunc);
+
+    /**
+     * @brief		Save texts to snapshot, only the languages which have
+     *				been loaded are saved.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     */
+    void saveSnapshot(QDataStream &stream);
+
+    /**
+     * @brief		Load the texts of extensions in the languages loaded,
+     *				the texts of extensions override the texts loaded
+     *				before.
+     *
+     * @param[in]	setTextFunc		Callback to set text.
+     *
+     * @return		Returns \c true if all text files of extensions have been
+     *				loaded, otherwise returns \c false.
+     */
+    bool applyExtensions(::std::function<void(const QString &)> setTextFunc);
+
     /**
      * @brief		Get text.
      *
@@ -138,12 +216,151 @@ class GameTexts :
      */
     IDPair addText(const QString &str);
 
+    /**
+     * @brief		Get statistics of resolved text cache.
+     *
+     * @return		Statistics.
+     */
+    CacheStatistics cacheStatistics() const;
+
     /**
      * @brief		Destructor.
      */
     virtual ~GameTexts();
 
   private:
+    /**
+     * @brief		Load the languages used at startup if they have not been
+     *				loaded, and watch the changes of language.
+     *
+     * @param[in]	setTextFunc		Callback to set text.
+     */
+    void loadStartupLanguages(
+        ::std::function<void(const QString &)> setTextFunc);
+
+    /**
+     * @brief		Get text files of language.
+     *
+     * @param[in]	languageID		Language ID.
+     *
+     * @return		Files of the base game, followed by the files of
+     *				extensions.
+     */
+    QStringList languageFiles(quint32 languageID) const;
+
+    /**
+     * @brief		Load text files.
+     *
+     * @param[in]	files			Files to load, the texts in the files
+     *								loaded later overwrite the texts loaded
+     *								before.
+     * @param[in]	onFileLoaded	Called with count of loaded files when a
+     *								file has been loaded, may be \c nullptr.
+     * @param[out]	failedFiles		Files failed to open or parse.
+     *
+     * @return		Texts of each language.
+     */
+    QMap<quint32, TextStore>
+        loadFiles(const QStringList &             files,
+                  ::std::function<void(quint64)> onFileLoaded,
+                  QStringList &                   failedFiles);
+
+    /**
+     * @brief		Called when the language changes, loads the texts of
+     *				the language in background if it has not been loaded.
+     */
+    void onLanguageChanged();
+
+    /**
+     * @brief		Get key of text.
+     *
+     * @param[in]	pageID		Page ID of the text.
+     * @param[in]	textID		ID of the text.
+     *
+     * @return		Key of the text.
+     */
+    static inline quint64 textKey(qint32 pageID, qint32 textID)
+    {
+        return (static_cast<quint64>(static_cast<quint32>(pageID)) << 32)
+               | static_cast<quint32>(textID);
+    }
+
+    /**
+     * @brief		Print statistics of resolved text cache.
+     */
+    void printCacheStatistics() const;
+
+    /**
+     * @brief		Get text from resolved text cache, the text is resolved
+     *				if not cached.
+     *
+     * @param[in]	pageID		Page ID of the text.
+     * @param[in]	textID		ID of the text.
+     * @param[in]	languageID	Language ID.
+     * @param[in]	resolving	Keys of the texts being resolved, used to
+     *							find reference cycles.
+     *
+     * @return		Text.
+     */
+    QString cachedText(qint32            pageID,
+                       qint32            textID,
+                       quint32           languageID,
+                       QVector<quint64> &resolving);
+
+    /**
+     * @brief		Resolve text.
+     *
+     * @param[in]	pageID		Page ID of the text.
+     * @param[in]	textID		ID of the text.
+     * @param[in]	languageID	Language ID.
+     * @param[in]	resolving	Keys of the texts being resolved.
+     *
+     * @return		Text.
+     */
+    QString resolveText(qint32            pageID,
+                        qint32            textID,
+                        quint32           languageID,
+                        QVector<quint64> &resolving);
+
+    /**
+     * @brief		Find text in compacted texts.
+     *
+     * @param[in]	store		Texts.
+     * @param[in]	key			Key of the text.
+     *
+     * @return		Index of the text, or -1 if not found.
+     */
+    static int findText(const TextStore &store, quint64 key);
+
+    /**
+     * @brief		Merge and compact texts, the text loaded last is kept if
+     *				there are texts with the same key.
+     *
+     * @param[in]	stores		Texts to merge.
+     *
+     * @return		Texts compacted.
+     */
+    static TextStore compactTexts(const QVector<const TextStore *> &stores);
+
+    /**
+     * @brief		Write compacted texts to snapshot.
+     *
+     * @param[in]	stream		Stream of snapshot.
+     * @param[in]	store		Texts.
+     */
+    static void writeTextStore(QDataStream &stream, const TextStore &store);
+
+    /**
+     * @brief		Read compacted texts from snapshot.
+     *
+     * @param[in]	stream		Stream of snapshot.
+     * @param[out]	store		Texts.
+     *
+     * @return		Returns \c true if the texts are legal, otherwise returns
+     *				\c false.
+     */
+    static bool readTextStore(QDataStream &stream, TextStore &store);
+
     /**
      * @brief		Start element callback in root.
      *
@@ -155,10 +372,10 @@ class GameTexts :
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInRoot(XMLLoader &                   loader,
-                              XMLLoader::Context &          context,
-                              const QString &               name,
-                              const QMap<QString, QString> &attr);
+    bool onStartElementInRoot(XMLLoader &                  loader,
+                              XMLLoader::Context &         context,
+                              const QString &              name,
+                              const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in language.
@@ -167,16 +384,16 @@ class GameTexts :
      * @param[in]	context		Context.
      * @param[in]	name		Name of the element.
      * @param[in]	attr		Attributes.
-     * @param[in]	languageID	Language ID of the text.
+     * @param[in]	store		Texts of the language.
      *
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInLanguage(XMLLoader &                   loader,
-                                  XMLLoader::Context &          context,
-                                  const QString &               name,
-                                  const QMap<QString, QString> &attr,
-                                  quint32                       languageID);
+    bool onStartElementInLanguage(XMLLoader &                  loader,
+                                  XMLLoader::Context &         context,
+                                  const QString &              name,
+                                  const XMLLoader::Attributes &attr,
+                                  TextStore *                  store);
 
     /**
      * @brief		Start element callback in page.
@@ -185,18 +402,18 @@ class GameTexts :
      * @param[in]	context		Context.
      * @param[in]	name		Name of the element.
      * @param[in]	attr		Attributes.
-     * @param[in]	languageID	Language ID of the text.
-     * @param[in]	page		Page of the text.
+     * @param[in]	store		Texts of the language.
+     * @param[in]	pageID		Page ID of the text.
      *
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInPage(XMLLoader &                   loader,
-                              XMLLoader::Context &          context,
-                              const QString &               name,
-                              const QMap<QString, QString> &attr,
-                              quint32                       languageID,
-                              ::std::shared_ptr<TextPage>   page);
+    bool onStartElementInPage(XMLLoader &                  loader,
+                              XMLLoader::Context &         context,
+                              const QString &              name,
+                              const XMLLoader::Attributes &attr,
+                              TextStore *                  store,
+                              qint32                       pageID);
 
     /**
      * @brief		Characters callback.
@@ -204,30 +421,78 @@ class GameTexts :
      * @param[in]	loader		XML loader.
      * @param[in]	context		Context.
      * @param[in]	s			Text.
-     * @param[in]	languageID	Language ID of the text.
-     * @param[in]	text		Text object.
+     * @param[in]	store		Texts of the language.
+     * @param[in]	key			Key of the text.
      *
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onTextCharacters(XMLLoader &             loader,
-                          XMLLoader::Context &    context,
-                          const QString &         s,
-                          quint32                 languageID,
-                          ::std::shared_ptr<Text> text);
+    bool onTextCharacters(XMLLoader &         loader,
+                          XMLLoader::Context &context,
+                          const QString &     s,
+                          TextStore *         store,
+                          quint64             key);
+    /**
+     * @brief		Parse text and append it to texts.
+     *
+     * @param[in]	s			Text.
+     * @param[in]	key			Key of the text.
+     * @param[in]	store		Texts to append to.
+     */
+    void parseText(const QString &s, quint64 key, TextStore &store);
+
     /**
-     * @brief		Parse text.
+     * @brief		Match reference like "{page,text}".
      *
-     * @return		Parsed text.
+     * @param[in]	s			String.
+     * @param[in]	index		Index of '{'.
+     * @param[out]	pageID		Page ID of referenced text.
+     * @param[out]	textID		ID of referenced text.
+     * @param[out]	end			Index after '}'.
+     *
+     * @return		Returns \c true if a reference matched, otherwise
+     *				returns \c false.
      */
-    QVector<TextLink> parseText(QString s);
+    static bool matchReference(const QString &s,
+                               int            index,
+                               qint32 &       pageID,
+                               qint32 &       textID,
+                               int &          end);
 
     /**
      * @brief		Parse excape characters.
      *
-     * @return		Parsed text.
+     * @param[in]	s			String to parse.
+     * @param[out]	ret			Parsed text is appended to it.
      */
-    QString parseEscape(const QString &s);
+    void parseEscape(const QStringRef &s, QString &ret);
 };
 
+/**
+ * @brief		Write game text id pair.
+ *
+ * @param[in]	stream		Stream.
+ * @param[in]	idPair		ID pair.
+ *
+ * @return		Stream.
+ */
+inline QDataStream &operator<<(QDataStream &            stream,
+                               const GameTexts::IDPair &idPair)
+{
+    return stream << idPair.pageID << idPair.textID;
+}
+
+/**
+ * @brief		Read game text id pair.
+ *
+ * @param[in]	stream		Stream.
+ * @param[out]	idPair		ID pair.
+ *
+ * @return		Stream.
+ */
+inline QDataStream &operator>>(QDataStream &stream, GameTexts::IDPair &idPair)
+{
+    return stream >> idPair.pageID >> idPair.textID;
+}
+
 #include <game_data/game_vfs.h>
@@ -3,13 +3,18 @@
 #include <functional>
 #include <memory>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
+#include <QtCore/QQueue>
 #include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
 
+#include <common/multi_threading/simple_thread.h>
 #include <interfaces/i_initialized.h>
 
 /**
@@ -26,6 +31,15 @@ class GameVFS : private IInitialized {
         QString dat; ///< Name of dat file.
     };
 
+    /**
+     * @brief	Policy to verify packed files.
+     */
+    enum class VerifyPolicy {
+        Now,        ///< Verify when the file is opened at the first time.
+        Background, ///< Verify in a low-priority background thread.
+        Cache       ///< Trust hashes verified in previous launches.
+    };
+
     /**
      * @brief	File reader.
      */
@@ -59,19 +73,19 @@ class GameVFS : private IInitialized {
   protected:
     struct DatFileEntery;
     /**
-     * @brief	Dat file entery
+     * @brief	Dat file entery, only used while scanning cat files. The tree
+     *			is compacted into \c CompactNode and \c PackedFile after
+     *			loaded.
      */
     struct DatFileEntery {
         QString name;        ///< Name.
         bool    isDirectory; ///< Directory flag.
         QMap<QString, ::std::shared_ptr<DatFileEntery>> children; ///< Children.
-        QMutex                                          lock;     ///< Lock.
         struct _tmp1 {
             QString datName; ///< Name of dat file.
             quint64 offset;  ///< Offset.
             quint64 size;    ///< Size.
             QString hash;    ///< File hash.
-            bool    checked; ///< File checked flag.
         } fileInfo;          ///< File infomation;
 
         /**
@@ -87,7 +101,7 @@ class GameVFS : private IInitialized {
          */
         DatFileEntery(const QString &name) :
             name(name), isDirectory(true), children({}),
-            fileInfo({"", 0, 0, QString(), false})
+            fileInfo({"", 0, 0, QString()})
         {}
 
         /**
@@ -106,17 +120,152 @@ class GameVFS : private IInitialized {
                       const QString &hash) :
             name(name),
             isDirectory(false), children({}),
-            fileInfo({datName, offset, size, hash, false})
+            fileInfo({datName, offset, size, hash})
         {}
 
         DatFileEntery(const DatFileEntery &) = delete;
         DatFileEntery(DatFileEntery &&)      = delete;
     };
 
+    /**
+     * @brief	Node of compacted tree. Children of a directory are stored
+     *			continuously in the node array, in the order of names.
+     */
+    struct CompactNode {
+        quint32 name;     ///< Offset of the name in name pool.
+        quint32 nameSize; ///< Size of the name.
+        quint32 index;    ///< Index of first child for directories, index
+                          ///< of packed file for files.
+        quint32 count;    ///< Number of children, \c _fileNode for files.
+
+        /**
+         * @brief		Check if the node is a directory.
+         *
+         * @return		If the node is a directory, true is returned.
+         *				Otherwise returns false.
+         */
+        inline bool isDirectory() const
+        {
+            return count != _fileNode;
+        }
+    };
+
+    /**
+     * @brief	Entry of path index, the node is keyed by the index of its
+     *			parent and its name, the name is read from the name pool.
+     */
+    struct PathIndexEntry {
+        quint32 parent; ///< Index of parent node.
+        quint32 node;   ///< Index of node, \c _invalidIndex if empty.
+    };
+
+    /**
+     * @brief	Packed file.
+     */
+    struct PackedFile {
+        quint32 node;     ///< Index of node.
+        quint32 dat;      ///< Index of dat file name.
+        quint64 offset;   ///< Offset.
+        quint64 size;     ///< Size.
+        char    hash[16]; ///< MD5 of the file.
+    };
+
+    /**
+     * @brief	Verify state of packed file.
+     */
+    enum class FileState : quint8 {
+        Unchecked, ///< Not checked.
+        Checked,   ///< Checked or being checked in background.
+        Broken     ///< Broken.
+    };
+
+    /**
+     * @brief	Dat file mapped into memory.
+     */
+    struct MappedDatFile {
+        ::std::unique_ptr<QFile> file; ///< File object.
+        uchar *                  data; ///< Mapped data.
+        qint64                   size; ///< Size of the file.
+
+        /**
+         * @brief		Constructor.
+         *
+         * @param[in]	file	File object.
+         * @param[in]	data	Mapped data.
+         * @param[in]	size	Size of the file.
+         */
+        MappedDatFile(::std::unique_ptr<QFile> file, uchar *data, qint64 size) :
+            file(::std::move(file)), data(data), size(size)
+        {}
+
+        MappedDatFile(const MappedDatFile &) = delete;
+        MappedDatFile(MappedDatFile &&)      = delete;
+
+        /**
+         * @brief		Destructor.
+         */
+        ~MappedDatFile()
+        {
+            if (data != nullptr) {
+                file->unmap(data);
+            }
+        }
+    };
+
+    /**
+     * @brief	Stamp of a cat/dat file pair, used as the key of index cache.
+     */
+    struct CatFileStamp {
+        QString cat;         ///< Name of cat file.
+        qint64  catSize;     ///< Size of cat file.
+        qint64  catModified; ///< Modify time of cat file.
+        QString dat;         ///< Name of dat file.
+        qint64  datSize;     ///< Size of dat file.
+        qint64  datModified; ///< Modify time of dat file.
+    };
+
+  private:
+    static const char    _indexCacheMagic[8]; ///< Magic of index cache.
+    static const quint32 _indexCacheVersion;  ///< Version of index cache.
+    static const quint32 _fileNode;           ///< Child count of file nodes.
+    static const quint32 _invalidIndex;       ///< Invalid index of node.
+    static const char    _hashCacheMagic[8];  ///< Magic of hash cache.
+    static const quint32 _hashCacheVersion;   ///< Version of hash cache.
+
   private:
-    QString                          m_gamePath; ///< Game path.
-    ::std::shared_ptr<DatFileEntery> m_datEntry; ///< Enteries.
-    ::std::weak_ptr<GameVFS>         m_this;     ///< This reference.
+    QString                          m_gamePath;    ///< Game path.
+    ::std::shared_ptr<DatFileEntery> m_datEntry;    ///< Enteries when loading.
+    QVector<CompactNode>             m_nodes;       ///< Nodes, root is first.
+    QVector<PackedFile>              m_packedFiles; ///< Packed files.
+    QVector<FileState>               m_fileStates;  ///< Verify states.
+    QMutex                           m_fileStatesLock; ///< Lock of states.
+    QString                          m_namePool;    ///< Names of nodes.
+    QStringList                      m_datNames;    ///< Names of dat files.
+    ::std::weak_ptr<GameVFS>         m_this;        ///< This reference.
+    bool                             m_mapDatFiles; ///< Map dat files.
+    QMap<QString, ::std::shared_ptr<MappedDatFile>>
+           m_mappedDatFiles;     ///< Mapped dat files, keyed by path.
+    QMutex m_mappedDatFilesLock; ///< Lock of mapped dat files.
+    QVector<PathIndexEntry>
+        m_pathIndex; ///< Open addressing table of nodes keyed by parent and
+                     ///< name.
+    QVector<PathIndexEntry>
+        m_foldedPathIndex; ///< Open addressing table of nodes keyed by
+                           ///< parent and case-folded name, the first one
+                           ///< in order is used if names differ only in
+                           ///< case.
+    VerifyPolicy                    m_verifyPolicy;   ///< Verify policy.
+    QMap<QString, qint64>           m_datModified;    ///< Dat modify time.
+    QByteArray                      m_fingerprint;    ///< Fingerprint.
+    QByteArray                      m_baseFingerprint; ///< Base fingerprint.
+    QHash<QString, QString>         m_hashCache;      ///< Verified hashes.
+    bool                            m_hashCacheDirty; ///< Cache modified.
+    QMutex                          m_hashCacheLock;  ///< Lock of cache.
+    ::std::unique_ptr<SimpleThread> m_verifyThread;   ///< Verify thread.
+    QQueue<quint32>                 m_verifyQueue;    ///< Files to verify.
+    QMutex         m_verifyQueueLock;  ///< Lock of verify queue.
+    QWaitCondition m_verifyQueueCond;  ///< Condition of verify queue.
+    bool           m_verifyThreadStop; ///< Stop flag of verify thread.
 
   private:
     /**
@@ -170,6 +319,28 @@ class GameVFS : private IInitialized {
      */
     ::std::shared_ptr<DirReader> openDir(const QString &path);
 
+    /**
+     * @brief		Save hashes verified into hash cache if the policy is
+     *				\c VerifyPolicy::Cache.
+     */
+    void saveHashCache();
+
+    /**
+     * @brief		Get fingerprint of the cat/dat files, it changes when
+     *				any cat/dat file is added, removed or modified.
+     *
+     * @return		Fingerprint.
+     */
+    const QByteArray &fingerprint() const;
+
+    /**
+     * @brief		Get fingerprint of the cat/dat files of the base game,
+     *				the files of extensions are not included.
+     *
+     * @return		Fingerprint.
+     */
+    const QByteArray &baseFingerprint() const;
+
     /**
      * @brief	Destructor.
      */
@@ -184,6 +355,249 @@ class GameVFS : private IInitialized {
      * @return		Splitted data.
      */
     QStringList splitCatLine(const QString &line);
+
+    /**
+     * @brief		Build path index.
+     */
+    void buildPathIndex();
+
+    /**
+     * @brief		Look up node in path index. The path is walked in place
+     *				without allocation, leading, trailing and duplicated
+     *				separators are ignored. Each name in the path is matched
+     *				exactly first, then case-insensitively.
+     *
+     * @param[in]	path	Path.
+     *
+     * @return		On success, index of the node is returned. Otherwise
+     *				returns \c _invalidIndex.
+     */
+    quint32 findNode(const QString &path);
+
+    /**
+     * @brief		Hash of the key of path index.
+     *
+     * @param[in]	parent	Index of parent node.
+     * @param[in]	name	Name.
+     * @param[in]	size	Size of name.
+     * @param[in]	folded	Hash the case-folded name.
+     *
+     * @return		Hash.
+     */
+    static uint pathIndexHash(quint32      parent,
+                              const QChar *name,
+                              int          size,
+                              bool         folded);
+
+    /**
+     * @brief		Compare the name of node.
+     *
+     * @param[in]	node	Index of node.
+     * @param[in]	name	Name.
+     * @param[in]	size	Size of name.
+     * @param[in]	folded	Compare case-folded names.
+     *
+     * @return		If the names are equal, true is returned. Otherwise
+     *				returns false.
+     */
+    bool nodeNameEquals(quint32      node,
+                        const QChar *name,
+                        int          size,
+                        bool         folded) const;
+
+    /**
+     * @brief		Insert node into path index, nothing is inserted if the
+     *				key exists.
+     *
+     * @param[in]	index	Path index.
+     * @param[in]	parent	Index of parent node.
+     * @param[in]	node	Index of node.
+     * @param[in]	folded	Key by the case-folded name.
+     */
+    void insertPathIndex(QVector<PathIndexEntry> &index,
+                         quint32                  parent,
+                         quint32                  node,
+                         bool                     folded);
+
+    /**
+     * @brief		Find child node in path index.
+     *
+     * @param[in]	index	Path index.
+     * @param[in]	parent	Index of parent node.
+     * @param[in]	name	Name of child.
+     * @param[in]	size	Size of name.
+     * @param[in]	folded	Match the case-folded name.
+     *
+     * @return		On success, index of the node is returned. Otherwise
+     *				returns \c _invalidIndex.
+     */
+    quint32 findPathIndex(const QVector<PathIndexEntry> &index,
+                          quint32                        parent,
+                          const QChar *                  name,
+                          int                            size,
+                          bool                           folded) const;
+
+    /**
+     * @brief		Get name of node.
+     *
+     * @param[in]	node	Index of node.
+     *
+     * @return		Name of node.
+     */
+    QString nodeName(quint32 node) const;
+
+    /**
+     * @brief		Compact the tree of \c m_datEntry into node arrays and
+     *				release the tree.
+     */
+    void compactEntries();
+
+    /**
+     * @brief		Get memory used by compacted enteries.
+     *
+     * @return		Size in bytes.
+     */
+    quint64 compactSize() const;
+
+    /**
+     * @brief		Map dat file into memory. Each dat file is mapped only once
+     *				and shared by all readers.
+     *
+     * @param[in]	datName		Path of dat file.
+     *
+     * @return		On success, the mapped file is returned. Otherwise returns
+     *				nullptr.
+     */
+    ::std::shared_ptr<MappedDatFile> mapDatFile(const QString &datName);
+
+    /**
+     * @brief		Check hash of packed file.
+     *
+     * @param[in]	file		Packed file.
+     * @param[in]	data		Data of the file.
+     *
+     * @return		If the hash matches, true is returned. Otherwise returns
+     *				false.
+     */
+    bool checkHash(const PackedFile &file, const char *data);
+
+    /**
+     * @brief		Read the data of packed file and check hash.
+     *
+     * @param[in]	file		Packed file.
+     *
+     * @return		If the hash matches, true is returned. Otherwise returns
+     *				false.
+     */
+    bool checkFile(const PackedFile &file);
+
+    /**
+     * @brief		Verify packed file according to verify policy.
+     *
+     * @param[in]	file		Index of packed file.
+     *
+     * @return		If the file is not broken, true is returned. Otherwise
+     *				returns false.
+     */
+    bool verifyFile(quint32 file);
+
+    /**
+     * @brief		Get key of hash cache.
+     *
+     * @param[in]	file		Packed file.
+     *
+     * @return		Key of hash cache.
+     */
+    QString hashCacheKey(const PackedFile &file);
+
+    /**
+     * @brief		Get path of hash cache file.
+     *
+     * @return		Path of hash cache file.
+     */
+    QString hashCachePath();
+
+    /**
+     * @brief		Load hash cache.
+     */
+    void loadHashCache();
+
+    /**
+     * @brief		Background verify thread.
+     */
+    void verifyThread();
+
+    /**
+     * @brief		Scan cat file.
+     *
+     * @param[in]	dir				Game directory.
+     * @param[in]	catDatInfo		Cat file info.
+     * @param[in]	root			Root entery to append files to.
+     * @param[in]	progressFunc	Callback to report progress.
+     * @param[out]	err				Error message.
+     *
+     * @return		On success, true is returned. Otherwise returns false.
+     */
+    bool scanCatFile(const QDir &                            dir,
+                     const CatFileInfo &                     catDatInfo,
+                     ::std::shared_ptr<DatFileEntery>        root,
+                     ::std::function<void(quint64, quint64)> progressFunc,
+                     QString &                               err);
+
+    /**
+     * @brief		Merge enteries, enteries in \c src override enteries in
+     *				\c dest.
+     *
+     * @param[in]	dest	Destination.
+     * @param[in]	src		Source.
+     *
+     * @return		On success, true is returned. Otherwise returns false.
+     */
+    bool mergeEntry(::std::shared_ptr<DatFileEntery> dest,
+                    ::std::shared_ptr<DatFileEntery> src);
+
+    /**
+     * @brief		Get stamps of cat/dat files.
+     *
+     * @param[in]	dir		Game directory.
+     * @param[in]	info	Cat files info.
+     *
+     * @return		Stamps of the files.
+     */
+    QVector<CatFileStamp>
+        catFileStamps(const QDir &dir, const QMap<QString, CatFileInfo> &info);
+
+    /**
+     * @brief		Get path of index cache file.
+     *
+     * @return		Path of index cache file.
+     */
+    QString indexCachePath();
+
+    /**
+     * @brief		Load enteries from index cache.
+     *
+     * @param[in]	stamps		Stamps of cat/dat files.
+     *
+     * @return		If the cache exists and matches the stamps, true is
+     *				returned. Otherwise returns false.
+     */
+    bool loadIndexCache(const QVector<CatFileStamp> &stamps);
+
+    /**
+     * @brief		Save enteries to index cache.
+     *
+     * @param[in]	stamps		Stamps of cat/dat files.
+     */
+    void saveIndexCache(const QVector<CatFileStamp> &stamps);
+
+    /**
+     * @brief		Check if compacted enteries are legal.
+     *
+     * @return		If the enteries are legal, true is returned. Otherwise
+     *				returns false.
+     */
+    bool checkCompactEntries() const;
 };
 
 /**
@@ -191,11 +605,6 @@ class GameVFS : private IInitialized {
  *
  */
 class GameVFS::FileReader {
-  protected:
-    QStringList                m_path; ///< Path of the file.
-    QString                    m_name; ///< Name of the file.
-    ::std::shared_ptr<GameVFS> m_vfs;  ///< VFS.
-
   public:
     /**
      * @brief	Whence.
@@ -206,6 +615,28 @@ class GameVFS::FileReader {
         End     = 0x03  ///< From the end of the file.
     };
 
+    /**
+     * @brief	Iterator of lines.
+     */
+    class LineIterator;
+
+    /**
+     * @brief	Range of lines.
+     */
+    class Lines;
+
+  private:
+    static const int _readAheadSize; ///< Size of read-ahead buffer.
+
+  protected:
+    QStringList                m_path; ///< Path of the file.
+    QString                    m_name; ///< Name of the file.
+    ::std::shared_ptr<GameVFS> m_vfs;  ///< VFS.
+
+  private:
+    QByteArray m_readBuffer;    ///< Read-ahead buffer.
+    int        m_readBufferPos; ///< Position in read-ahead buffer.
+
   public:
     /**
      * @brief		Constructor.
@@ -237,7 +668,7 @@ class GameVFS::FileReader {
      *
      * @return		Size read.
      */
-    virtual qint64 read(void *buffer, quint64 size) = 0;
+    qint64 read(void *buffer, quint64 size);
 
     /**
      * @brief		Read file.
@@ -246,14 +677,14 @@ class GameVFS::FileReader {
      *
      * @return		Data read.
      */
-    virtual QByteArray read(quint64 size) = 0;
+    QByteArray read(quint64 size);
 
     /**
      * @brief		Read all data after corrent position in the file.
      *
      * @return		Data read.
      */
-    virtual QByteArray readAll() = 0;
+    QByteArray readAll();
 
     /**
      * @brief		Read a line.
@@ -262,13 +693,44 @@ class GameVFS::FileReader {
      */
     QByteArray readLine();
 
+    /**
+     * @brief		Read next line without copying.
+     *
+     * @param[out]	line		View of the line, including the line break.
+     *							It keeps valid until next operation of the
+     *							reader.
+     *
+     * @return		If a line is read, true is returned. Otherwise returns
+     *				false.
+     */
+    bool nextLine(QByteArray &line);
+
+    /**
+     * @brief		Get lines after current position.
+     *
+     * @return		Range of lines.
+     */
+    Lines lines();
+
+    /**
+     * @brief		Get a read-only view of the data after current position
+     *				without copying it.
+     *
+     * @param[out]	size		Size of the data.
+     *
+     * @return		If the file is mapped into memory, a pointer to the data
+     *				is returned, which keeps valid while the VFS exists.
+     *				Otherwise returns nullptr.
+     */
+    const char *view(quint64 &size);
+
     /**
      * @brief		Check if current position is at the end of current file.
      *
      * @return		If current position reachs the end of the file, true is
      *				returned. Otherwise returns false.
      */
-    virtual bool atEnd() = 0;
+    bool atEnd();
 
     /**
      * @brief		Seek file.
@@ -278,12 +740,135 @@ class GameVFS::FileReader {
      *
      * @return		Current position.
      */
-    virtual qint64 seek(qint64 offset, Whence whence = Whence::Current) = 0;
+    qint64 seek(qint64 offset, Whence whence = Whence::Current);
 
     /**
      * @brief	Destructor.
      */
     virtual ~FileReader();
+
+  protected:
+    /**
+     * @brief		Read file.
+     *
+     * @param[out]	buffer		Buffer to restore data read.
+     * @param[in]	size		Size of buffer.
+     *
+     * @return		Size read.
+     */
+    virtual qint64 readData(void *buffer, quint64 size) = 0;
+
+    /**
+     * @brief		Read file.
+     *
+     * @param[in]	size		Size to read.
+     *
+     * @return		Data read.
+     */
+    virtual QByteArray readData(quint64 size) = 0;
+
+    /**
+     * @brief		Read all data after corrent position in the file.
+     *
+     * @return		Data read.
+     */
+    virtual QByteArray readAllData() = 0;
+
+    /**
+     * @brief		Get a read-only view of the data after current position.
+     *
+     * @param[out]	size		Size of the data.
+     *
+     * @return		If the file is mapped into memory, a pointer to the data
+     *				is returned. Otherwise returns nullptr.
+     */
+    virtual const char *viewData(quint64 &size);
+
+    /**
+     * @brief		Check if current position is at the end of current file.
+     *
+     * @return		If current position reachs the end of the file, true is
+     *				returned. Otherwise returns false.
+     */
+    virtual bool atEndData() = 0;
+
+    /**
+     * @brief		Seek file.
+     *
+     * @param[in]	offset		Offset to seek.
+     * @param[in]	whence		Where to begin.
+     *
+     * @return		Current position.
+     */
+    virtual qint64 seekData(qint64 offset, Whence whence) = 0;
+
+  private:
+    /**
+     * @brief		Give the data in read-ahead buffer back to the file.
+     */
+    void flushReadBuffer();
+};
+
+/**
+ * @brief	Iterator of lines.
+ */
+class GameVFS::FileReader::LineIterator {
+  private:
+    FileReader *m_reader; ///< Reader, nullptr if reachs the end.
+    QByteArray  m_line;   ///< Current line.
+
+  public:
+    /**
+     * @brief		Constructor.
+     *
+     * @param[in]	reader		Reader, nullptr for the end iterator.
+     */
+    LineIterator(FileReader *reader);
+
+    /**
+     * @defgroup	Operators.
+     * @{
+     */
+    const QByteArray &operator*() const;
+    const QByteArray *operator->() const;
+
+    LineIterator &operator++();
+
+    bool operator==(const LineIterator &iter) const;
+    bool operator!=(const LineIterator &iter) const;
+    /**
+     * @}
+     */
+};
+
+/**
+ * @brief	Range of lines.
+ */
+class GameVFS::FileReader::Lines {
+  private:
+    FileReader *m_reader; ///< Reader.
+
+  public:
+    /**
+     * @brief		Constructor.
+     *
+     * @param[in]	reader		Reader.
+     */
+    Lines(FileReader *reader);
+
+    /**
+     * @brief		Get iterator point to the first line.
+     *
+     * @return		Iterator.
+     */
+    LineIterator begin();
+
+    /**
+     * @brief		Get iterator point to the end.
+     *
+     * @return		Iterator.
+     */
+    LineIterator end();
 };
 
 /**
@@ -291,9 +876,11 @@ class GameVFS::FileReader {
  */
 class GameVFS::PackedFileReader : public GameVFS::FileReader {
   protected:
-    ::std::unique_ptr<QFile> m_file;   ///< File object.
-    quint64                  m_offset; ///< Offset.
-    quint64                  m_size;   ///< File size.
+    ::std::unique_ptr<QFile>         m_file;       ///< File object.
+    ::std::shared_ptr<MappedDatFile> m_mappedFile; ///< Mapped dat file.
+    quint64                          m_offset;     ///< Offset.
+    quint64                          m_size;       ///< File size.
+    quint64                          m_pos; ///< Position in mapped file.
 
   public:
     /**
@@ -311,6 +898,27 @@ class GameVFS::PackedFileReader : public GameVFS::FileReader {
                      quint64                    size,
                      ::std::shared_ptr<GameVFS> vfs);
 
+    /**
+     * @brief		Constructor, read data from mapped dat file.
+     *
+     * @param[in]	path		Path of file.
+     * @param[in]	mappedFile	Mapped dat file.
+     * @param[in]	offset		Begin offset.
+     * @param[in]	size		File size.
+     * @param[in]	vfs			VFS.
+     */
+    PackedFileReader(const QString &                  path,
+                     ::std::shared_ptr<MappedDatFile> mappedFile,
+                     quint64                          offset,
+                     quint64                          size,
+                     ::std::shared_ptr<GameVFS>       vfs);
+
+    /**
+     * @brief	Destructor.
+     */
+    virtual ~PackedFileReader();
+
+  protected:
     /**
      * @brief		Read file.
      *
@@ -319,7 +927,7 @@ class GameVFS::PackedFileReader : public GameVFS::FileReader {
      *
      * @return		Size read.
      */
-    virtual qint64 read(void *buffer, quint64 size) override;
+    virtual qint64 readData(void *buffer, quint64 size) override;
 
     /**
      * @brief		Read file.
@@ -328,14 +936,26 @@ class GameVFS::PackedFileReader : public GameVFS::FileReader {
      *
      * @return		Data read.
      */
-    virtual QByteArray read(quint64 size) override;
+    virtual QByteArray readData(quint64 size) override;
 
     /**
-     * @brief		Read all data after corrent position in the file.
+     * @brief		Read all data after corrent position in the file. If the
+     *				dat file is mapped, the data returned refers to the
+     *				mapped memory without copying.
      *
      * @return		Data read.
      */
-    virtual QByteArray readAll() override;
+    virtual QByteArray readAllData() override;
+
+    /**
+     * @brief		Get a read-only view of the data after current position.
+     *
+     * @param[out]	size		Size of the data.
+     *
+     * @return		If the file is mapped into memory, a pointer to the data
+     *				is returned. Otherwise returns nullptr.
+     */
+    virtual const char *viewData(quint64 &size) override;
 
     /**
      * @brief		Seek file.
@@ -345,8 +965,7 @@ class GameVFS::PackedFileReader : public GameVFS::FileReader {
      *
      * @return		Current position.
      */
-    virtual qint64 seek(qint64 offset,
-                        Whence whence = Whence::Current) override;
+    virtual qint64 seekData(qint64 offset, Whence whence) override;
 
     /**
      * @brief		Check if current position is at the end of current file.
@@ -354,12 +973,7 @@ class GameVFS::PackedFileReader : public GameVFS::FileReader {
      * @return		If current position reachs the end of the file, true is
      *				returned. Otherwise returns false.
      */
-    virtual bool atEnd() override;
-
-    /**
-     * @brief	Destructor.
-     */
-    virtual ~PackedFileReader();
+    virtual bool atEndData() override;
 };
 
 /**
@@ -381,6 +995,12 @@ class GameVFS::NormalFileReader : public GameVFS::FileReader {
                      ::std::unique_ptr<QFile>   file,
                      ::std::shared_ptr<GameVFS> vfs);
 
+    /**
+     * @brief	Destructor.
+     */
+    virtual ~NormalFileReader();
+
+  protected:
     /**
      * @brief		Read file.
      *
@@ -389,7 +1009,7 @@ class GameVFS::NormalFileReader : public GameVFS::FileReader {
      *
      * @return		Size read.
      */
-    virtual qint64 read(void *buffer, quint64 size) override;
+    virtual qint64 readData(void *buffer, quint64 size) override;
 
     /**
      * @brief		Read file.
@@ -398,14 +1018,14 @@ class GameVFS::NormalFileReader : public GameVFS::FileReader {
      *
      * @return		Data read.
      */
-    virtual QByteArray read(quint64 size) override;
+    virtual QByteArray readData(quint64 size) override;
 
     /**
      * @brief		Read all data after corrent position in the file.
      *
      * @return		Data read.
      */
-    virtual QByteArray readAll() override;
+    virtual QByteArray readAllData() override;
 
     /**
      * @brief		Seek file.
@@ -415,8 +1035,7 @@ class GameVFS::NormalFileReader : public GameVFS::FileReader {
      *
      * @return		Current position.
      */
-    virtual qint64 seek(qint64 offset,
-                        Whence whence = Whence::Current) override;
+    virtual qint64 seekData(qint64 offset, Whence whence) override;
 
     /**
      * @brief		Check if current position is at the end of current file.
@@ -424,12 +1043,7 @@ class GameVFS::NormalFileReader : public GameVFS::FileReader {
      * @return		If current position reachs the end of the file, true is
      *				returned. Otherwise returns false.
      */
-    virtual bool atEnd() override;
-
-    /**
-     * @brief	Destructor.
-     */
-    virtual ~NormalFileReader();
+    virtual bool atEndData() override;
 };
 
 /**
@@ -471,13 +1085,13 @@ class GameVFS::DirReader {
      * @brief		Constructor.
      *
      * @param[in]	path		Path of directory.
-     * @param[in]	entry		Dat file entery. If not found, set it to
-     *							nullptr.
+     * @param[in]	node		Index of node. If not found, set it to
+     *							\c _invalidIndex.
      * @param[in]	vfs			VFS.
      */
-    DirReader(const QString &                  path,
-              ::std::shared_ptr<DatFileEntery> entry,
-              ::std::shared_ptr<GameVFS>       vfs);
+    DirReader(const QString &            path,
+              quint32                    node,
+              ::std::shared_ptr<GameVFS> vfs);
 
     /**
      * @brief	Get name of the directory.
@@ -4,10 +4,12 @@
 #include <functional>
 #include <memory>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QMap>
 #include <QtCore/QMetaEnum>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QVector>
 #include <QtCore/QXmlStreamReader>
 
@@ -98,12 +100,16 @@ class GameWares :
   private:
     QMap<QString, ::std::shared_ptr<WareGroup>> m_wareGroups; ///< Ware groups.
     QMap<QString, ::std::shared_ptr<Ware>>      m_wares;      ///< Wares.
-    QAtomicInt m_unknowWareIndex;      ///< Unknow ware index.
-    QAtomicInt m_unknowWareGroupIndex; ///< Unknow ware group index.
+    QVector<QString>   m_wareIDs;              ///< Ware IDs by ordinal.
+    QMap<QString, int> m_wareOrdinals;         ///< Ordinals of wares.
+    QReadWriteLock     m_lock;                 ///< Lock of wares and groups.
+    QAtomicInt         m_unknowWareIndex;      ///< Unknow ware index.
+    QAtomicInt         m_unknowWareGroupIndex; ///< Unknow ware group index.
 
   protected:
     /**
-     * @brief		Constructor.
+     * @brief		Constructor, load the wares of the base game, the diffs
+     *				in extensions are applied by \c applyExtensions().
      *
      * @param[in]	vfs				Virtual filesystem of the game.
      * @param[in]	texts			Game texts.
@@ -113,7 +119,63 @@ class GameWares :
               ::std::shared_ptr<GameTexts>           texts,
               ::std::function<void(const QString &)> setTextFunc);
 
+    /**
+     * @brief		Constructor, load wares from snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     */
+    GameWares(QDataStream &stream);
+
   public:
+    /**
+     * @brief		Load wares from snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     *
+     * @return		On success, a new object is reutnred. Otherwise returns
+     *				nullptr.
+     */
+    static ::std::shared_ptr<GameWares> loadSnapshot(QDataStream &stream);
+
+    /**
+     * @brief		Save wares to snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     */
+    void saveSnapshot(QDataStream &stream);
+
+    /**
+     * @brief		Apply the diffs of wares in extensions.
+     *
+     * @param[in]	vfs				Virtual filesystem of the game.
+     * @param[in]	texts			Game texts.
+     *
+     * @return		Returns \c true if all ware files of extensions have been
+     *				parsed, otherwise returns \c false.
+     */
+    bool applyExtensions(::std::shared_ptr<GameVFS>   vfs,
+                         ::std::shared_ptr<GameTexts> texts);
+
+    /**
+     * @brief		Write production information to snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     * @param[in]	info			Production information.
+     */
+    static void writeProductionInfo(QDataStream &         stream,
+                                    const ProductionInfo &info);
+
+    /**
+     * @brief		Read production information from snapshot.
+     *
+     * @param[in]	stream			Stream of snapshot.
+     *
+     * @return		On success, the production information is returned.
+     *				Otherwise returns nullptr.
+     */
+    static ::std::shared_ptr<ProductionInfo>
+        readProductionInfo(QDataStream &stream);
+
     /**
      * @brief	Get ware group information.
      *
@@ -137,12 +199,55 @@ class GameWares :
     ::std::shared_ptr<Ware> ware(const QString &              id,
                                  ::std::shared_ptr<GameTexts> texts = nullptr);
 
+    /**
+     * @brief	Find ware information, unknow ware will not be generated.
+     *
+     * @param[in]   id              Ware ID.
+     *
+     * @return	Information of ware if found, otherwise returns nullptr.
+     */
+    ::std::shared_ptr<Ware> findWare(const QString &id);
+
+    /**
+     * @brief	Get ordinal of ware. The ordinals are dense integers assigned
+     *			when the wares are loaded, an unknow ware gets a new ordinal.
+     *
+     * @param[in]   id              Ware ID.
+     * @param[in]	texts			Game texts.
+     *
+     * @return	Ordinal of ware.
+     */
+    int wareOrdinal(const QString &              id,
+                    ::std::shared_ptr<GameTexts> texts = nullptr);
+
+    /**
+     * @brief	Get ware ID by ordinal.
+     *
+     * @param[in]   ordinal         Ordinal of ware.
+     *
+     * @return	Ware ID.
+     */
+    QString wareID(int ordinal);
+
+    /**
+     * @brief	Get count of ware ordinals.
+     *
+     * @return	Count of ware ordinals.
+     */
+    int wareCount();
+
     /**
      * @brief		Destructor.
      */
     virtual ~GameWares();
 
   private:
+    /**
+     * @brief		Assign ordinals to the wares which have not been interned,
+     *				\c m_lock must be locked for writing.
+     */
+    void internWares();
+
     /**
      * @brief		Start element callback in root of group file.
      *
@@ -154,10 +259,10 @@ class GameWares :
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInGroupRoot(XMLLoader &                   loader,
-                                   XMLLoader::Context &          context,
-                                   const QString &               name,
-                                   const QMap<QString, QString> &attr);
+    bool onStartElementInGroupRoot(XMLLoader &                  loader,
+                                   XMLLoader::Context &         context,
+                                   const QString &              name,
+                                   const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in groups.
@@ -170,10 +275,10 @@ class GameWares :
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInGroups(XMLLoader &                   loader,
-                                XMLLoader::Context &          context,
-                                const QString &               name,
-                                const QMap<QString, QString> &attr);
+    bool onStartElementInGroups(XMLLoader &                  loader,
+                                XMLLoader::Context &         context,
+                                const QString &              name,
+                                const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in the root node of wares.
@@ -186,10 +291,10 @@ class GameWares :
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInWaresRoot(XMLLoader &                   loader,
-                                   XMLLoader::Context &          context,
-                                   const QString &               name,
-                                   const QMap<QString, QString> &attr);
+    bool onStartElementInWaresRoot(XMLLoader &                  loader,
+                                   XMLLoader::Context &         context,
+                                   const QString &              name,
+                                   const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in wares.
@@ -202,10 +307,10 @@ class GameWares :
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInWares(XMLLoader &                   loader,
-                               XMLLoader::Context &          context,
-                               const QString &               name,
-                               const QMap<QString, QString> &attr);
+    bool onStartElementInWares(XMLLoader &                  loader,
+                               XMLLoader::Context &         context,
+                               const QString &              name,
+                               const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in ware.
@@ -219,11 +324,11 @@ class GameWares :
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInWare(XMLLoader &                   loader,
-                              XMLLoader::Context &          context,
-                              const QString &               name,
-                              const QMap<QString, QString> &attr,
-                              ::std::shared_ptr<Ware>       ware);
+    bool onStartElementInWare(XMLLoader &                  loader,
+                              XMLLoader::Context &         context,
+                              const QString &              name,
+                              const XMLLoader::Attributes &attr,
+                              ::std::shared_ptr<Ware>      ware);
 
     /**
      * @brief		Start element callback in production.
@@ -240,7 +345,7 @@ class GameWares :
     bool onStartElementInProduction(XMLLoader &                       loader,
                                     XMLLoader::Context &              context,
                                     const QString &                   name,
-                                    const QMap<QString, QString> &    attr,
+                                    const XMLLoader::Attributes &     attr,
                                     ::std::shared_ptr<ProductionInfo> info);
 
     /**
@@ -258,7 +363,7 @@ class GameWares :
     bool onStartElementInPrimary(XMLLoader &                       loader,
                                  XMLLoader::Context &              context,
                                  const QString &                   name,
-                                 const QMap<QString, QString> &    attr,
+                                 const XMLLoader::Attributes &     attr,
                                  ::std::shared_ptr<ProductionInfo> info);
 
     /**
@@ -276,7 +381,7 @@ class GameWares :
     bool onStartElementInEffects(XMLLoader &                       loader,
                                  XMLLoader::Context &              context,
                                  const QString &                   name,
-                                 const QMap<QString, QString> &    attr,
+                                 const XMLLoader::Attributes &     attr,
                                  ::std::shared_ptr<ProductionInfo> info);
 
     /**
@@ -295,7 +400,7 @@ class GameWares :
         onStartElementInExtensionsWaresRoot(XMLLoader &         loader,
                                             XMLLoader::Context &context,
                                             const QString &     name,
-                                            const QMap<QString, QString> &attr);
+                                            const XMLLoader::Attributes &attr);
 
     /**
      * @brief		Start element callback in wares of extensions.
@@ -308,8 +413,8 @@ class GameWares :
      * @return		Return \c true if the parsing should be continued.
      *				otherwise returns \c false.
      */
-    bool onStartElementInExtensionDiff(XMLLoader &                   loader,
-                                       XMLLoader::Context &          context,
-                                       const QString &               name,
-                                       const QMap<QString, QString> &attr);
+    bool onStartElementInExtensionDiff(XMLLoader &                  loader,
+                                       XMLLoader::Context &         context,
+                                       const QString &              name,
+                                       const XMLLoader::Attributes &attr);
 };
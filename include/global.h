@@ -29,6 +29,7 @@ class Global : public ISingleton<Global, int &, char **&, int &> {
     ::std::map<char, ArgInfo> m_argMap;  ///< Arguments.
     QString                   m_execDir; ///< Path of current executable file.
     QString                   m_configPath;    ///< Path of config file.
+    QString                   m_cacheDir;      ///< Directory of cache files.
     bool                      m_hasFileToOpen; ///< Has file to open.
     QString                   m_fileToOpen;    ///< File to open.
 
@@ -57,6 +58,13 @@ class Global : public ISingleton<Global, int &, char **&, int &> {
      */
     const QString &configPath() const;
 
+    /**
+     * @brief       Get directory of cache files.
+     *
+     * @return		Path of the directory.
+     */
+    const QString &cacheDir() const;
+
     /**
      * @brief       Check if there is a file to open.
      *
@@ -80,6 +80,13 @@ class StringTable : public QObject, public ISingleton<StringTable> {
      */
     void setLanguage(const QString &language);
 
+    /**
+     * @brief       Emit the signals of language changes again without
+     *  changing the language, called when the strings of current language
+     *  have been updated.
+     */
+    void refreshLanguage();
+
     /**
      * @brief   Get a \c QCollator object.
      *
@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include <QtCore/QAtomicInteger>
 #include <QtCore/QMap>
 #include <QtCore/QVector>
 #include <QtGui/QCloseEvent>
@@ -41,6 +42,7 @@ class EditorWidget : public QWidget {
     class PasteModuleOperation;
     class RemoveOperation;
     class RenameGroupOperation;
+    class SummaryModel;
 
   private:
     /**
@@ -107,6 +109,9 @@ class EditorWidget : public QWidget {
     MainWindow::EditActions *m_editActions;     ///< Edit actions.
     BackgroundTask *         m_backgroundTasks; ///< Background tasks.
 
+    ::std::unique_ptr<SummaryModel> m_summaryModel;      ///< Summary model.
+    QAtomicInteger<quint64>         m_summaryGeneration; ///< Newest summary.
+
     QVBoxLayout *m_layout; ///< Layout.
 
     QVector<WarningWidget *> m_widgetsWarningInfos; ///< Warning informations.
@@ -303,11 +308,41 @@ class EditorWidget : public QWidget {
     void updateSuggestedAmounts(SummaryInfo &summary);
 
     /**
-     * @brief       Make summary.
+     * @brief       Get amounts of modules in the station.
+     *
+     * @return      Amounts of modules, indexed by ordinal of module.
+     */
+    QVector<quint64> moduleAmounts();
+
+    /**
+     * @brief       Make summary from the amounts of modules, it can be
+     *              called in any thread.
      *
+     * @param[in]   amounts     Amounts of modules, indexed by ordinal.
      * @param[out]  summary     Summary.
      */
-    void makeSummary(SummaryInfo &summary);
+    static void makeSummary(const QVector<quint64> &amounts,
+                            SummaryInfo &           summary);
+
+    /**
+     * @brief       Move the wares both produced and consumed to
+     *              intermediates.
+     *
+     * @param[in,out]   summary     Summary.
+     */
+    static void makeIntermediates(SummaryInfo &summary);
+
+    /**
+     * @brief       Compare summaries.
+     *
+     * @param[in]   summary1    Summary 1.
+     * @param[in]   summary2    Summary 2.
+     *
+     * @return      Returns \c true if the summaries are the same, otherwise
+     *              returns \c false.
+     */
+    static bool compareSummary(const SummaryInfo &summary1,
+                               const SummaryInfo &summary2);
 
     /**
      * @brief       Show summary.
@@ -323,6 +358,16 @@ class EditorWidget : public QWidget {
      */
     void checkSummary(const SummaryInfo &summary);
 
+    /**
+     * @brief       Called in the GUI thread when the summary has been made in
+     *              background.
+     *
+     * @param[in]   generation  Generation of the summary.
+     * @param[in]   summary     Summary.
+     */
+    void onSummaryReady(quint64                        generation,
+                        ::std::shared_ptr<SummaryInfo> summary);
+
   private:
     /**
      * @brief		Close event.
@@ -491,3 +536,4 @@ class EditorWidget : public QWidget {
 };
 
 #include <ui/main_window/editor_widget/operation.h>
+#include <ui/main_window/editor_widget/summary_model.h>
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <game_data/game_station_modules.h>
+#include <save/save.h>
+#include <ui/main_window/editor_widget/editor_widget.h>
+
+/**
+ * @brief	Incremental summary model. The operations apply the amount
+ *			changes of modules as signed deltas, so the summary is updated in
+ *			constant time of the size of station.
+ */
+class EditorWidget::SummaryModel {
+  private:
+    /**
+     * @brief	Rate of ware.
+     */
+    struct WareRate {
+        long double min;        ///< Minimum amount per hour.
+        long double max;        ///< Maximum amount per hour.
+        qint64      references; ///< Amount of modules referencing the ware.
+    };
+
+  private:
+    GameStationModules::ColumnValues m_totals;    ///< Totals of columns.
+    QVector<WareRate>                m_resources; ///< Resources by ordinal.
+    QVector<WareRate>                m_products;  ///< Products by ordinal.
+    ::std::array<qint64, (size_t)GameStationModules::Storage::Count>
+        m_storageReferences; ///< Amount of modules requiring each storage.
+
+  public:
+    /**
+     * @brief		Constructor.
+     *
+     * @param[in]	save		Save file.
+     */
+    SummaryModel(::std::shared_ptr<Save> save);
+
+    /**
+     * @brief		Copy constructor. The wares are implicitly shared, so the
+     *				copy is a cheap immutable snapshot which can be read in
+     *				other threads.
+     *
+     * @param[in]	model		Model to copy.
+     */
+    SummaryModel(const SummaryModel &model) = default;
+
+    // Delete constructors
+    SummaryModel(SummaryModel &&) = delete;
+
+  public:
+    /**
+     * @brief		Apply the amount change of module.
+     *
+     * @param[in]	macro		Macro of the module.
+     * @param[in]	delta		Signed amount changed.
+     */
+    void addModule(const QString &macro, qint64 delta);
+
+    /**
+     * @brief		Apply the amount changes of all modules in group.
+     *
+     * @param[in]	group		Group.
+     * @param[in]	sign		1 if the group is added, -1 if the group is
+     *							removed.
+     */
+    void addGroup(::std::shared_ptr<SaveGroup> group, qint64 sign);
+
+    /**
+     * @brief		Make summary.
+     *
+     * @param[out]	summary		Summary.
+     */
+    void makeSummary(SummaryInfo &summary) const;
+
+    /**
+     * @brief		Destructor.
+     */
+    virtual ~SummaryModel();
+
+  private:
+    /**
+     * @brief		Add rate of ware.
+     *
+     * @param[in]	rates		Rates of wares.
+     * @param[in]	ware		Ordinal of the ware.
+     * @param[in]	min			Minimum amount per hour to add.
+     * @param[in]	max			Maximum amount per hour to add.
+     * @param[in]	references	Amount of modules to add.
+     */
+    static void addWareRate(QVector<WareRate> &rates,
+                            int                ware,
+                            long double        min,
+                            long double        max,
+                            qint64             references);
+};
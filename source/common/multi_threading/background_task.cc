@@ -1,3 +1,4 @@
+#include <QtCore/QCoreApplication>
 #include <QtCore/QMutexLocker>
 
 #include <common/multi_threading/background_task.h>
@@ -46,6 +47,7 @@ void BackgroundTask::runTask(::std::function<void()> task)
             this->connect(taskThread, &BackgroundTaskThread::finished, this,
                           &BackgroundTask::onTaskFinished,
                           Qt::ConnectionType::QueuedConnection);
+            m_threads.push_back(taskThread);
             taskThread->start();
             return;
         } break;
@@ -103,6 +105,21 @@ void BackgroundTask::cancle()
 void BackgroundTask::wait()
 {
     QMutexLocker locker(&m_lock);
+    if (QThread::currentThread() == this->thread()) {
+        // The finished callbacks are queued to this thread, so they cannot be
+        // called by the event loop while waiting. Join the threads and
+        // dispatch the callbacks here, the callbacks start the pending tasks.
+        while (! m_threads.empty()) {
+            BackgroundTaskThread *taskThread = m_threads.front();
+            locker.unlock();
+            taskThread->wait();
+            QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+            locker.relock();
+        }
+
+        return;
+    }
+
     if (m_threadCount > 0
         || (m_runType == RunType::Queued && ! m_taskQueue.empty())
         || (m_runType == RunType::Newest && m_newestTask != nullptr)) {
@@ -144,6 +161,7 @@ void BackgroundTask::nextTask()
             this->connect(taskThread, &BackgroundTaskThread::finished, this,
                           &BackgroundTask::onTaskFinished,
                           Qt::ConnectionType::QueuedConnection);
+            m_threads.push_back(taskThread);
             taskThread->start();
         } break;
 
@@ -156,9 +174,11 @@ void BackgroundTask::nextTask()
             // Run task
             BackgroundTaskThread *taskThread
                 = new BackgroundTaskThread(::std::move(m_newestTask), this);
+            m_newestTask = nullptr;
             this->connect(taskThread, &BackgroundTaskThread::finished, this,
                           &BackgroundTask::onTaskFinished,
                           Qt::ConnectionType::QueuedConnection);
+            m_threads.push_back(taskThread);
             taskThread->start();
         } break;
 
@@ -175,6 +195,8 @@ void BackgroundTask::nextTask()
 void BackgroundTask::onTaskFinished(BackgroundTaskThread *thread)
 {
     QMutexLocker locker(&m_lock);
+    m_threads.removeOne(thread);
+    thread->wait();
     delete thread;
     --m_threadCount;
 
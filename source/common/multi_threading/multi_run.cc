@@ -1,63 +1,37 @@
-#include <thread>
-
 #include <QtCore/QDebug>
 
 #include <common/multi_threading/multi_run.h>
+#include <common/multi_threading/task_pool.h>
 
 /**
  * @brief		Constructor.
  */
-MultiRunThread::MultiRunThread(::std::function<void()> task, QObject *parent) :
-    QThread(parent), m_task(task)
-{}
-
-/**
- * @brief	Destructor.
- */
-MultiRunThread::~MultiRunThread() {}
-
-/**
- * @brief	Thread functiuon
- */
-void MultiRunThread::run()
-{
-    m_task();
-}
-
-/**
- * @brief		Constructor.
- */
-MultiRun::MultiRun(::std::function<void()> task)
-{
-    size_t threadNum = ::std::thread::hardware_concurrency();
-    for (size_t i = 0; i < threadNum + 1; i++) {
-        m_threads.push_back(new MultiRunThread(task, this));
-    }
-}
+MultiRun::MultiRun(::std::function<void()> task) : m_task(task) {}
 
 /**
  * @brief		Run task.
  */
 void MultiRun::run(bool signleThread)
 {
-    if (signleThread) {
-        m_threads.front()->start();
-
+    ::std::shared_ptr<TaskPool> pool = TaskPool::instance();
+    if (signleThread || pool == nullptr) {
         qDebug() << "Multi-threading task started, number of thread is " << 1
                  << ".";
 
-        m_threads.front()->wait();
+        m_task();
     } else {
-        for (auto &thread : m_threads) {
-            thread->start();
+        // Current thread runs the task too, it takes the place of the
+        // thread which used to be started for the caller.
+        TaskGroup group;
+        for (int i = 0; i < pool->threadCount(); ++i) {
+            group.run(m_task);
         }
 
         qDebug() << "Multi-threading task started, number of thread is "
-                 << m_threads.size() << ".";
+                 << pool->threadCount() + 1 << ".";
 
-        for (auto &thread : m_threads) {
-            thread->wait();
-        }
+        m_task();
+        group.wait();
     }
 }
 
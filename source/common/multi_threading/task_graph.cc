@@ -0,0 +1,193 @@
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutexLocker>
+
+#include <common/multi_threading/task_graph.h>
+
+/**
+ * @brief		Constructor.
+ */
+TaskGraph::TaskGraph(::std::function<void(int, StageStatus)> statusFunc) :
+    m_statusFunc(statusFunc)
+{}
+
+/**
+ * @brief		Add stage.
+ */
+int TaskGraph::addStage(const QString &         name,
+                        ::std::function<bool()> task,
+                        const QVector<int> &    dependencies)
+{
+    int id = m_stages.size();
+    for (int dependency : dependencies) {
+        if (dependency < 0 || dependency >= id) {
+            qWarning() << "Illegal dependency of stage" << name << ":"
+                       << dependency << ".";
+            return -1;
+        }
+    }
+
+    m_stages.append({name, task, {}, dependencies.size(), 0,
+                     StageStatus::Waiting});
+    for (int dependency : dependencies) {
+        m_stages[dependency].dependents.append(id);
+    }
+
+    return id;
+}
+
+/**
+ * @brief		Get name of stage.
+ */
+const QString &TaskGraph::name(int stage) const
+{
+    return m_stages[stage].name;
+}
+
+/**
+ * @brief		Get status of stage.
+ */
+TaskGraph::StageStatus TaskGraph::status(int stage)
+{
+    QMutexLocker locker(&m_lock);
+    return m_stages[stage].status;
+}
+
+/**
+ * @brief		Run all stages and wait until finished.
+ */
+bool TaskGraph::run(bool signleThread)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Reset stages.
+    QVector<QPair<int, StageStatus>> changes;
+    {
+        QMutexLocker locker(&m_lock);
+        for (int i = 0; i < m_stages.size(); ++i) {
+            Stage &stage  = m_stages[i];
+            stage.waiting = stage.dependencies;
+            stage.status  = StageStatus::Waiting;
+            changes.append({i, StageStatus::Waiting});
+        }
+    }
+    this->notify(changes);
+
+    // Run.
+    if (signleThread) {
+        // All dependencies are added before the stage, so the stages can be
+        // run in the order of IDs.
+        for (int i = 0; i < m_stages.size(); ++i) {
+            if (this->status(i) == StageStatus::Waiting) {
+                this->runStage(i, nullptr);
+            }
+        }
+    } else {
+        TaskGroup group;
+        for (int i = 0; i < m_stages.size(); ++i) {
+            if (m_stages[i].dependencies == 0) {
+                group.run(::std::bind(&TaskGraph::runStage, this, i, &group));
+            }
+        }
+        group.wait();
+    }
+
+    // Check result.
+    bool ret = true;
+    for (auto &stage : m_stages) {
+        if (stage.status != StageStatus::Finished) {
+            ret = false;
+        }
+    }
+    qDebug() << m_stages.size() << "stages" << (ret ? "finished" : "failed")
+             << "in" << timer.elapsed() << "ms.";
+
+    return ret;
+}
+
+/**
+ * @brief	Destructor.
+ */
+TaskGraph::~TaskGraph() {}
+
+/**
+ * @brief		Run stage.
+ */
+void TaskGraph::runStage(int id, TaskGroup *group)
+{
+    Stage &stage = m_stages[id];
+    {
+        QMutexLocker locker(&m_lock);
+        stage.status = StageStatus::Running;
+    }
+    this->notify({{id, StageStatus::Running}});
+
+    // Run stage.
+    QElapsedTimer timer;
+    timer.start();
+    bool succeeded = stage.task();
+    qDebug() << "Stage" << stage.name << (succeeded ? "finished" : "failed")
+             << "in" << timer.elapsed() << "ms.";
+
+    // Update dependents.
+    QVector<QPair<int, StageStatus>> changes;
+    QVector<int>                     ready;
+    {
+        QMutexLocker locker(&m_lock);
+        if (succeeded) {
+            stage.status = StageStatus::Finished;
+            changes.append({id, StageStatus::Finished});
+            for (int dependent : stage.dependents) {
+                Stage &dependentStage = m_stages[dependent];
+                --dependentStage.waiting;
+                if (dependentStage.waiting == 0
+                    && dependentStage.status == StageStatus::Waiting) {
+                    ready.append(dependent);
+                }
+            }
+        } else {
+            stage.status = StageStatus::Failed;
+            changes.append({id, StageStatus::Failed});
+            this->skipDependents(id, changes);
+        }
+    }
+    this->notify(changes);
+
+    if (group != nullptr) {
+        for (int dependent : ready) {
+            group->run(
+                ::std::bind(&TaskGraph::runStage, this, dependent, group));
+        }
+    }
+}
+
+/**
+ * @brief		Skip all stages depends on a failed stage.
+ */
+void TaskGraph::skipDependents(int                               stage,
+                               QVector<QPair<int, StageStatus>> &changes)
+{
+    for (int dependent : m_stages[stage].dependents) {
+        Stage &dependentStage = m_stages[dependent];
+        if (dependentStage.status == StageStatus::Waiting) {
+            dependentStage.status = StageStatus::Skipped;
+            changes.append({dependent, StageStatus::Skipped});
+            this->skipDependents(dependent, changes);
+        }
+    }
+}
+
+/**
+ * @brief		Call status callback.
+ */
+void TaskGraph::notify(const QVector<QPair<int, StageStatus>> &changes)
+{
+    if (m_statusFunc == nullptr) {
+        return;
+    }
+
+    for (auto &change : changes) {
+        m_statusFunc(change.first, change.second);
+    }
+}
@@ -0,0 +1,314 @@
+#include <thread>
+
+#include <QtCore/QDebug>
+#include <QtCore/QMutexLocker>
+
+#include <common/compare.h>
+#include <common/multi_threading/task_pool.h>
+
+thread_local int TaskPool::_workerIndex = -1;
+
+/**
+ * @brief		Constructor.
+ */
+TaskPoolThread::TaskPoolThread(::std::function<void()> task) :
+    QThread(nullptr), m_task(::std::move(task))
+{}
+
+/**
+ * @brief	Destructor.
+ */
+TaskPoolThread::~TaskPoolThread() {}
+
+/**
+ * @brief	Thread functiuon
+ */
+void TaskPoolThread::run()
+{
+    m_task();
+}
+
+/**
+ * @brief		Constructor.
+ */
+TaskPool::TaskPool() :
+    m_pending(0), m_nextQueue(0), m_stop(false), m_executed(0), m_stolen(0)
+{
+    int threadNum = max((int)::std::thread::hardware_concurrency(), 1);
+    for (int i = 0; i < threadNum; ++i) {
+        m_queues.push_back(new TaskQueue);
+    }
+    for (int i = 0; i < threadNum; ++i) {
+        m_threads.push_back(new TaskPoolThread(
+            ::std::bind(&TaskPool::workerThread, this, i)));
+        m_threads.back()->start();
+    }
+
+    qDebug() << "Task pool started, number of thread is" << threadNum << ".";
+    this->setInitialized();
+}
+
+/**
+ * @brief		Get count of worker threads.
+ */
+int TaskPool::threadCount() const
+{
+    return m_threads.size();
+}
+
+/**
+ * @brief		Call \c func for sub ranges of [begin, end) in parallel
+ *				and wait until finished.
+ */
+void TaskPool::parallelFor(int                                    begin,
+                           int                                    end,
+                           const ::std::function<void(int, int)> &func,
+                           int                                    grain)
+{
+    TaskGroup group;
+    group.parallelFor(begin, end, func, grain);
+}
+
+/**
+ * @brief	Destructor.
+ */
+TaskPool::~TaskPool()
+{
+    {
+        QMutexLocker locker(&m_sleepLock);
+        m_stop = true;
+        m_sleepCond.wakeAll();
+    }
+
+    for (auto &thread : m_threads) {
+        thread->wait();
+        delete thread;
+    }
+    for (auto &queue : m_queues) {
+        delete queue;
+    }
+
+    qDebug() << "Task pool stopped," << (quint64)m_executed << "tasks executed,"
+             << (quint64)m_stolen << "tasks stolen.";
+}
+
+/**
+ * @brief		Put task into queue.
+ */
+void TaskPool::submit(Task task)
+{
+    // Workers put tasks into their own queues, other threads spread tasks
+    // over all queues.
+    int index = _workerIndex;
+    if (index < 0) {
+        index = (int)((quint32)m_nextQueue.fetchAndAddRelaxed(1)
+                      % (quint32)m_queues.size());
+    }
+
+    {
+        TaskQueue *  queue = m_queues[index];
+        QMutexLocker locker(&(queue->lock));
+        queue->tasks.push_back(::std::move(task));
+    }
+    m_pending.fetchAndAddOrdered(1);
+
+    QMutexLocker locker(&m_sleepLock);
+    m_sleepCond.wakeOne();
+}
+
+/**
+ * @brief		Take a task and run it.
+ */
+bool TaskPool::runOne(TaskGroup *group)
+{
+    Task task;
+    if (! this->take(group, task)) {
+        return false;
+    }
+
+    if (! task.group->canceled()) {
+        task.func();
+    }
+    m_executed.fetchAndAddRelaxed(1);
+    task.group->finishTask();
+
+    return true;
+}
+
+/**
+ * @brief		Take a task.
+ */
+bool TaskPool::take(TaskGroup *group, Task &task)
+{
+    if (m_pending.loadAcquire() == 0) {
+        return false;
+    }
+
+    int self  = max(_workerIndex, 0);
+    int count = m_queues.size();
+    for (int i = 0; i < count; ++i) {
+        TaskQueue *  queue = m_queues[(self + i) % count];
+        QMutexLocker locker(&(queue->lock));
+        if (queue->tasks.empty()) {
+            continue;
+        }
+
+        if (group == nullptr) {
+            // Newest task from own queue, oldest task from the others.
+            if (i == 0 && _workerIndex >= 0) {
+                task = queue->tasks.takeLast();
+            } else {
+                task = queue->tasks.takeFirst();
+                m_stolen.fetchAndAddRelaxed(1);
+            }
+            m_pending.fetchAndAddOrdered(-1);
+            return true;
+
+        } else {
+            for (auto iter = queue->tasks.begin(); iter != queue->tasks.end();
+                 ++iter) {
+                if (iter->group == group) {
+                    task = ::std::move(*iter);
+                    queue->tasks.erase(iter);
+                    m_pending.fetchAndAddOrdered(-1);
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief		Worker thread.
+ */
+void TaskPool::workerThread(int index)
+{
+    _workerIndex = index;
+    while (true) {
+        if (this->runOne(nullptr)) {
+            continue;
+        }
+
+        QMutexLocker locker(&m_sleepLock);
+        while (m_pending.loadAcquire() == 0 && ! m_stop) {
+            m_sleepCond.wait(&m_sleepLock);
+        }
+        if (m_stop && m_pending.loadAcquire() == 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief		Constructor.
+ */
+TaskGroup::TaskGroup() : m_pending(0), m_canceled(0) {}
+
+/**
+ * @brief		Run task in the task pool.
+ */
+void TaskGroup::run(::std::function<void()> task)
+{
+    ::std::shared_ptr<TaskPool> pool = TaskPool::instance();
+    if (pool == nullptr) {
+        if (! this->canceled()) {
+            task();
+        }
+        return;
+    }
+
+    m_pending.fetchAndAddOrdered(1);
+    pool->submit({::std::move(task), this});
+
+    // Let the waiting thread help.
+    QMutexLocker locker(&m_lock);
+    m_cond.wakeAll();
+}
+
+/**
+ * @brief		Call \c func for sub ranges of [begin, end) in parallel
+ *				and wait until finished.
+ */
+void TaskGroup::parallelFor(int                                    begin,
+                            int                                    end,
+                            const ::std::function<void(int, int)> &func,
+                            int                                    grain)
+{
+    grain = max(grain, 1);
+
+    // Split the range in halves, so idle workers steal large ranges.
+    ::std::function<void(int, int)> split;
+    split = [&](int first, int last) -> void {
+        while (last - first > grain && ! this->canceled()) {
+            int middle = first + (last - first) / 2;
+            this->run([&split, middle, last]() -> void {
+                split(middle, last);
+            });
+            last = middle;
+        }
+        if (first < last && ! this->canceled()) {
+            func(first, last);
+        }
+    };
+    split(begin, end);
+
+    this->wait();
+}
+
+/**
+ * @brief		Wait until all tasks finished.
+ */
+void TaskGroup::wait()
+{
+    ::std::shared_ptr<TaskPool> pool = TaskPool::instance();
+    while (m_pending.loadAcquire() > 0) {
+        if (pool != nullptr && pool->runOne(this)) {
+            continue;
+        }
+
+        QMutexLocker locker(&m_lock);
+        if (m_pending.loadAcquire() > 0) {
+            m_cond.wait(&m_lock);
+        }
+    }
+
+    // Make sure the last finished task has released the lock.
+    QMutexLocker locker(&m_lock);
+}
+
+/**
+ * @brief		Cancel the group.
+ */
+void TaskGroup::cancel()
+{
+    m_canceled.storeRelease(1);
+}
+
+/**
+ * @brief		Check if the group has been canceled.
+ */
+bool TaskGroup::canceled() const
+{
+    return m_canceled.loadAcquire() != 0;
+}
+
+/**
+ * @brief		Destructor, wait until all tasks finished.
+ */
+TaskGroup::~TaskGroup()
+{
+    this->wait();
+}
+
+/**
+ * @brief		Called when a task has been finished.
+ */
+void TaskGroup::finishTask()
+{
+    QMutexLocker locker(&m_lock);
+    if (m_pending.fetchAndAddOrdered(-1) == 1) {
+        m_cond.wakeAll();
+    }
+}
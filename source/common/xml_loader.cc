@@ -1,9 +1,31 @@
+#include <QtCore/QReadLocker>
+#include <QtCore/QWriteLocker>
+
+#include <common/xml_loader_context.h>
 #include <common/xml_loader.h>
 
+QReadWriteLock                    XMLLoader::_nameLock;
+XMLLoader::NameTable              XMLLoader::_names;
+thread_local XMLLoader::NameTable XMLLoader::_localNames;
+
 /**
  * @brief	Constructor.
  */
-XMLLoader::XMLLoader() {}
+XMLLoader::XMLLoader() : m_skipElement(false) {}
+
+/**
+ * @brief		Create context.
+ */
+::std::unique_ptr<XMLLoader::Context> XMLLoader::createContext()
+{
+    if (m_freeContexts.empty()) {
+        return Context::create();
+    }
+
+    ::std::unique_ptr<Context> ret = ::std::move(m_freeContexts.back());
+    m_freeContexts.pop_back();
+    return ret;
+}
 
 /**
  * @brief		Push context.
@@ -14,6 +36,14 @@ void XMLLoader::pushContext(::std::unique_ptr<Context> context)
     m_contextStack.push_back(::std::move(context));
 }
 
+/**
+ * @brief		Skip current element.
+ */
+void XMLLoader::skipElement()
+{
+    m_skipElement = true;
+}
+
 /**
  * @brief	Parse XML.
  */
@@ -21,8 +51,12 @@ bool XMLLoader::parse(QXmlStreamReader &         reader,
                       ::std::unique_ptr<Context> context)
 {
     // Push first context
-    m_contextStack.clear();
+    while (! m_contextStack.empty()) {
+        this->recycleContext(::std::move(m_contextStack.back()));
+        m_contextStack.pop_back();
+    }
     m_contextStack.push_back(::std::move(context));
+    m_skipElement = false;
 
     // Parse file
     while (! (m_contextStack.empty() || reader.atEnd())) {
@@ -45,30 +79,57 @@ bool XMLLoader::parse(QXmlStreamReader &         reader,
 
             case QXmlStreamReader::TokenType::StartElement: {
                 // Name.
-                QString name = reader.name().toString();
+                int     nameID;
+                QString name = XMLLoader::internName(reader.name(), nameID);
 
                 // Attributes.
-                QMap<QString, QString> attributes;
-                for (auto attr : reader.attributes()) {
-                    attributes[attr.qualifiedName().toString()]
-                        = attr.value().toString();
-                }
+                Attributes attributes(reader.attributes());
 
-                m_contextStack.back()->pushElement(name);
+                Context *current = m_contextStack.back().get();
+                current->pushElement(nameID);
 
                 // Call callback.
-                if (! m_contextStack.back()->onStartElement(
-                        *this, *m_contextStack.back(), name, attributes)) {
+                if (! current->onStartElement(*this, *current, name,
+                                              attributes)) {
                     return false;
                 }
+
+                // The contexts pushed without callbacks can not see anything
+                // in the element, skip it.
+                if (! m_skipElement && m_contextStack.back().get() != current) {
+                    m_skipElement = true;
+                    for (auto iter = m_contextStack.rbegin();
+                         iter->get() != current; ++iter) {
+                        if ((*iter)->hasCallbacks()) {
+                            m_skipElement = false;
+                            break;
+                        }
+                    }
+                }
+
+                // Skip element.
+                if (m_skipElement) {
+                    m_skipElement = false;
+                    while (m_contextStack.back().get() != current) {
+                        this->recycleContext(
+                            ::std::move(m_contextStack.back()));
+                        m_contextStack.pop_back();
+                    }
+                    reader.skipCurrentElement();
+                    current->popElement(nameID);
+                    if (! current->onStopElement(*this, *current, name)) {
+                        return false;
+                    }
+                }
             } break;
 
             case QXmlStreamReader::TokenType::EndElement: {
                 // Name.
-                QString name = reader.name().toString();
+                int     nameID;
+                QString name = XMLLoader::internName(reader.name(), nameID);
 
                 while (! m_contextStack.empty()) {
-                    if (m_contextStack.back()->popElement(name)) {
+                    if (m_contextStack.back()->popElement(nameID)) {
                         // Call callback.
                         if (m_contextStack.back()->onStopElement(
                                 *this, *m_contextStack.back(), name)) {
@@ -77,6 +138,8 @@ bool XMLLoader::parse(QXmlStreamReader &         reader,
                             return false;
                         }
                     } else {
+                        this->recycleContext(
+                            ::std::move(m_contextStack.back()));
                         m_contextStack.pop_back();
                     }
                 }
@@ -84,8 +147,7 @@ bool XMLLoader::parse(QXmlStreamReader &         reader,
 
             case QXmlStreamReader::TokenType::Characters:
                 if (! m_contextStack.back()->onCharacters(
-                        *this, *m_contextStack.back(),
-                        reader.text().toString())) {
+                        *this, *m_contextStack.back(), reader.text())) {
                     return false;
                 }
                 break;
@@ -111,3 +173,57 @@ XMLLoader::~XMLLoader() {}
 {
     return m_values[key];
 }
+
+/**
+ * @brief		Intern element name.
+ */
+QString XMLLoader::internName(const QStringRef &name, int &id)
+{
+    // Names seen by current thread, no lock is needed.
+    uint hash  = qHash(name);
+    int  index = _localNames.find(name, hash);
+    if (index < 0) {
+        QString internedName;
+        int     globalID
+            = XMLLoader::internGlobalName(name, hash, internedName);
+        index = _localNames.insert(internedName, hash, globalID);
+    }
+
+    id = _localNames.id(index);
+    return _localNames.name(index);
+}
+
+/**
+ * @brief		Intern element name in the global table.
+ */
+int XMLLoader::internGlobalName(const QStringRef &name,
+                                uint              hash,
+                                QString &         internedName)
+{
+    {
+        QReadLocker locker(&_nameLock);
+        int         index = _names.find(name, hash);
+        if (index >= 0) {
+            internedName = _names.name(index);
+            return _names.id(index);
+        }
+    }
+
+    QWriteLocker locker(&_nameLock);
+    int          index = _names.find(name, hash);
+    if (index < 0) {
+        index = _names.insert(name.toString(), hash, _names.size());
+    }
+    internedName = _names.name(index);
+
+    return _names.id(index);
+}
+
+/**
+ * @brief		Recycle context.
+ */
+void XMLLoader::recycleContext(::std::unique_ptr<Context> context)
+{
+    context->reset();
+    m_freeContexts.push_back(::std::move(context));
+}
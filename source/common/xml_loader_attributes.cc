@@ -0,0 +1,167 @@
+#include <QtCore/QLatin1String>
+
+#include <common/xml_loader_attributes.h>
+
+/**
+ * @brief		Constructor.
+ */
+XMLLoader::Attributes::const_iterator::const_iterator(
+    QXmlStreamAttributes::const_iterator iter) :
+    m_iter(iter)
+{}
+
+/**
+ * @brief		Get name of the attribute.
+ */
+QString XMLLoader::Attributes::const_iterator::key() const
+{
+    return m_iter->qualifiedName().toString();
+}
+
+/**
+ * @brief		Get value of the attribute.
+ */
+QString XMLLoader::Attributes::const_iterator::value() const
+{
+    return m_iter->value().toString();
+}
+
+/**
+ * @brief		Get value of the attribute.
+ */
+QString XMLLoader::Attributes::const_iterator::operator*() const
+{
+    return m_iter->value().toString();
+}
+
+/**
+ * @brief		Move to next attribute.
+ */
+XMLLoader::Attributes::const_iterator &
+    XMLLoader::Attributes::const_iterator::operator++()
+{
+    ++m_iter;
+    return *this;
+}
+
+/**
+ * @brief		Operator ==.
+ */
+bool XMLLoader::Attributes::const_iterator::operator==(
+    const const_iterator &iter) const
+{
+    return m_iter == iter.m_iter;
+}
+
+/**
+ * @brief		Operator !=.
+ */
+bool XMLLoader::Attributes::const_iterator::operator!=(
+    const const_iterator &iter) const
+{
+    return m_iter != iter.m_iter;
+}
+
+/**
+ * @brief		Constructor.
+ */
+XMLLoader::Attributes::Attributes(const QXmlStreamAttributes &attributes) :
+    m_attributes(attributes)
+{}
+
+/**
+ * @brief		Get count of attributes.
+ */
+int XMLLoader::Attributes::size() const
+{
+    return m_attributes.size();
+}
+
+/**
+ * @brief		Find attribute.
+ */
+XMLLoader::Attributes::const_iterator
+    XMLLoader::Attributes::find(const char *name) const
+{
+    QLatin1String key(name);
+    for (auto iter = m_attributes.begin(); iter != m_attributes.end(); ++iter) {
+        if (iter->qualifiedName() == key) {
+            return const_iterator(iter);
+        }
+    }
+
+    return this->end();
+}
+
+/**
+ * @brief		Find attribute.
+ */
+XMLLoader::Attributes::const_iterator
+    XMLLoader::Attributes::find(const QString &name) const
+{
+    for (auto iter = m_attributes.begin(); iter != m_attributes.end(); ++iter) {
+        if (iter->qualifiedName() == name) {
+            return const_iterator(iter);
+        }
+    }
+
+    return this->end();
+}
+
+/**
+ * @brief		Check if the attribute exists.
+ */
+bool XMLLoader::Attributes::contains(const char *name) const
+{
+    return this->find(name) != this->end();
+}
+
+/**
+ * @brief		Check if the attribute exists.
+ */
+bool XMLLoader::Attributes::contains(const QString &name) const
+{
+    return this->find(name) != this->end();
+}
+
+/**
+ * @brief		Get begin iterator.
+ */
+XMLLoader::Attributes::const_iterator XMLLoader::Attributes::begin() const
+{
+    return const_iterator(m_attributes.begin());
+}
+
+/**
+ * @brief		Get end iterator.
+ */
+XMLLoader::Attributes::const_iterator XMLLoader::Attributes::end() const
+{
+    return const_iterator(m_attributes.end());
+}
+
+/**
+ * @brief		Get value of the attribute.
+ */
+QString XMLLoader::Attributes::operator[](const char *name) const
+{
+    auto iter = this->find(name);
+    if (iter == this->end()) {
+        return QString();
+    } else {
+        return *iter;
+    }
+}
+
+/**
+ * @brief		Get value of the attribute.
+ */
+QString XMLLoader::Attributes::operator[](const QString &name) const
+{
+    auto iter = this->find(name);
+    if (iter == this->end()) {
+        return QString();
+    } else {
+        return *iter;
+    }
+}
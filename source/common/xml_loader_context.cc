@@ -15,10 +15,23 @@ XMLLoader::Context::Context() {}
     return ::std::unique_ptr<Context>(new Context());
 }
 
+/**
+ * @brief		Reset context, remove all elements and callbacks.
+ */
+void XMLLoader::Context::reset()
+{
+    m_elementStack.clear();
+    m_onStartDocument = nullptr;
+    m_onStopDocument  = nullptr;
+    m_onStartElement  = nullptr;
+    m_onStopElement   = nullptr;
+    m_onCharacters    = nullptr;
+}
+
 /**
  * @brief		Push element.
  */
-void XMLLoader::Context::pushElement(const QString &name)
+void XMLLoader::Context::pushElement(int name)
 {
     m_elementStack.push_back(name);
 }
@@ -26,7 +39,7 @@ void XMLLoader::Context::pushElement(const QString &name)
 /**
  * @brief		Pop element.
  */
-bool XMLLoader::Context::popElement(const QString &name)
+bool XMLLoader::Context::popElement(int name)
 {
     while (! m_elementStack.empty()) {
         if (m_elementStack.back() == name) {
@@ -40,6 +53,15 @@ bool XMLLoader::Context::popElement(const QString &name)
     return false;
 }
 
+/**
+ * @brief		Check if any callback has been set.
+ */
+bool XMLLoader::Context::hasCallbacks() const
+{
+    return m_onStartDocument || m_onStopDocument || m_onStartElement
+           || m_onStopElement || m_onCharacters;
+}
+
 // Document
 /**
  * @brief		Set on start document callback.
@@ -91,7 +113,7 @@ void XMLLoader::Context::setOnStartElement(
     ::std::function<bool(XMLLoader &,
                          Context &,
                          const QString &,
-                         const QMap<QString, QString> &)> onStartElement)
+                         const XMLLoader::Attributes &)> onStartElement)
 {
     m_onStartElement = onStartElement;
 }
@@ -99,10 +121,10 @@ void XMLLoader::Context::setOnStartElement(
 /**
  * @brief		On start element callback.
  */
-bool XMLLoader::Context::onStartElement(XMLLoader &                   loader,
-                                        Context &                     context,
-                                        const QString &               name,
-                                        const QMap<QString, QString> &attr)
+bool XMLLoader::Context::onStartElement(XMLLoader &                  loader,
+                                        Context &                    context,
+                                        const QString &              name,
+                                        const XMLLoader::Attributes &attr)
 {
     if (m_onStartElement) {
         return m_onStartElement(loader, context, name, attr);
@@ -148,12 +170,12 @@ void XMLLoader::Context::setOnCharacters(
 /**
  * @brief		On characters callback.
  */
-bool XMLLoader::Context::onCharacters(XMLLoader &    loader,
-                                      Context &      context,
-                                      const QString &text)
+bool XMLLoader::Context::onCharacters(XMLLoader &       loader,
+                                      Context &         context,
+                                      const QStringRef &text)
 {
     if (m_onCharacters) {
-        return m_onCharacters(loader, context, text);
+        return m_onCharacters(loader, context, text.toString());
     }
 
     return true;
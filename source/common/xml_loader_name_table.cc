@@ -0,0 +1,65 @@
+#include <common/compare.h>
+#include <common/xml_loader_name_table.h>
+
+/**
+ * @brief		Constructor.
+ */
+XMLLoader::NameTable::NameTable() {}
+
+/**
+ * @brief		Find name.
+ */
+int XMLLoader::NameTable::find(const QStringRef &name, uint hash) const
+{
+    if (m_buckets.empty()) {
+        return -1;
+    }
+
+    int mask  = m_buckets.size() - 1;
+    int index = (int)(hash & (uint)mask);
+    while (m_buckets[index] >= 0) {
+        int i = m_buckets[index];
+        if (m_hashes[i] == hash && m_names[i] == name) {
+            return i;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief		Insert name.
+ */
+int XMLLoader::NameTable::insert(const QString &name, uint hash, int id)
+{
+    int index = m_names.size();
+    m_names.push_back(name);
+    m_hashes.push_back(hash);
+    m_ids.push_back(id);
+
+    // Rehash, keep the load factor under 1/2.
+    if (m_names.size() * 2 > m_buckets.size()) {
+        m_buckets.fill(-1, max(m_buckets.size() * 2, 64));
+        for (int i = 0; i < m_names.size(); ++i) {
+            this->putBucket(i);
+        }
+    } else {
+        this->putBucket(index);
+    }
+
+    return index;
+}
+
+/**
+ * @brief		Put index of name into hash buckets.
+ */
+void XMLLoader::NameTable::putBucket(int index)
+{
+    int mask   = m_buckets.size() - 1;
+    int bucket = (int)(m_hashes[index] & (uint)mask);
+    while (m_buckets[bucket] >= 0) {
+        bucket = (bucket + 1) & mask;
+    }
+    m_buckets[bucket] = index;
+}
@@ -1,4 +1,5 @@
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QRegExp>
@@ -8,7 +9,7 @@
 #include <locale/string_table.h>
 
 /**
- * @brief		Constructor.
+ * @brief		Constructor, load the components of the base game.
  */
 GameComponents::GameComponents(
     ::std::shared_ptr<GameVFS>             vfs,
@@ -20,45 +21,86 @@ GameComponents::GameComponents(
     // Open file.
     ::std::shared_ptr<GameVFS::FileReader> file
         = vfs->open("/index/components.xml");
-    QByteArray       data = file->readAll();
-    QXmlStreamReader reader(data);
+    QElapsedTimer timer;
+    timer.start();
 
     // Parse file
-    auto context = XMLLoader::Context::create();
-    context->setOnStartElement(
-        ::std::bind(&GameComponents::onStartElementInRoot, this,
-                    ::std::placeholders::_1, ::std::placeholders::_2,
-                    ::std::placeholders::_3, ::std::placeholders::_4));
-    XMLLoader loader;
-    loader.parse(reader, ::std::move(context));
-
-    // Parse extension files
+    this->parseIndex(file->readAll());
+    qDebug() << m_components.size() << "components of the base game indexed in"
+             << timer.elapsed() << "ms.";
+
+    this->setInitialized();
+}
+
+/**
+ * @brief		Constructor, load components from snapshot.
+ */
+GameComponents::GameComponents(QDataStream &stream)
+{
+    stream >> m_components;
+    if (stream.status() != QDataStream::Status::Ok) {
+        return;
+    }
+    qDebug() << m_components.size() << "components loaded from snapshot.";
+
+    this->setInitialized();
+}
+
+/**
+ * @brief		Load components from snapshot.
+ */
+::std::shared_ptr<GameComponents>
+    GameComponents::loadSnapshot(QDataStream &stream)
+{
+    ::std::shared_ptr<GameComponents> ret(new GameComponents(stream));
+
+    if (ret == nullptr || ! ret->initialized()) {
+        return nullptr;
+    } else {
+        return ret;
+    }
+}
+
+/**
+ * @brief		Save components to snapshot.
+ */
+void GameComponents::saveSnapshot(QDataStream &stream)
+{
+    stream << m_components;
+}
+
+/**
+ * @brief		Load the components of extensions.
+ */
+bool GameComponents::applyExtensions(::std::shared_ptr<GameVFS> vfs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
     ::std::shared_ptr<::GameVFS::DirReader> extensionsDir
         = vfs->openDir("/extensions");
     if (extensionsDir != nullptr) {
         for (auto iter = extensionsDir->begin(); iter != extensionsDir->end();
              ++iter) {
             if (iter->type == ::GameVFS::DirReader::EntryType::Directory) {
-                file = vfs->open(QString("/extensions/%1/index/components.xml")
-                                     .arg(iter->name));
+                ::std::shared_ptr<GameVFS::FileReader> file
+                    = vfs->open(QString("/extensions/%1/index/components.xml")
+                                    .arg(iter->name));
                 if (file == nullptr) {
                     continue;
                 }
-                data = file->readAll();
-                QXmlStreamReader waresReader(data);
-
-                // Parse ware file
-                context = XMLLoader::Context::create();
-                context->setOnStartElement(::std::bind(
-                    &GameComponents::onStartElementInRoot, this,
-                    ::std::placeholders::_1, ::std::placeholders::_2,
-                    ::std::placeholders::_3, ::std::placeholders::_4));
-                loader.parse(waresReader, ::std::move(context));
+                if (! this->parseIndex(file->readAll())) {
+                    qWarning() << "Failed to parse index file of extension"
+                               << iter->name << ".";
+                    return false;
+                }
             }
         }
     }
+    qDebug() << "Index files of extensions loaded in" << timer.elapsed()
+             << "ms," << m_components.size() << "components indexed.";
 
-    this->setInitialized();
+    return true;
 }
 
 /**
@@ -66,7 +108,7 @@ GameComponents::GameComponents(
  */
 QString GameComponents::component(const QString &id)
 {
-    return m_components[id];
+    return m_components.value(id);
 }
 
 /**
@@ -75,50 +117,17 @@ QString GameComponents::component(const QString &id)
 GameComponents::~GameComponents() {}
 
 /**
- * @brief		Start element callback in root.
+ * @brief		Parse index file.
  */
-bool GameComponents::onStartElementInRoot(XMLLoader &                   loader,
-                                          XMLLoader::Context &          context,
-                                          const QString &               name,
-                                          const QMap<QString, QString> &attr)
+bool GameComponents::parseIndex(const QByteArray &data)
 {
-    UNREFERENCED_PARAMETER(context);
-    UNREFERENCED_PARAMETER(attr);
-    if (name == "index") {
-        auto context = XMLLoader::Context::create();
-        context->setOnStartElement(
-            ::std::bind(&GameComponents::onStartElementInIndex, this,
-                        ::std::placeholders::_1, ::std::placeholders::_2,
-                        ::std::placeholders::_3, ::std::placeholders::_4));
-        loader.pushContext(::std::move(context));
-    } else {
-        loader.pushContext(XMLLoader::Context::create());
-    }
-    return true;
-}
-
-/**
- * @brief		Start element callback in index.
- */
-bool GameComponents::onStartElementInIndex(XMLLoader &         loader,
-                                           XMLLoader::Context &context,
-                                           const QString &     name,
-                                           const QMap<QString, QString> &attr)
-{
-    UNREFERENCED_PARAMETER(context);
-    if (name == "entry") {
-        auto nameIter  = attr.find("name");
-        auto valueIter = attr.find("value");
-        if (nameIter != attr.end() && valueIter != attr.end()) {
-            QString name  = nameIter.value();
+    QXmlStreamReader reader(data);
+    return XMLSchema<_indexSchema>::parse(
+        reader, [this](const XMLSchema<_indexSchema>::Values &values) {
+            QString name  = values[0].toString();
             QString value = "/";
-            value.append(valueIter.value());
+            value.append(values[1]);
             value.replace('\\', '/');
             m_components[name] = value;
-            qDebug() << "Component " << name << "=" << value << ".";
-        }
-    }
-
-    loader.pushContext(XMLLoader::Context::create());
-    return true;
+        });
 }
@@ -1,16 +1,31 @@
+#include <cstring>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QRegExp>
+#include <QtCore/QSaveFile>
 #include <QtCore/QThread>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
 
+#include <common.h>
+#include <common/multi_threading/task_graph.h>
 #include <config.h>
 #include <game_data/game_data.h>
 #include <game_data/game_texts.h>
+#include <global.h>
 #include <locale/string_table.h>
 
+const char GameData::_snapshotMagic[8]
+    = {'X', '4', 'S', 'C', 'G', 'D', 'B', 'S'};
+const quint32 GameData::_snapshotVersion = 2;
+
 /**
  * @brief		Constructor.
  */
@@ -31,122 +46,253 @@ GameData::GameData(SplashWidget *splash) : QObject(nullptr)
             }
         }
 
+        // Texts of stages shown in splash.
+        QStringList stageTexts;
+        QMutex      stageTextsLock;
+        auto setStageText = [&](int stage, const QString &text) -> void {
+            QMutexLocker locker(&stageTextsLock);
+            stageTexts[stage] = text;
+            splash->setText(stageTexts.join("\n"));
+        };
+        TaskGraph loadGraph(
+            [&](int stage, TaskGraph::StageStatus status) -> void {
+                switch (status) {
+                    case TaskGraph::StageStatus::Waiting:
+                        setStageText(stage, STR("STR_STAGE_WAITING")
+                                                .arg(loadGraph.name(stage)));
+                        break;
+
+                    case TaskGraph::StageStatus::Running:
+                        setStageText(stage, loadGraph.name(stage));
+                        break;
+
+                    case TaskGraph::StageStatus::Finished:
+                        setStageText(stage, STR("STR_STAGE_FINISHED")
+                                                .arg(loadGraph.name(stage)));
+                        break;
+
+                    case TaskGraph::StageStatus::Failed:
+                        setStageText(stage, STR("STR_STAGE_FAILED")
+                                                .arg(loadGraph.name(stage)));
+                        break;
+
+                    case TaskGraph::StageStatus::Skipped:
+                        setStageText(stage, STR("STR_STAGE_SKIPPED")
+                                                .arg(loadGraph.name(stage)));
+                        break;
+                }
+            });
+        QMap<int, QString> failedMessages;
+
         // Load vfs
-        splash->setText(STR("STR_LOADING_VFS"));
-        ::std::shared_ptr<GameVFS> vfs = GameVFS::create(
-            m_gamePath, catFiles,
-            [&](const QString &s) -> void {
-                splash->setText(STR("STR_LOADING_VFS") + "\n" + s);
-            },
-            [&](const QString &s) -> void {
-                splash->callFunc(::std::function<void()>([&]() -> void {
-                    QMessageBox::critical(splash, STR("STR_ERROR"), s);
-                }));
+        Objects objects;
+        int     vfsStage = loadGraph.addStage(
+            STR("STR_LOADING_VFS"), [&]() -> bool {
+                objects.vfs = GameVFS::create(
+                    m_gamePath, catFiles,
+                    [&](const QString &s) -> void {
+                        setStageText(vfsStage,
+                                     STR("STR_LOADING_VFS") + "\n" + s);
+                    },
+                    [&](const QString &s) -> void {
+                        splash->callFunc(
+                            ::std::function<void()>([&]() -> void {
+                                QMessageBox::critical(splash, STR("STR_ERROR"),
+                                                      s);
+                            }));
+                    });
+                return objects.vfs != nullptr;
             });
-        if (vfs == nullptr) {
-            Config::instance()->setString("/gamePath", "");
-            continue;
-        }
+
+        // Load snapshot. The full snapshot is used if no game file has
+        // changed, otherwise the snapshot of the base game is used if only
+        // the extensions have changed, and the extensions are loaded on it.
+        bool useSnapshot
+            = Config::instance()->getBool("/gameDataSnapshot", true);
+        bool fullSnapshotLoaded = false;
+        bool baseSnapshotLoaded = false;
+        int  snapshotStage      = loadGraph.addStage(
+            STR("STR_LOADING_SNAPSHOT"),
+            [&]() -> bool {
+                if (useSnapshot) {
+                    auto setTextFunc = [&](const QString &s) -> void {
+                        setStageText(snapshotStage,
+                                     STR("STR_LOADING_SNAPSHOT") + "\n" + s);
+                    };
+                    fullSnapshotLoaded = this->loadSnapshot(
+                        SnapshotType::Full, objects, setTextFunc);
+                    if (! fullSnapshotLoaded) {
+                        baseSnapshotLoaded = this->loadSnapshot(
+                            SnapshotType::Base, objects, setTextFunc);
+                    }
+                }
+                return true;
+            },
+            {vfsStage});
 
         // Load text
-        ::std::shared_ptr<GameTexts> texts
-            = GameTexts::load(vfs, [&](const QString &s) -> void {
-                  splash->setText(STR("STR_LOADING_TEXTS") + "\n" + s);
-              });
-
-        if (texts == nullptr) {
-            splash->callFunc(::std::function<void()>([&]() -> void {
-                QMessageBox::critical(splash, STR("STR_ERROR"),
-                                      STR("STR_FAILED_LOAD_STRINGS"));
-            }));
-            Config::instance()->setString("/gamePath", "");
-            continue;
-        }
+        int textsStage = loadGraph.addStage(
+            STR("STR_LOADING_TEXTS"),
+            [&]() -> bool {
+                if (fullSnapshotLoaded || baseSnapshotLoaded) {
+                    return true;
+                }
+                objects.texts = GameTexts::load(
+                    objects.vfs, [&](const QString &s) -> void {
+                        setStageText(textsStage,
+                                     STR("STR_LOADING_TEXTS") + "\n" + s);
+                    });
+                return objects.texts != nullptr;
+            },
+            {vfsStage, snapshotStage});
+        failedMessages[textsStage] = STR("STR_FAILED_LOAD_STRINGS");
 
         // Load game macros
-        ::std::shared_ptr<GameMacros> macros
-            = GameMacros::load(vfs, [&](const QString &s) -> void {
-                  splash->setText(s);
-              });
-
-        if (macros == nullptr) {
-            splash->callFunc(::std::function<void()>([&]() -> void {
-                QMessageBox::critical(splash, STR("STR_ERROR"),
-                                      STR("STR_FAILED_LOAD_MACROS"));
-            }));
-            Config::instance()->setString("/gamePath", "");
-            continue;
-        }
+        int macrosStage = loadGraph.addStage(
+            STR("STR_LOADING_MACROS"),
+            [&]() -> bool {
+                if (fullSnapshotLoaded || baseSnapshotLoaded) {
+                    return true;
+                }
+                objects.macros = GameMacros::load(
+                    objects.vfs, [&](const QString &s) -> void {
+                        setStageText(macrosStage, s);
+                    });
+                return objects.macros != nullptr;
+            },
+            {vfsStage, snapshotStage});
+        failedMessages[macrosStage] = STR("STR_FAILED_LOAD_MACROS");
 
         // Load game components
-        ::std::shared_ptr<GameComponents> components
-            = GameComponents::load(vfs, [&](const QString &s) -> void {
-                  splash->setText(s);
-              });
-
-        if (components == nullptr) {
-            splash->callFunc(::std::function<void()>([&]() -> void {
-                QMessageBox::critical(splash, STR("STR_ERROR"),
-                                      STR("STR_FAILED_LOAD_COMPONENTS"));
-            }));
-            Config::instance()->setString("/gamePath", "");
-            continue;
-        }
+        int componentsStage = loadGraph.addStage(
+            STR("STR_LOADING_COMPONENTS"),
+            [&]() -> bool {
+                if (fullSnapshotLoaded || baseSnapshotLoaded) {
+                    return true;
+                }
+                objects.components = GameComponents::load(
+                    objects.vfs, [&](const QString &s) -> void {
+                        setStageText(componentsStage, s);
+                    });
+                return objects.components != nullptr;
+            },
+            {vfsStage, snapshotStage});
+        failedMessages[componentsStage] = STR("STR_FAILED_LOAD_COMPONENTS");
 
         // Load game races
-        ::std::shared_ptr<GameRaces> races
-            = GameRaces::load(vfs, texts, [&](const QString &s) -> void {
-                  splash->setText(s);
-              });
-
-        if (races == nullptr) {
-            splash->callFunc(::std::function<void()>([&]() -> void {
-                QMessageBox::critical(splash, STR("STR_ERROR"),
-                                      STR("STR_FAILED_LOAD_RACES"));
-            }));
-            Config::instance()->setString("/gamePath", "");
-            continue;
-        }
+        int racesStage = loadGraph.addStage(
+            STR("STR_LOADING_RACES"),
+            [&]() -> bool {
+                if (fullSnapshotLoaded || baseSnapshotLoaded) {
+                    return true;
+                }
+                objects.races = GameRaces::load(
+                    objects.vfs, objects.texts, [&](const QString &s) -> void {
+                        setStageText(racesStage, s);
+                    });
+                return objects.races != nullptr;
+            },
+            {vfsStage, textsStage});
+        failedMessages[racesStage] = STR("STR_FAILED_LOAD_RACES");
 
         // Load game wares
-        ::std::shared_ptr<GameWares> wares
-            = GameWares::load(vfs, texts, [&](const QString &s) -> void {
-                  splash->setText(s);
-              });
-
-        if (wares == nullptr) {
-            splash->callFunc(::std::function<void()>([&]() -> void {
-                QMessageBox::critical(splash, STR("STR_ERROR"),
-                                      STR("STR_FAILED_LOAD_WARES"));
-            }));
-            Config::instance()->setString("/gamePath", "");
-            continue;
-        }
+        int waresStage = loadGraph.addStage(
+            STR("STR_LOADING_WARES"),
+            [&]() -> bool {
+                if (fullSnapshotLoaded || baseSnapshotLoaded) {
+                    return true;
+                }
+                objects.wares = GameWares::load(
+                    objects.vfs, objects.texts, [&](const QString &s) -> void {
+                        setStageText(waresStage, s);
+                    });
+                return objects.wares != nullptr;
+            },
+            {vfsStage, textsStage});
+        failedMessages[waresStage] = STR("STR_FAILED_LOAD_WARES");
+
+        // Load extensions, the snapshot of the base game is saved before.
+        // Changes are not tracked per extension, all extensions are applied
+        // on the base game in load order, so the result is the same as a
+        // full load even if extensions have been removed or reordered.
+        int extensionsStage = loadGraph.addStage(
+            STR("STR_LOADING_EXTENSIONS"),
+            [&]() -> bool {
+                if (fullSnapshotLoaded) {
+                    return true;
+                }
+                if (useSnapshot && ! baseSnapshotLoaded) {
+                    this->saveSnapshot(SnapshotType::Base, objects);
+                }
+                return objects.texts->applyExtensions(
+                           [&](const QString &s) -> void {
+                               setStageText(extensionsStage,
+                                            STR("STR_LOADING_EXTENSIONS") + "\n"
+                                                + s);
+                           })
+                       && objects.macros->applyExtensions(objects.vfs)
+                       && objects.components->applyExtensions(objects.vfs)
+                       && objects.wares->applyExtensions(objects.vfs,
+                                                         objects.texts);
+            },
+            {textsStage, macrosStage, componentsStage, racesStage,
+             waresStage});
+        failedMessages[extensionsStage] = STR("STR_FAILED_LOAD_EXTENSIONS");
 
         // Load station modules
-        ::std::shared_ptr<GameStationModules> stationModules
-            = GameStationModules::load(vfs, macros, texts, wares, components,
-                                       [&](const QString &s) -> void {
-                                           splash->setText(s);
-                                       });
+        int stationModulesStage = loadGraph.addStage(
+            STR("STR_LOADING_STATION_MODULES"),
+            [&]() -> bool {
+                if (fullSnapshotLoaded) {
+                    return true;
+                }
+                objects.stationModules = GameStationModules::load(
+                    objects.vfs, objects.macros, objects.texts, objects.wares,
+                    objects.components, [&](const QString &s) -> void {
+                        setStageText(stationModulesStage, s);
+                    });
+                return objects.stationModules != nullptr;
+            },
+            {extensionsStage});
+        failedMessages[stationModulesStage]
+            = STR("STR_FAILED_LOAD_STATION_MODULES");
 
-        if (stationModules == nullptr) {
-            splash->callFunc(::std::function<void()>([&]() -> void {
-                QMessageBox::critical(splash, STR("STR_ERROR"),
-                                      STR("STR_FAILED_LOAD_STATION_MODULES"));
-            }));
+        // Run stages.
+        for (int i = 0; i < stationModulesStage + 1; ++i) {
+            stageTexts.append("");
+        }
+        if (! loadGraph.run(
+                ! Config::instance()->getBool("/parallelLoading", true))) {
+            // Show the first error, errors of vfs have been shown.
+            for (auto iter = failedMessages.begin();
+                 iter != failedMessages.end(); ++iter) {
+                if (loadGraph.status(iter.key())
+                    == TaskGraph::StageStatus::Failed) {
+                    splash->callFunc(::std::function<void()>([&]() -> void {
+                        QMessageBox::critical(splash, STR("STR_ERROR"),
+                                              iter.value());
+                    }));
+                    break;
+                }
+            }
             Config::instance()->setString("/gamePath", "");
             continue;
         }
 
         // Set value
-        m_vfs            = vfs;
-        m_texts          = texts;
-        m_macros         = macros;
-        m_components     = components;
-        m_races          = races;
-        m_wares          = wares;
-        m_stationModules = stationModules;
+        m_vfs            = objects.vfs;
+        m_texts          = objects.texts;
+        m_macros         = objects.macros;
+        m_components     = objects.components;
+        m_races          = objects.races;
+        m_wares          = objects.wares;
+        m_stationModules = objects.stationModules;
+        if (useSnapshot && ! fullSnapshotLoaded) {
+            this->saveSnapshot(SnapshotType::Full, objects);
+        }
+
+        // Save hashes verified while loading.
+        m_vfs->saveHashCache();
 
         break;
     }
@@ -295,6 +441,188 @@ bool GameData::checkGamePath(const QString &                      path,
     return true;
 }
 
+/**
+ * @brief		Get path of snapshot file.
+ */
+QString GameData::snapshotPath(SnapshotType type)
+{
+    return QDir(Global::instance()->cacheDir())
+        .absoluteFilePath(type == SnapshotType::Full
+                              ? "game_data.snapshot"
+                              : "game_data_base.snapshot");
+}
+
+/**
+ * @brief		Load game data from snapshot.
+ */
+bool GameData::loadSnapshot(SnapshotType                           type,
+                            Objects &                              objects,
+                            ::std::function<void(const QString &)> setTextFunc)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(this->snapshotPath(type));
+    if (! file.open(QIODevice::OpenModeFlag::ReadOnly
+                    | QIODevice::OpenModeFlag::ExistingOnly)) {
+        qDebug() << "Snapshot does not exist :" << file.fileName() << ".";
+        return false;
+    }
+
+    // Map file.
+    qint64 fileSize = file.size();
+    uchar *data     = file.map(0, fileSize);
+    if (data == nullptr) {
+        qDebug() << "Failed to map snapshot :" << file.fileName() << ".";
+        return false;
+    }
+    AutoRelease<uchar *> unmapper(data, [&file](uchar *&data) -> void {
+        file.unmap(data);
+    });
+
+    QByteArray  buffer = QByteArray::fromRawData((const char *)data, fileSize);
+    QDataStream stream(buffer);
+    stream.setVersion(QDataStream::Version::Qt_5_14);
+
+    // Check header.
+    char magic[sizeof(_snapshotMagic)];
+    if (stream.readRawData(magic, sizeof(magic)) != sizeof(magic)
+        || ::memcmp(magic, _snapshotMagic, sizeof(magic)) != 0) {
+        qDebug() << "Illegal snapshot :" << file.fileName() << ".";
+        return false;
+    }
+
+    quint32    version;
+    QByteArray fingerprint;
+    QByteArray checksum;
+    stream >> version >> fingerprint >> checksum;
+    if (stream.status() != QDataStream::Status::Ok
+        || version != _snapshotVersion) {
+        qDebug() << "Version of snapshot mismatch :" << file.fileName()
+                 << ".";
+        return false;
+    }
+    if (fingerprint
+        != (type == SnapshotType::Full ? objects.vfs->fingerprint()
+                                       : objects.vfs->baseFingerprint())) {
+        qDebug() << "Snapshot is outdated :" << file.fileName() << ".";
+        return false;
+    }
+
+    // Check checksum of game data.
+    qint64             offset = stream.device()->pos();
+    QCryptographicHash hash(QCryptographicHash::Algorithm::Md5);
+    hash.addData((const char *)data + offset, (int)(fileSize - offset));
+    if (hash.result() != checksum) {
+        qDebug() << "Snapshot is broken :" << file.fileName() << ".";
+        return false;
+    }
+
+    // Load game data.
+    ::std::shared_ptr<GameTexts> texts
+        = GameTexts::loadSnapshot(objects.vfs, stream, setTextFunc);
+    if (texts == nullptr) {
+        qDebug() << "Illegal snapshot :" << file.fileName() << ".";
+        return false;
+    }
+    ::std::shared_ptr<GameMacros> macros = GameMacros::loadSnapshot(stream);
+    if (macros == nullptr) {
+        qDebug() << "Illegal snapshot :" << file.fileName() << ".";
+        return false;
+    }
+    ::std::shared_ptr<GameComponents> components
+        = GameComponents::loadSnapshot(stream);
+    if (components == nullptr) {
+        qDebug() << "Illegal snapshot :" << file.fileName() << ".";
+        return false;
+    }
+    ::std::shared_ptr<GameRaces> races = GameRaces::loadSnapshot(stream);
+    if (races == nullptr) {
+        qDebug() << "Illegal snapshot :" << file.fileName() << ".";
+        return false;
+    }
+    ::std::shared_ptr<GameWares> wares = GameWares::loadSnapshot(stream);
+    if (wares == nullptr) {
+        qDebug() << "Illegal snapshot :" << file.fileName() << ".";
+        return false;
+    }
+    ::std::shared_ptr<GameStationModules> stationModules;
+    if (type == SnapshotType::Full) {
+        stationModules
+            = GameStationModules::loadSnapshot(stream, texts, wares);
+        if (stationModules == nullptr) {
+            qDebug() << "Illegal snapshot :" << file.fileName() << ".";
+            return false;
+        }
+    }
+    if (! stream.atEnd()) {
+        qDebug() << "Illegal snapshot :" << file.fileName() << ".";
+        return false;
+    }
+
+    objects.texts          = texts;
+    objects.macros         = macros;
+    objects.components     = components;
+    objects.races          = races;
+    objects.wares          = wares;
+    objects.stationModules = stationModules;
+    qDebug() << "Snapshot loaded :" << file.fileName() << "," << fileSize
+             << "bytes in" << timer.elapsed() << "ms.";
+
+    return true;
+}
+
+/**
+ * @brief		Save game data to snapshot.
+ */
+void GameData::saveSnapshot(SnapshotType type, const Objects &objects)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Game data.
+    QByteArray  payload;
+    QDataStream payloadStream(&payload, QIODevice::OpenModeFlag::WriteOnly);
+    payloadStream.setVersion(QDataStream::Version::Qt_5_14);
+    objects.texts->saveSnapshot(payloadStream);
+    objects.macros->saveSnapshot(payloadStream);
+    objects.components->saveSnapshot(payloadStream);
+    objects.races->saveSnapshot(payloadStream);
+    objects.wares->saveSnapshot(payloadStream);
+    if (type == SnapshotType::Full) {
+        objects.stationModules->saveSnapshot(payloadStream);
+    }
+    if (payloadStream.status() != QDataStream::Status::Ok) {
+        qWarning() << "Failed to serialize game data.";
+        return;
+    }
+
+    QSaveFile file(this->snapshotPath(type));
+    if (! file.open(QIODevice::OpenModeFlag::WriteOnly)) {
+        qWarning() << "Failed to open file :" << file.fileName() << ".";
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Version::Qt_5_14);
+
+    // Header.
+    stream.writeRawData(_snapshotMagic, sizeof(_snapshotMagic));
+    stream << _snapshotVersion
+           << (type == SnapshotType::Full ? objects.vfs->fingerprint()
+                                          : objects.vfs->baseFingerprint())
+           << QCryptographicHash::hash(payload,
+                                       QCryptographicHash::Algorithm::Md5);
+    stream.writeRawData(payload.constData(), payload.size());
+
+    if (stream.status() != QDataStream::Status::Ok || ! file.commit()) {
+        qWarning() << "Failed to write snapshot :" << file.fileName() << ".";
+        return;
+    }
+    qDebug() << "Snapshot saved :" << file.fileName() << "," << payload.size()
+             << "bytes in" << timer.elapsed() << "ms.";
+}
+
 /**
  * @brief		Ask game path.
  */
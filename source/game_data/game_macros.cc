@@ -1,4 +1,5 @@
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QRegExp>
@@ -8,7 +9,7 @@
 #include <locale/string_table.h>
 
 /**
- * @brief		Constructor.
+ * @brief		Constructor, load the macros of the base game.
  */
 GameMacros::GameMacros(::std::shared_ptr<GameVFS>             vfs,
                        ::std::function<void(const QString &)> setTextFunc)
@@ -22,45 +23,84 @@ GameMacros::GameMacros(::std::shared_ptr<GameVFS>             vfs,
     if (file == nullptr) {
         return;
     }
-    QByteArray       data = file->readAll();
-    QXmlStreamReader reader(data);
+    QElapsedTimer timer;
+    timer.start();
 
     // Parse file
-    auto context = XMLLoader::Context::create();
-    context->setOnStartElement(
-        ::std::bind(&GameMacros::onStartElementInRoot, this,
-                    ::std::placeholders::_1, ::std::placeholders::_2,
-                    ::std::placeholders::_3, ::std::placeholders::_4));
-    XMLLoader loader;
-    loader.parse(reader, ::std::move(context));
-
-    // Parse extension files
+    this->parseIndex(file->readAll());
+    qDebug() << m_macros.size() << "macros of the base game indexed in"
+             << timer.elapsed() << "ms.";
+
+    this->setInitialized();
+}
+
+/**
+ * @brief		Constructor, load macros from snapshot.
+ */
+GameMacros::GameMacros(QDataStream &stream)
+{
+    stream >> m_macros;
+    if (stream.status() != QDataStream::Status::Ok) {
+        return;
+    }
+    qDebug() << m_macros.size() << "macros loaded from snapshot.";
+
+    this->setInitialized();
+}
+
+/**
+ * @brief		Load macros from snapshot.
+ */
+::std::shared_ptr<GameMacros> GameMacros::loadSnapshot(QDataStream &stream)
+{
+    ::std::shared_ptr<GameMacros> ret(new GameMacros(stream));
+
+    if (ret == nullptr || ! ret->initialized()) {
+        return nullptr;
+    } else {
+        return ret;
+    }
+}
+
+/**
+ * @brief		Save macros to snapshot.
+ */
+void GameMacros::saveSnapshot(QDataStream &stream)
+{
+    stream << m_macros;
+}
+
+/**
+ * @brief		Load the macros of extensions.
+ */
+bool GameMacros::applyExtensions(::std::shared_ptr<GameVFS> vfs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
     ::std::shared_ptr<::GameVFS::DirReader> extensionsDir
         = vfs->openDir("/extensions");
     if (extensionsDir != nullptr) {
         for (auto iter = extensionsDir->begin(); iter != extensionsDir->end();
              ++iter) {
             if (iter->type == ::GameVFS::DirReader::EntryType::Directory) {
-                file = vfs->open(
+                ::std::shared_ptr<GameVFS::FileReader> file = vfs->open(
                     QString("/extensions/%1/index/macros.xml").arg(iter->name));
                 if (file == nullptr) {
                     continue;
                 }
-                data = file->readAll();
-                QXmlStreamReader waresReader(data);
-
-                // Parse ware file
-                context = XMLLoader::Context::create();
-                context->setOnStartElement(::std::bind(
-                    &GameMacros::onStartElementInRoot, this,
-                    ::std::placeholders::_1, ::std::placeholders::_2,
-                    ::std::placeholders::_3, ::std::placeholders::_4));
-                loader.parse(waresReader, ::std::move(context));
+                if (! this->parseIndex(file->readAll())) {
+                    qWarning() << "Failed to parse index file of extension"
+                               << iter->name << ".";
+                    return false;
+                }
             }
         }
     }
+    qDebug() << "Index files of extensions loaded in" << timer.elapsed()
+             << "ms," << m_macros.size() << "macros indexed.";
 
-    this->setInitialized();
+    return true;
 }
 
 /**
@@ -68,7 +108,7 @@ GameMacros::GameMacros(::std::shared_ptr<GameVFS>             vfs,
  */
 QString GameMacros::macro(const QString &id)
 {
-    return m_macros[id];
+    return m_macros.value(id);
 }
 
 /**
@@ -77,50 +117,17 @@ QString GameMacros::macro(const QString &id)
 GameMacros::~GameMacros() {}
 
 /**
- * @brief		Start element callback in root.
+ * @brief		Parse index file.
  */
-bool GameMacros::onStartElementInRoot(XMLLoader &                   loader,
-                                      XMLLoader::Context &          context,
-                                      const QString &               name,
-                                      const QMap<QString, QString> &attr)
+bool GameMacros::parseIndex(const QByteArray &data)
 {
-    UNREFERENCED_PARAMETER(context);
-    UNREFERENCED_PARAMETER(attr);
-    if (name == "index") {
-        auto context = XMLLoader::Context::create();
-        context->setOnStartElement(
-            ::std::bind(&GameMacros::onStartElementInIndex, this,
-                        ::std::placeholders::_1, ::std::placeholders::_2,
-                        ::std::placeholders::_3, ::std::placeholders::_4));
-        loader.pushContext(::std::move(context));
-    } else {
-        loader.pushContext(XMLLoader::Context::create());
-    }
-    return true;
-}
-
-/**
- * @brief		Start element callback in index.
- */
-bool GameMacros::onStartElementInIndex(XMLLoader &                   loader,
-                                       XMLLoader::Context &          context,
-                                       const QString &               name,
-                                       const QMap<QString, QString> &attr)
-{
-    UNREFERENCED_PARAMETER(context);
-    if (name == "entry") {
-        auto nameIter  = attr.find("name");
-        auto valueIter = attr.find("value");
-        if (nameIter != attr.end() && valueIter != attr.end()) {
-            QString name  = nameIter.value();
+    QXmlStreamReader reader(data);
+    return XMLSchema<_indexSchema>::parse(
+        reader, [this](const XMLSchema<_indexSchema>::Values &values) {
+            QString name  = values[0].toString();
             QString value = "/";
-            value.append(valueIter.value());
+            value.append(values[1]);
             value.replace('\\', '/');
             m_macros[name] = value;
-            qDebug() << "Macro " << name << "=" << value << ".";
-        }
-    }
-
-    loader.pushContext(XMLLoader::Context::create());
-    return true;
+        });
 }
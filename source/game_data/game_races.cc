@@ -47,6 +47,51 @@ GameRaces::GameRaces(::std::shared_ptr<GameVFS>             vfs,
     this->setInitialized();
 }
 
+/**
+ * @brief		Constructor, load races from snapshot.
+ */
+GameRaces::GameRaces(QDataStream &stream)
+{
+    quint32 count;
+    stream >> count;
+    for (quint32 i = 0; i < count; ++i) {
+        Race race;
+        stream >> race.id >> race.name >> race.description;
+        if (stream.status() != QDataStream::Status::Ok) {
+            return;
+        }
+        m_races[race.id] = race;
+    }
+    qDebug() << m_races.size() << "races loaded from snapshot.";
+
+    this->setInitialized();
+}
+
+/**
+ * @brief		Load races from snapshot.
+ */
+::std::shared_ptr<GameRaces> GameRaces::loadSnapshot(QDataStream &stream)
+{
+    ::std::shared_ptr<GameRaces> ret(new GameRaces(stream));
+
+    if (ret == nullptr || ! ret->initialized()) {
+        return nullptr;
+    } else {
+        return ret;
+    }
+}
+
+/**
+ * @brief		Save races to snapshot.
+ */
+void GameRaces::saveSnapshot(QDataStream &stream)
+{
+    stream << (quint32)(m_races.size());
+    for (const Race &race : m_races) {
+        stream << race.id << race.name << race.description;
+    }
+}
+
 /**
  * @brief	Get race information.
  */
@@ -74,7 +119,7 @@ GameRaces::~GameRaces() {}
 bool GameRaces::onStartElementInRoot(XMLLoader &loader,
                                      XMLLoader::Context &,
                                      const QString &name,
-                                     const QMap<QString, QString> &)
+                                     const XMLLoader::Attributes &)
 {
     if (name == "races") {
         auto context = XMLLoader::Context::create();
@@ -84,7 +129,7 @@ bool GameRaces::onStartElementInRoot(XMLLoader &loader,
                         ::std::placeholders::_3, ::std::placeholders::_4));
         loader.pushContext(::std::move(context));
     } else {
-        loader.pushContext(XMLLoader::Context::create());
+        loader.skipElement();
     }
     return true;
 }
@@ -94,8 +139,8 @@ bool GameRaces::onStartElementInRoot(XMLLoader &loader,
  */
 bool GameRaces::onStartElementInRaces(XMLLoader &loader,
                                       XMLLoader::Context &,
-                                      const QString &               name,
-                                      const QMap<QString, QString> &attr)
+                                      const QString &              name,
+                                      const XMLLoader::Attributes &attr)
 {
     ::std::shared_ptr<GameTexts> texts
         = ::std::any_cast<::std::shared_ptr<GameTexts>>(loader["texts"]);
@@ -118,6 +163,6 @@ bool GameRaces::onStartElementInRaces(XMLLoader &loader,
                         .toStdString()
                         .c_str();
     }
-    loader.pushContext(XMLLoader::Context::create());
+    loader.skipElement();
     return true;
 }
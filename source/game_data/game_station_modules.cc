@@ -1,6 +1,9 @@
 #include <cmath>
 
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QRegExp>
 #include <QtCore/QSet>
 
@@ -64,8 +67,7 @@ GameStationModules::GameStationModules(
     // Parse xml
     QXmlStreamReader                      reader(fileReader->readAll());
     XMLLoader                             loader;
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
     context->setOnStartElement(
         ::std::bind(&GameStationModules::onStartElementInRootOfModuleGroups,
                     this, ::std::placeholders::_1, ::std::placeholders::_2,
@@ -95,7 +97,7 @@ GameStationModules::GameStationModules(
 
                 // Parse file
                 ::std::unique_ptr<XMLLoader::Context> context
-                    = XMLLoader::Context::create();
+                    = loader.createContext();
                 context->setOnStartElement(::std::bind(
                     &GameStationModules::onStartElementInRootOfModuleGroups,
                     this, ::std::placeholders::_1, ::std::placeholders::_2,
@@ -105,10 +107,145 @@ GameStationModules::GameStationModules(
         }
     }
 
+    // Load macros.
+    QVector<QVector<::std::shared_ptr<StationModule>>> loadedModules(
+        m_moduleMacroTmpList.size());
+    QVector<QStringList> unknowWares(m_moduleMacroTmpList.size());
+    QElapsedTimer timer;
+    timer.start();
+    {
+        QMutex   indexLock;
+        int      index = 0;
+        MultiRun multiRun(::std::function<void()>([&]() -> void {
+            while (true) {
+                int current;
+                {
+                    QMutexLocker locker(&indexLock);
+                    if (index >= m_moduleMacroTmpList.size()) {
+                        return;
+                    }
+                    current = index;
+                    ++index;
+                }
+                this->loadMacro(m_moduleMacroTmpList[current],
+                                loadedModules[current], unknowWares[current],
+                                vfs, macros, texts, wares, components);
+            }
+        }));
+        multiRun.run();
+    }
+    qDebug() << m_moduleMacroTmpList.size() << "station module macros loaded in"
+             << timer.elapsed() << "ms.";
+
+    // Merge modules in the order of module groups, the placeholders of
+    // unknow wares are generated in the same order.
+    for (int i = 0; i < loadedModules.size(); ++i) {
+        for (auto &id : unknowWares[i]) {
+            wares->ware(id, texts);
+        }
+        for (auto &module : loadedModules[i]) {
+            this->mergeModule(module, texts);
+        }
+    }
+
+    m_moduleMacroTmpList.clear();
     m_componentTmpIndex.clear();
+    this->buildTable(texts, wares);
     this->setInitialized();
 }
 
+/**
+ * @brief		Constructor, load station modules from snapshot.
+ */
+GameStationModules::GameStationModules(QDataStream &                stream,
+                                       ::std::shared_ptr<GameTexts> texts,
+                                       ::std::shared_ptr<GameWares> wares)
+{
+    quint32 moduleCount;
+    stream >> moduleCount;
+    for (quint32 i = 0; i < moduleCount; ++i) {
+        ::std::shared_ptr<StationModule> module(new StationModule());
+        qint32                           moduleClass;
+        quint32                          propertyCount;
+        stream >> module->macro >> module->component >> module->name
+            >> moduleClass >> module->playerModule >> module->description
+            >> module->racialLimited >> module->races >> module->hull
+            >> module->explosiondamage >> propertyCount;
+        if (stream.status() != QDataStream::Status::Ok) {
+            return;
+        }
+        module->moduleClass = (StationModule::StationModuleClass)moduleClass;
+        for (quint32 j = 0; j < propertyCount; ++j) {
+            ::std::shared_ptr<Property> property
+                = GameStationModules::readProperty(stream);
+            if (property == nullptr) {
+                return;
+            }
+            module->properties[property->type] = property;
+        }
+        m_modulesIndex[module->macro] = module;
+        m_modules.push_back(module);
+    }
+    qDebug() << m_modules.size() << "station modules loaded from snapshot.";
+
+    this->buildTable(texts, wares);
+    this->setInitialized();
+}
+
+/**
+ * @brief		Load station modules from snapshot.
+ */
+::std::shared_ptr<GameStationModules>
+    GameStationModules::loadSnapshot(QDataStream &                stream,
+                                     ::std::shared_ptr<GameTexts> texts,
+                                     ::std::shared_ptr<GameWares> wares)
+{
+    ::std::shared_ptr<GameStationModules> ret(
+        new GameStationModules(stream, texts, wares));
+
+    if (ret == nullptr || ! ret->initialized()) {
+        return nullptr;
+    } else {
+        return ret;
+    }
+}
+
+/**
+ * @brief		Save station modules to snapshot.
+ */
+void GameStationModules::saveSnapshot(QDataStream &stream)
+{
+    stream << (quint32)(m_modules.size());
+    for (auto &module : m_modules) {
+        stream << module->macro << module->component << module->name
+               << (qint32)(module->moduleClass) << module->playerModule
+               << module->description << module->racialLimited
+               << module->races << module->hull << module->explosiondamage;
+
+        // The numeric-only properties are in the module table, they are
+        // written in the same format as the properties in the map.
+        QVector<Property::Type> tableProperties;
+        for (quint32 type = 0; type <= Property::Type::Cargo; ++type) {
+            Column column;
+            if (GameStationModules::tableColumn((Property::Type)type, column)
+                && m_table.hasProperty(module->ordinal,
+                                       (Property::Type)type)) {
+                tableProperties.push_back((Property::Type)type);
+            }
+        }
+        stream << (quint32)(module->properties.size()
+                            + tableProperties.size());
+        for (Property::Type type : tableProperties) {
+            Column column;
+            GameStationModules::tableColumn(type, column);
+            stream << (qint32)type << m_table.value(module->ordinal, column);
+        }
+        for (auto &property : module->properties) {
+            GameStationModules::writeProperty(stream, *property);
+        }
+    }
+}
+
 /**
  * @brief		Get modules.
  *
@@ -136,6 +273,35 @@ const QVector<::std::shared_ptr<GameStationModules::StationModule>> &
     }
 }
 
+/**
+ * @brief		Get module table.
+ *
+ * @return		Module table.
+ */
+const GameStationModules::ModuleTable &GameStationModules::table() const
+{
+    return m_table;
+}
+
+/**
+ * @brief		Sum all columns weighted by amounts of modules.
+ */
+void GameStationModules::ModuleTable::sum(const QVector<quint64> &amounts,
+                                          ColumnValues &totals) const
+{
+    Q_ASSERT(amounts.size() == this->size());
+    const quint64 *amountData = amounts.constData();
+    int            count      = this->size();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const quint64 *values = columns[i].constData();
+        quint64        total  = 0;
+        for (int j = 0; j < count; ++j) {
+            total += values[j] * amountData[j];
+        }
+        totals[i] = total;
+    }
+}
+
 /**
  * @brief		Destructor.
  */
@@ -148,10 +314,9 @@ bool GameStationModules::onStartElementInGroupsOfModuleGroups(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &)
+    const XMLLoader::Attributes &)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
     if (name == "group") {
         context->setOnStartElement(::std::bind(
             &GameStationModules::onStartElementInGroupOfModuleGroups, this,
@@ -169,10 +334,9 @@ bool GameStationModules::onStartElementInRootOfModuleGroups(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &)
+    const XMLLoader::Attributes &)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
     if (name == "groups") {
         context->setOnStartElement(::std::bind(
             &GameStationModules::onStartElementInGroupsOfModuleGroups, this,
@@ -189,44 +353,32 @@ bool GameStationModules::onStartElementInRootOfModuleGroups(
 bool GameStationModules::onStartElementInGroupOfModuleGroups(
     XMLLoader &loader,
     XMLLoader::Context &,
-    const QString &               name,
-    const QMap<QString, QString> &attr)
+    const QString &              name,
+    const XMLLoader::Attributes &attr)
 {
-    ::std::shared_ptr<GameVFS> vfs
-        = ::std::any_cast<::std::shared_ptr<GameVFS>>(loader["vfs"]);
-    ::std::shared_ptr<GameMacros> macros
-        = ::std::any_cast<::std::shared_ptr<GameMacros>>(loader["macros"]);
-    ::std::shared_ptr<GameTexts> texts
-        = ::std::any_cast<::std::shared_ptr<GameTexts>>(loader["texts"]);
-    ::std::shared_ptr<GameWares> wares
-        = ::std::any_cast<::std::shared_ptr<GameWares>>(loader["wares"]);
-    ::std::shared_ptr<GameComponents> components
-        = ::std::any_cast<::std::shared_ptr<GameComponents>>(
-            loader["components"]);
     if (name == "select") {
         auto iter = attr.find("macro");
-        if (iter != attr.end()) {
-            this->loadMacro(*iter, vfs, macros, texts, wares, components);
+        if (iter != attr.end() && ! m_moduleMacroTmpList.contains(*iter)) {
+            m_moduleMacroTmpList.append(*iter);
         }
     }
-    loader.pushContext(XMLLoader::Context::create());
+    loader.skipElement();
     return true;
 }
 
 /**
  * @brief		Load macro.
  */
-void GameStationModules::loadMacro(const QString &                   macro,
-                                   ::std::shared_ptr<GameVFS>        vfs,
-                                   ::std::shared_ptr<GameMacros>     macros,
-                                   ::std::shared_ptr<GameTexts>      texts,
-                                   ::std::shared_ptr<GameWares>      wares,
-                                   ::std::shared_ptr<GameComponents> components)
+void GameStationModules::loadMacro(
+    const QString &                            macro,
+    QVector<::std::shared_ptr<StationModule>> &modules,
+    QStringList &                              unknowWares,
+    ::std::shared_ptr<GameVFS>                 vfs,
+    ::std::shared_ptr<GameMacros>              macros,
+    ::std::shared_ptr<GameTexts>               texts,
+    ::std::shared_ptr<GameWares>               wares,
+    ::std::shared_ptr<GameComponents>          components)
 {
-    if (m_modulesIndex.find(macro) != m_modulesIndex.end()) {
-        return;
-    }
-
     qDebug() << "Loading station module macro" << macro << "...";
     ::std::shared_ptr<GameVFS::FileReader> file
         = vfs->open(macros->macro(macro) + ".xml");
@@ -236,20 +388,980 @@ void GameStationModules::loadMacro(const QString &                   macro,
 
     QXmlStreamReader                      reader(file->readAll());
     XMLLoader                             loader;
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
     context->setOnStartElement(
         ::std::bind(&GameStationModules::onStartElementInRootOfModuleMacro,
                     this, ::std::placeholders::_1, ::std::placeholders::_2,
                     ::std::placeholders::_3, ::std::placeholders::_4));
-    loader["vfs"]        = vfs;
-    loader["macros"]     = macros;
-    loader["texts"]      = texts;
-    loader["wares"]      = wares;
-    loader["components"] = components;
+    loader["vfs"]         = vfs;
+    loader["macros"]      = macros;
+    loader["texts"]       = texts;
+    loader["wares"]       = wares;
+    loader["components"]  = components;
+    loader["modules"]     = &modules;
+    loader["unknowWares"] = &unknowWares;
     loader.parse(reader, ::std::move(context));
 }
 
+/**
+ * @brief		Find ware when loading macro.
+ */
+::std::shared_ptr<GameWares::Ware>
+    GameStationModules::findWare(XMLLoader &loader, const QString &id)
+{
+    ::std::shared_ptr<GameWares> wares
+        = ::std::any_cast<::std::shared_ptr<GameWares>>(loader["wares"]);
+    ::std::shared_ptr<GameWares::Ware> ware = wares->findWare(id);
+    if (ware == nullptr) {
+        QStringList *unknowWares
+            = ::std::any_cast<QStringList *>(loader["unknowWares"]);
+        if (! unknowWares->contains(id)) {
+            unknowWares->append(id);
+        }
+    }
+
+    return ware;
+}
+
+/**
+ * @brief		Merge loaded module.
+ */
+void GameStationModules::mergeModule(::std::shared_ptr<StationModule> module,
+                                     ::std::shared_ptr<GameTexts>     texts)
+{
+    // Modules share the same component divide races.
+    QVector<::std::shared_ptr<StationModule>> &otherModules
+        = m_componentTmpIndex[module->component];
+    for (auto &otherModule : otherModules) {
+        if (module->racialLimited && (! otherModule->racialLimited)) {
+            for (auto &race : module->races) {
+                auto iter = otherModule->races.find(race);
+                if (iter != otherModule->races.end()) {
+                    otherModule->races.erase(iter);
+                }
+            }
+        }
+        if ((! module->racialLimited) && otherModule->racialLimited) {
+            for (auto &race : otherModule->races) {
+                auto iter = module->races.find(race);
+                if (iter != module->races.end()) {
+                    module->races.erase(iter);
+                }
+            }
+        }
+    }
+    otherModules.push_back(module);
+
+    if (module->playerModule && ! m_modulesIndex.contains(module->macro)) {
+        // Add module.
+        m_modulesIndex[module->macro] = module;
+        m_modules.push_back(module);
+
+        // Print information
+        this->printModule(module, texts);
+    }
+}
+
+/**
+ * @brief		Build module table from loaded modules.
+ */
+void GameStationModules::buildTable(::std::shared_ptr<GameTexts> texts,
+                                    ::std::shared_ptr<GameWares> wares)
+{
+    m_table.masks.fill(0, m_modules.size());
+    for (auto &column : m_table.columns) {
+        column.fill(0, m_modules.size());
+    }
+    m_table.contributions.clear();
+    m_table.contributions.reserve(m_modules.size());
+
+    for (int i = 0; i < m_modules.size(); ++i) {
+        ::std::shared_ptr<StationModule> &module = m_modules[i];
+        module->ordinal                          = i;
+
+        m_table.contributions.push_back(
+            GameStationModules::buildContribution(*module, texts, wares));
+
+        auto setValue = [&](Column column, quint64 value) -> void {
+            m_table.columns[(size_t)column][i] = value;
+        };
+        setValue(Column::Hull, module->hull);
+        setValue(Column::ExplosionDamage, module->explosiondamage);
+
+        for (auto &property : module->properties) {
+            m_table.masks[i] |= (quint32)1 << property->type;
+            switch (property->type) {
+                case Property::Type::MTurret:
+                    setValue(Column::MTurret,
+                             static_cast<HasMTurret &>(*property).count);
+                    break;
+
+                case Property::Type::MShield:
+                    setValue(Column::MShield,
+                             static_cast<HasMShield &>(*property).count);
+                    break;
+
+                case Property::Type::LTurret:
+                    setValue(Column::LTurret,
+                             static_cast<HasLTurret &>(*property).count);
+                    break;
+
+                case Property::Type::LShield:
+                    setValue(Column::LShield,
+                             static_cast<HasLShield &>(*property).count);
+                    break;
+
+                case Property::Type::SDock:
+                    setValue(Column::SDock,
+                             static_cast<HasSDock &>(*property).count);
+                    break;
+
+                case Property::Type::SShipCargo:
+                    setValue(Column::SShipCargo,
+                             static_cast<HasSShipCargo &>(*property).capacity);
+                    break;
+
+                case Property::Type::MDock:
+                    setValue(Column::MDock,
+                             static_cast<HasMDock &>(*property).count);
+                    break;
+
+                case Property::Type::MShipCargo:
+                    setValue(Column::MShipCargo,
+                             static_cast<HasMShipCargo &>(*property).capacity);
+                    break;
+
+                case Property::Type::LDock:
+                    setValue(Column::LDock,
+                             static_cast<HasLDock &>(*property).count);
+                    break;
+
+                case Property::Type::XLDock:
+                    setValue(Column::XLDock,
+                             static_cast<HasXLDock &>(*property).count);
+                    break;
+
+                case Property::Type::LXLDock:
+                    setValue(Column::LXLDock,
+                             static_cast<HasLXLDock &>(*property).count);
+                    break;
+
+                case Property::Type::SLaunchTube:
+                    setValue(Column::SLaunchTube,
+                             static_cast<HasSLaunchTube &>(*property).count);
+                    break;
+
+                case Property::Type::MLaunchTube:
+                    setValue(Column::MLaunchTube,
+                             static_cast<HasMLaunchTube &>(*property).count);
+                    break;
+
+                case Property::Type::SupplyWorkforce:
+                    setValue(
+                        Column::SupplyWorkforce,
+                        static_cast<SupplyWorkforce &>(*property).workforce);
+                    break;
+
+                case Property::Type::RequireWorkforce:
+                    setValue(
+                        Column::RequireWorkforce,
+                        static_cast<RequireWorkforce &>(*property).workforce);
+                    break;
+
+                case Property::Type::SupplyProduct:
+                    // Not numeric.
+                    break;
+
+                case Property::Type::Cargo: {
+                    HasCargo &hasCargo = static_cast<HasCargo &>(*property);
+                    switch (hasCargo.cargoType) {
+                        case GameWares::TransportType::Container:
+                            setValue(Column::ContainerCargo,
+                                     hasCargo.cargoSize);
+                            break;
+
+                        case GameWares::TransportType::Solid:
+                            setValue(Column::SolidCargo, hasCargo.cargoSize);
+                            break;
+
+                        case GameWares::TransportType::Liquid:
+                            setValue(Column::LiquidCargo, hasCargo.cargoSize);
+                            break;
+
+                        default:
+                            break;
+                    }
+                } break;
+            }
+        }
+
+        // The numeric-only properties are only kept in the table.
+        for (auto iter = module->properties.begin();
+             iter != module->properties.end();) {
+            Column column;
+            if (GameStationModules::tableColumn(iter.key(), column)) {
+                iter = module->properties.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+}
+
+/**
+ * @brief		Get the column of a numeric-only property.
+ */
+bool GameStationModules::tableColumn(Property::Type type, Column &column)
+{
+    switch (type) {
+        case Property::Type::MTurret:
+            column = Column::MTurret;
+            return true;
+
+        case Property::Type::MShield:
+            column = Column::MShield;
+            return true;
+
+        case Property::Type::LTurret:
+            column = Column::LTurret;
+            return true;
+
+        case Property::Type::LShield:
+            column = Column::LShield;
+            return true;
+
+        case Property::Type::SDock:
+            column = Column::SDock;
+            return true;
+
+        case Property::Type::SShipCargo:
+            column = Column::SShipCargo;
+            return true;
+
+        case Property::Type::MDock:
+            column = Column::MDock;
+            return true;
+
+        case Property::Type::MShipCargo:
+            column = Column::MShipCargo;
+            return true;
+
+        case Property::Type::LDock:
+            column = Column::LDock;
+            return true;
+
+        case Property::Type::XLDock:
+            column = Column::XLDock;
+            return true;
+
+        case Property::Type::LXLDock:
+            column = Column::LXLDock;
+            return true;
+
+        case Property::Type::SLaunchTube:
+            column = Column::SLaunchTube;
+            return true;
+
+        case Property::Type::MLaunchTube:
+            column = Column::MLaunchTube;
+            return true;
+
+        case Property::Type::RequireWorkforce:
+            column = Column::RequireWorkforce;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief		Build contribution of module.
+ */
+GameStationModules::Contribution
+    GameStationModules::buildContribution(const StationModule &        module,
+                                          ::std::shared_ptr<GameTexts> texts,
+                                          ::std::shared_ptr<GameWares> wares)
+{
+    Contribution ret;
+    ret.storageRequirements = 0;
+
+    // Get ordinal of ware and mark the storage type required by it.
+    auto require = [&](const QString &ware) -> int {
+        switch (wares->ware(ware, texts)->transportType) {
+            case GameWares::TransportType::Container:
+                ret.storageRequirements |= (quint32)1
+                                           << (size_t)Storage::Container;
+                break;
+
+            case GameWares::TransportType::Solid:
+                ret.storageRequirements |= (quint32)1 << (size_t)Storage::Solid;
+                break;
+
+            case GameWares::TransportType::Liquid:
+                ret.storageRequirements |= (quint32)1
+                                           << (size_t)Storage::Liquid;
+                break;
+
+            default:
+                break;
+        }
+
+        return wares->wareOrdinal(ware, texts);
+    };
+
+    // Supply workforce.
+    auto iter = module.properties.find(Property::Type::SupplyWorkforce);
+    if (iter != module.properties.end()) {
+        const SupplyWorkforce &supplyWorkforce
+            = static_cast<const SupplyWorkforce &>(**iter);
+        ::std::shared_ptr<GameWares::ProductionInfo> supplyInfo
+            = supplyWorkforce.supplyInfo;
+        if (supplyInfo != nullptr) {
+            for (auto &resource : supplyInfo->resources) {
+                ret.resources.push_back(
+                    {require(resource->id), 0.0,
+                     ((long double)resource->amount) * supplyWorkforce.workforce
+                         * 3600 / supplyInfo->amount / supplyInfo->time});
+            }
+        }
+    }
+
+    // Supply product.
+    iter = module.properties.find(Property::Type::SupplyProduct);
+    if (iter != module.properties.end()) {
+        ::std::shared_ptr<GameWares::ProductionInfo> productionInfo
+            = static_cast<const SupplyProduct &>(**iter).productionInfo;
+        if (productionInfo != nullptr) {
+            // Product.
+            ret.products.push_back(
+                {require(productionInfo->id),
+                 (long double)(productionInfo->amount) * 3600
+                     / productionInfo->time,
+                 (long double)(productionInfo->amount) * 3600
+                     * (1.0 + productionInfo->workEffect)
+                     / productionInfo->time});
+
+            // Resources.
+            for (auto &resource : productionInfo->resources) {
+                ret.resources.push_back(
+                    {require(resource->id),
+                     (long double)(resource->amount) * 3600
+                         / productionInfo->time,
+                     (long double)(resource->amount) * 3600
+                         * (1.0 + productionInfo->workEffect)
+                         / productionInfo->time});
+            }
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief		Write property to snapshot.
+ */
+void GameStationModules::writeProperty(QDataStream &   stream,
+                                       const Property &property)
+{
+    stream << (qint32)(property.type);
+    switch (property.type) {
+        case Property::Type::MTurret:
+            stream << static_cast<const HasMTurret &>(property).count;
+            break;
+
+        case Property::Type::MShield:
+            stream << static_cast<const HasMShield &>(property).count;
+            break;
+
+        case Property::Type::LTurret:
+            stream << static_cast<const HasLTurret &>(property).count;
+            break;
+
+        case Property::Type::LShield:
+            stream << static_cast<const HasLShield &>(property).count;
+            break;
+
+        case Property::Type::SDock:
+            stream << static_cast<const HasSDock &>(property).count;
+            break;
+
+        case Property::Type::SShipCargo:
+            stream << static_cast<const HasSShipCargo &>(property).capacity;
+            break;
+
+        case Property::Type::MDock:
+            stream << static_cast<const HasMDock &>(property).count;
+            break;
+
+        case Property::Type::MShipCargo:
+            stream << static_cast<const HasMShipCargo &>(property).capacity;
+            break;
+
+        case Property::Type::LDock:
+            stream << static_cast<const HasLDock &>(property).count;
+            break;
+
+        case Property::Type::XLDock:
+            stream << static_cast<const HasXLDock &>(property).count;
+            break;
+
+        case Property::Type::LXLDock:
+            stream << static_cast<const HasLXLDock &>(property).count;
+            break;
+
+        case Property::Type::SLaunchTube:
+            stream << static_cast<const HasSLaunchTube &>(property).count;
+            break;
+
+        case Property::Type::MLaunchTube:
+            stream << static_cast<const HasMLaunchTube &>(property).count;
+            break;
+
+        case Property::Type::SupplyWorkforce: {
+            const SupplyWorkforce &supplyWorkforce
+                = static_cast<const SupplyWorkforce &>(property);
+            stream << supplyWorkforce.workforce
+                   << (supplyWorkforce.supplyInfo != nullptr);
+            if (supplyWorkforce.supplyInfo != nullptr) {
+                GameWares::writeProductionInfo(stream,
+                                               *(supplyWorkforce.supplyInfo));
+            }
+        } break;
+
+        case Property::Type::RequireWorkforce:
+            stream << static_cast<const RequireWorkforce &>(property).workforce;
+            break;
+
+        case Property::Type::SupplyProduct: {
+            const SupplyProduct &supplyProduct
+                = static_cast<const SupplyProduct &>(property);
+            stream << supplyProduct.product
+                   << (supplyProduct.productionInfo != nullptr);
+            if (supplyProduct.productionInfo != nullptr) {
+                GameWares::writeProductionInfo(stream,
+                                               *(supplyProduct.productionInfo));
+            }
+        } break;
+
+        case Property::Type::Cargo: {
+            const HasCargo &hasCargo = static_cast<const HasCargo &>(property);
+            stream << (qint32)(hasCargo.cargoType) << hasCargo.cargoSize;
+        } break;
+    }
+}
+
+/**
+ * @brief		Read property from snapshot.
+ */
+::std::shared_ptr<GameStationModules::Property>
+    GameStationModules::readProperty(QDataStream &stream)
+{
+    qint32                      type;
+    ::std::shared_ptr<Property> property;
+    stream >> type;
+    switch (type) {
+        case Property::Type::MTurret: {
+            ::std::shared_ptr<HasMTurret> ret(new HasMTurret());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::MShield: {
+            ::std::shared_ptr<HasMShield> ret(new HasMShield());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::LTurret: {
+            ::std::shared_ptr<HasLTurret> ret(new HasLTurret());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::LShield: {
+            ::std::shared_ptr<HasLShield> ret(new HasLShield());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::SDock: {
+            ::std::shared_ptr<HasSDock> ret(new HasSDock());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::SShipCargo: {
+            ::std::shared_ptr<HasSShipCargo> ret(new HasSShipCargo());
+            stream >> ret->capacity;
+            property = ret;
+        } break;
+
+        case Property::Type::MDock: {
+            ::std::shared_ptr<HasMDock> ret(new HasMDock());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::MShipCargo: {
+            ::std::shared_ptr<HasMShipCargo> ret(new HasMShipCargo());
+            stream >> ret->capacity;
+            property = ret;
+        } break;
+
+        case Property::Type::LDock: {
+            ::std::shared_ptr<HasLDock> ret(new HasLDock());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::XLDock: {
+            ::std::shared_ptr<HasXLDock> ret(new HasXLDock());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::LXLDock: {
+            ::std::shared_ptr<HasLXLDock> ret(new HasLXLDock());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::SLaunchTube: {
+            ::std::shared_ptr<HasSLaunchTube> ret(new HasSLaunchTube());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::MLaunchTube: {
+            ::std::shared_ptr<HasMLaunchTube> ret(new HasMLaunchTube());
+            stream >> ret->count;
+            property = ret;
+        } break;
+
+        case Property::Type::SupplyWorkforce: {
+            ::std::shared_ptr<SupplyWorkforce> ret(new SupplyWorkforce());
+            bool                               hasInfo;
+            stream >> ret->workforce >> hasInfo;
+            if (hasInfo) {
+                ret->supplyInfo = GameWares::readProductionInfo(stream);
+                if (ret->supplyInfo == nullptr) {
+                    return nullptr;
+                }
+            }
+            property = ret;
+        } break;
+
+        case Property::Type::RequireWorkforce: {
+            ::std::shared_ptr<RequireWorkforce> ret(new RequireWorkforce());
+            stream >> ret->workforce;
+            property = ret;
+        } break;
+
+        case Property::Type::SupplyProduct: {
+            ::std::shared_ptr<SupplyProduct> ret(new SupplyProduct());
+            bool                             hasInfo;
+            stream >> ret->product >> hasInfo;
+            if (hasInfo) {
+                ret->productionInfo = GameWares::readProductionInfo(stream);
+                if (ret->productionInfo == nullptr) {
+                    return nullptr;
+                }
+            }
+            property = ret;
+        } break;
+
+        case Property::Type::Cargo: {
+            ::std::shared_ptr<HasCargo> ret(new HasCargo());
+            qint32                      cargoType;
+            stream >> cargoType >> ret->cargoSize;
+            ret->cargoType = (GameWares::TransportType)cargoType;
+            property       = ret;
+        } break;
+
+        default:
+            qWarning() << "Illegal type of station module property :" << type
+                       << ".";
+            return nullptr;
+    }
+
+    if (stream.status() != QDataStream::Status::Ok) {
+        return nullptr;
+    }
+
+    return property;
+}
+
+/**
+ * @brief		Print module information.
+ */
+void GameStationModules::printModule(::std::shared_ptr<StationModule> module,
+                                     ::std::shared_ptr<GameTexts>     texts)
+{
+    qDebug() << "module :{";
+    qDebug() << "    "
+             << "macro           :" << module->macro;
+    qDebug() << "    "
+             << "component       :" << module->component;
+    qDebug() << "    "
+             << "name            :" << texts->text(module->name);
+    qDebug() << "    "
+             << "description     :" << texts->text(module->description);
+    switch (module->moduleClass) {
+        case StationModule::StationModuleClass::Unknow:
+            qDebug() << "    "
+                     << "class           : "
+                     << "Unknow";
+            break;
+
+        case StationModule::StationModuleClass::BuildModule:
+            qDebug() << "    "
+                     << "class           : "
+                     << "BuildModule";
+            break;
+
+        case StationModule::StationModuleClass::
+            ConnectionModule:
+            qDebug() << "    "
+                     << "class           : "
+                     << "ConnectionModule";
+            break;
+
+        case StationModule::StationModuleClass::
+            DefenceModule:
+            qDebug() << "    "
+                     << "class           : "
+                     << "DefenceModule";
+            break;
+
+        case StationModule::StationModuleClass::Dockarea:
+            qDebug() << "    "
+                     << "class           : "
+                     << "Dockarea";
+            break;
+
+        case StationModule::StationModuleClass::Habitation:
+            qDebug() << "    "
+                     << "class           : "
+                     << "Habitation";
+            break;
+
+        case StationModule::StationModuleClass::Production:
+            qDebug() << "    "
+                     << "class           : "
+                     << "Production";
+            break;
+
+        case StationModule::StationModuleClass::Storage:
+            qDebug() << "    "
+                     << "class           : "
+                     << "Storage";
+            break;
+    }
+    if (module->racialLimited) {
+        qDebug() << "    "
+                 << "races           : " << module->races;
+    } else {
+        qDebug() << "    "
+                 << "races           : "
+                 << "generic";
+    }
+    qDebug() << "    "
+             << "hull            : " << module->hull;
+    qDebug() << "    "
+             << "explosiondamage : " << module->explosiondamage;
+    qDebug() << "    "
+             << "propertues      : {";
+    for (auto &baseProperty : module->properties) {
+        switch (baseProperty->type) {
+            case Property::Type::MTurret: {
+                ::std::shared_ptr<HasMTurret> property
+                    = ::std::static_pointer_cast<HasMTurret>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "m turret           : " << property->count;
+            } break;
+
+            case Property::Type::MShield: {
+                ::std::shared_ptr<HasMShield> property
+                    = ::std::static_pointer_cast<HasMShield>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "m shield           : " << property->count;
+            } break;
+
+            case Property::Type::LTurret: {
+                ::std::shared_ptr<HasLTurret> property
+                    = ::std::static_pointer_cast<HasLTurret>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "l turret           : " << property->count;
+            } break;
+
+            case Property::Type::LShield: {
+                ::std::shared_ptr<HasLShield> property
+                    = ::std::static_pointer_cast<HasLShield>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "l shield           : " << property->count;
+            } break;
+
+            case Property::Type::SDock: {
+                ::std::shared_ptr<HasSDock> property
+                    = ::std::static_pointer_cast<HasSDock>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "s docking bay      : " << property->count;
+            } break;
+
+            case Property::Type::SShipCargo: {
+                ::std::shared_ptr<HasSShipCargo> property
+                    = ::std::static_pointer_cast<HasSShipCargo>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "s ship cargo       : " << property->capacity;
+            } break;
+
+            case Property::Type::MDock: {
+                ::std::shared_ptr<HasMDock> property
+                    = ::std::static_pointer_cast<HasMDock>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "m docking bay      : " << property->count;
+            } break;
+
+            case Property::Type::MShipCargo: {
+                ::std::shared_ptr<HasMShipCargo> property
+                    = ::std::static_pointer_cast<HasMShipCargo>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "m ship cargo       : " << property->capacity;
+            } break;
+
+            case Property::Type::LDock: {
+                ::std::shared_ptr<HasLDock> property
+                    = ::std::static_pointer_cast<HasLDock>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "l docking bay      : " << property->count;
+            } break;
+
+            case Property::Type::XLDock: {
+                ::std::shared_ptr<HasXLDock> property
+                    = ::std::static_pointer_cast<HasXLDock>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "xl docking bay     : " << property->count;
+            } break;
+
+            case Property::Type::LXLDock: {
+                ::std::shared_ptr<HasLXLDock> property
+                    = ::std::static_pointer_cast<HasLXLDock>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "l/xl docking bay   : " << property->count;
+            } break;
+
+            case Property::Type::SLaunchTube: {
+                ::std::shared_ptr<HasSLaunchTube> property
+                    = ::std::static_pointer_cast<HasSLaunchTube>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "s launch tube      : " << property->count;
+            } break;
+
+            case Property::Type::MLaunchTube: {
+                ::std::shared_ptr<HasMLaunchTube> property
+                    = ::std::static_pointer_cast<HasMLaunchTube>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "m launch tube      : " << property->count;
+            } break;
+
+            case Property::Type::SupplyWorkforce: {
+                ::std::shared_ptr<SupplyWorkforce> property
+                    = ::std::static_pointer_cast<SupplyWorkforce>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "supply workforce   : {";
+                qDebug() << "    "
+                         << "    "
+                         << "    "
+                         << "workforce : " << property->workforce;
+                qDebug() << "    "
+                         << "    "
+                         << "    "
+                         << "supplies  : [";
+                for (auto &resource : property->supplyInfo->resources) {
+                    qDebug() << "    "
+                             << "    "
+                             << "    "
+                             << "    "
+                             << "{";
+                    qDebug() << "    "
+                             << "    "
+                             << "    "
+                             << "    "
+                             << "    "
+                             << "id     : " << resource->id;
+                    qDebug()
+                        << "    "
+                        << "    "
+                        << "    "
+                        << "    "
+                        << "    "
+                        << "amount : "
+                        << ::round((double)(((long double)resource->amount)
+                                            * property->workforce * 3600
+                                            / property->supplyInfo->amount
+                                            / property->supplyInfo->time))
+                        << "/h";
+                    qDebug() << "    "
+                             << "    "
+                             << "    "
+                             << "    "
+                             << "}";
+                }
+                qDebug() << "    "
+                         << "    "
+                         << "    "
+                         << "]";
+                qDebug() << "    "
+                         << "    "
+                         << "}";
+            } break;
+
+            case Property::Type::RequireWorkforce: {
+                ::std::shared_ptr<RequireWorkforce> property
+                    = ::std::static_pointer_cast<
+                        RequireWorkforce>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "workforce required : " << property->workforce;
+            } break;
+
+            case Property::Type::SupplyProduct: {
+                ::std::shared_ptr<SupplyProduct> property
+                    = ::std::static_pointer_cast<SupplyProduct>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "product            : {";
+                qDebug() << "    "
+                         << "    "
+                         << "    "
+                         << "id               :" << property->product;
+                qDebug() << "    "
+                         << "    "
+                         << "    "
+                         << "time per round   :"
+                         << property->productionInfo->time << "s";
+                qDebug()
+                    << "    "
+                    << "    "
+                    << "    "
+                    << "amount per round :"
+                    << property->productionInfo->amount
+                    << " - "
+                    << ::round(property->productionInfo->amount
+                               * (property->productionInfo->workEffect + 1.0));
+                qDebug() << "    "
+                         << "    "
+                         << "    "
+                         << "resources        : [";
+                for (auto &resource : property->productionInfo->resources) {
+                    qDebug() << "    "
+                             << "    "
+                             << "    "
+                             << "    "
+                             << "{";
+                    qDebug() << "    "
+                             << "    "
+                             << "    "
+                             << "    "
+                             << "    "
+                             << "id     : " << resource->id;
+                    qDebug()
+                        << "    "
+                        << "    "
+                        << "    "
+                        << "    "
+                        << "    "
+                        << "amount : "
+                        << ::round((double)(((long double)resource->amount)
+                                            * 3600
+                                            / property->productionInfo->time))
+                        << "/h - "
+                        << ::round(
+                               (double)(((long double)resource->amount) * 3600
+                                        / property->productionInfo->time)
+                               * (1.0 + property->productionInfo->workEffect))
+                        << "/h";
+                    qDebug() << "    "
+                             << "    "
+                             << "    "
+                             << "    "
+                             << "}";
+                }
+                qDebug() << "    "
+                         << "    "
+                         << "    "
+                         << "]";
+                qDebug() << "    "
+                         << "    "
+                         << "}";
+            } break;
+
+            case Property::Type::Cargo: {
+                ::std::shared_ptr<HasCargo> property
+                    = ::std::static_pointer_cast<HasCargo>(baseProperty);
+                qDebug() << "    "
+                         << "    "
+                         << "cargo              : {";
+                switch (property->cargoType) {
+                    case GameWares::TransportType::
+                        Container:
+                        qDebug() << "    "
+                                 << "    "
+                                 << "    "
+                                 << "type : Container";
+                        break;
+
+                    case GameWares::TransportType::Solid:
+                        qDebug() << "    "
+                                 << "    "
+                                 << "    "
+                                 << "type : Solid";
+                        break;
+
+                    case GameWares::TransportType::Liquid:
+                        qDebug() << "    "
+                                 << "    "
+                                 << "    "
+                                 << "type : Liquid";
+                        break;
+
+                    case GameWares::TransportType::Unknow:
+                        qDebug() << "    "
+                                 << "    "
+                                 << "    "
+                                 << "type : Unknow";
+                        break;
+                }
+                qDebug() << "    "
+                         << "    "
+                         << "    "
+                         << "size : " << property->cargoSize << " m^3";
+                qDebug() << "    "
+                         << "    "
+                         << "}";
+            } break;
+        }
+    }
+    qDebug() << "    "
+             << "}";
+    qDebug() << "}";
+}
+
 /**
  * @brief		Start element callback in module macro.
  */
@@ -257,10 +1369,9 @@ bool GameStationModules::onStartElementInRootOfModuleMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &)
+    const XMLLoader::Attributes &)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "macros") {
         context->setOnStartElement(::std::bind(
@@ -277,13 +1388,12 @@ bool GameStationModules::onStartElementInRootOfModuleMacro(
  * @brief		Start element callback in module macro.
  */
 bool GameStationModules::onStartElementInMacrosOfModuleMacro(
-    XMLLoader &                   loader,
-    XMLLoader::Context &          currentContext,
-    const QString &               name,
-    const QMap<QString, QString> &attr)
+    XMLLoader &                  loader,
+    XMLLoader::Context &         currentContext,
+    const QString &              name,
+    const XMLLoader::Attributes &attr)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "macro") {
         ::std::shared_ptr<StationModule> module(new StationModule);
@@ -294,6 +1404,7 @@ bool GameStationModules::onStartElementInMacrosOfModuleMacro(
         module->hull            = 0;
         module->explosiondamage = 0;
         module->racialLimited   = false;
+        module->ordinal         = -1;
 
         // Get module class.
         auto classIter = _classMap.find(attr["class"]);
@@ -310,440 +1421,12 @@ bool GameStationModules::onStartElementInMacrosOfModuleMacro(
                                                     &          currentContext,
                                                 const QString &name) -> bool {
                 if (name == "macro") {
-                    if (module->playerModule) {
-                        // Add module.
-                        m_modulesIndex[module->macro] = module;
-                        m_modules.push_back(module);
-
-                        // Print information
-                        ::std::shared_ptr<GameTexts> texts
-                            = ::std::any_cast<::std::shared_ptr<GameTexts>>(
-                                loader["texts"]);
-                        qDebug() << "module :{";
-                        qDebug() << "    "
-                                 << "macro           :" << module->macro;
-                        qDebug() << "    "
-                                 << "component       :" << module->component;
-                        qDebug()
-                            << "    "
-                            << "name            :" << texts->text(module->name);
-                        qDebug() << "    "
-                                 << "description     :"
-                                 << texts->text(module->description);
-                        switch (module->moduleClass) {
-                            case StationModule::StationModuleClass::Unknow:
-                                qDebug() << "    "
-                                         << "class           : "
-                                         << "Unknow";
-                                break;
-
-                            case StationModule::StationModuleClass::BuildModule:
-                                qDebug() << "    "
-                                         << "class           : "
-                                         << "BuildModule";
-                                break;
-
-                            case StationModule::StationModuleClass::
-                                ConnectionModule:
-                                qDebug() << "    "
-                                         << "class           : "
-                                         << "ConnectionModule";
-                                break;
-
-                            case StationModule::StationModuleClass::
-                                DefenceModule:
-                                qDebug() << "    "
-                                         << "class           : "
-                                         << "DefenceModule";
-                                break;
-
-                            case StationModule::StationModuleClass::Dockarea:
-                                qDebug() << "    "
-                                         << "class           : "
-                                         << "Dockarea";
-                                break;
-
-                            case StationModule::StationModuleClass::Habitation:
-                                qDebug() << "    "
-                                         << "class           : "
-                                         << "Habitation";
-                                break;
-
-                            case StationModule::StationModuleClass::Production:
-                                qDebug() << "    "
-                                         << "class           : "
-                                         << "Production";
-                                break;
-
-                            case StationModule::StationModuleClass::Storage:
-                                qDebug() << "    "
-                                         << "class           : "
-                                         << "Storage";
-                                break;
-                        }
-                        if (module->racialLimited) {
-                            qDebug() << "    "
-                                     << "races           : " << module->races;
-                        } else {
-                            qDebug() << "    "
-                                     << "races           : "
-                                     << "generic";
-                        }
-                        qDebug() << "    "
-                                 << "hull            : " << module->hull;
-                        qDebug()
-                            << "    "
-                            << "explosiondamage : " << module->explosiondamage;
-                        qDebug() << "    "
-                                 << "propertues      : {";
-                        for (auto &baseProperty : module->properties) {
-                            switch (baseProperty->type) {
-                                case Property::Type::MTurret: {
-                                    ::std::shared_ptr<HasMTurret> property
-                                        = ::std::static_pointer_cast<
-                                            HasMTurret>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "m turret           : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::MShield: {
-                                    ::std::shared_ptr<HasMShield> property
-                                        = ::std::static_pointer_cast<
-                                            HasMShield>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "m shield           : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::LTurret: {
-                                    ::std::shared_ptr<HasLTurret> property
-                                        = ::std::static_pointer_cast<
-                                            HasLTurret>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "l turret           : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::LShield: {
-                                    ::std::shared_ptr<HasLShield> property
-                                        = ::std::static_pointer_cast<
-                                            HasLShield>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "l shield           : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::SDock: {
-                                    ::std::shared_ptr<HasSDock> property
-                                        = ::std::static_pointer_cast<HasSDock>(
-                                            baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "s docking bay      : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::SShipCargo: {
-                                    ::std::shared_ptr<HasSShipCargo> property
-                                        = ::std::static_pointer_cast<
-                                            HasSShipCargo>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "s ship cargo       : "
-                                             << property->capacity;
-                                } break;
-
-                                case Property::Type::MDock: {
-                                    ::std::shared_ptr<HasMDock> property
-                                        = ::std::static_pointer_cast<HasMDock>(
-                                            baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "m docking bay      : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::MShipCargo: {
-                                    ::std::shared_ptr<HasMShipCargo> property
-                                        = ::std::static_pointer_cast<
-                                            HasMShipCargo>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "m ship cargo       : "
-                                             << property->capacity;
-                                } break;
-
-                                case Property::Type::LDock: {
-                                    ::std::shared_ptr<HasLDock> property
-                                        = ::std::static_pointer_cast<HasLDock>(
-                                            baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "l docking bay      : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::XLDock: {
-                                    ::std::shared_ptr<HasXLDock> property
-                                        = ::std::static_pointer_cast<HasXLDock>(
-                                            baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "xl docking bay     : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::LXLDock: {
-                                    ::std::shared_ptr<HasLXLDock> property
-                                        = ::std::static_pointer_cast<
-                                            HasLXLDock>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "l/xl docking bay   : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::SLaunchTube: {
-                                    ::std::shared_ptr<HasSLaunchTube> property
-                                        = ::std::static_pointer_cast<
-                                            HasSLaunchTube>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "s launch tube      : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::MLaunchTube: {
-                                    ::std::shared_ptr<HasMLaunchTube> property
-                                        = ::std::static_pointer_cast<
-                                            HasMLaunchTube>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "m launch tube      : "
-                                             << property->count;
-                                } break;
-
-                                case Property::Type::SupplyWorkforce: {
-                                    ::std::shared_ptr<SupplyWorkforce> property
-                                        = ::std::static_pointer_cast<
-                                            SupplyWorkforce>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "supply workforce   : {";
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "    "
-                                             << "workforce : "
-                                             << property->workforce;
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "    "
-                                             << "supplies  : [";
-                                    for (auto &resource :
-                                         property->supplyInfo->resources) {
-                                        qDebug() << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "{";
-                                        qDebug() << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "id     : " << resource->id;
-                                        qDebug()
-                                            << "    "
-                                            << "    "
-                                            << "    "
-                                            << "    "
-                                            << "    "
-                                            << "amount : "
-                                            << ::round((
-                                                   double)(((long double)
-                                                                resource
-                                                                    ->amount)
-                                                           * property->workforce
-                                                           * 3600
-                                                           / property
-                                                                 ->supplyInfo
-                                                                 ->amount
-                                                           / property
-                                                                 ->supplyInfo
-                                                                 ->time))
-                                            << "/h";
-                                        qDebug() << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "}";
-                                    }
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "    "
-                                             << "]";
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "}";
-                                } break;
-
-                                case Property::Type::RequireWorkforce: {
-                                    ::std::shared_ptr<RequireWorkforce> property
-                                        = ::std::static_pointer_cast<
-                                            RequireWorkforce>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "workforce required : "
-                                             << property->workforce;
-                                } break;
-
-                                case Property::Type::SupplyProduct: {
-                                    ::std::shared_ptr<SupplyProduct> property
-                                        = ::std::static_pointer_cast<
-                                            SupplyProduct>(baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "product            : {";
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "    "
-                                             << "id               :"
-                                             << property->product;
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "    "
-                                             << "time per round   :"
-                                             << property->productionInfo->time
-                                             << "s";
-                                    qDebug()
-                                        << "    "
-                                        << "    "
-                                        << "    "
-                                        << "amount per round :"
-                                        << property->productionInfo->amount
-                                        << " - "
-                                        << ::round(
-                                               property->productionInfo->amount
-                                               * (property->productionInfo
-                                                      ->workEffect
-                                                  + 1.0));
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "    "
-                                             << "resources        : [";
-                                    for (auto &resource :
-                                         property->productionInfo->resources) {
-                                        qDebug() << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "{";
-                                        qDebug() << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "id     : " << resource->id;
-                                        qDebug()
-                                            << "    "
-                                            << "    "
-                                            << "    "
-                                            << "    "
-                                            << "    "
-                                            << "amount : "
-                                            << ::round((
-                                                   double)(((long double)
-                                                                resource
-                                                                    ->amount)
-                                                           * 3600
-                                                           / property
-                                                                 ->productionInfo
-                                                                 ->time))
-                                            << "/h - "
-                                            << ::round(
-                                                   (double)(((long double)
-                                                                 resource
-                                                                     ->amount)
-                                                            * 3600
-                                                            / property
-                                                                  ->productionInfo
-                                                                  ->time)
-                                                   * (1.0
-                                                      + property->productionInfo
-                                                            ->workEffect))
-                                            << "/h";
-                                        qDebug() << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "    "
-                                                 << "}";
-                                    }
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "    "
-                                             << "]";
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "}";
-                                } break;
-
-                                case Property::Type::Cargo: {
-                                    ::std::shared_ptr<HasCargo> property
-                                        = ::std::static_pointer_cast<HasCargo>(
-                                            baseProperty);
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "cargo              : {";
-                                    switch (property->cargoType) {
-                                        case GameWares::TransportType::
-                                            Container:
-                                            qDebug() << "    "
-                                                     << "    "
-                                                     << "    "
-                                                     << "type : Container";
-                                            break;
-
-                                        case GameWares::TransportType::Solid:
-                                            qDebug() << "    "
-                                                     << "    "
-                                                     << "    "
-                                                     << "type : Solid";
-                                            break;
-
-                                        case GameWares::TransportType::Liquid:
-                                            qDebug() << "    "
-                                                     << "    "
-                                                     << "    "
-                                                     << "type : Liquid";
-                                            break;
-
-                                        case GameWares::TransportType::Unknow:
-                                            qDebug() << "    "
-                                                     << "    "
-                                                     << "    "
-                                                     << "type : Unknow";
-                                            break;
-                                    }
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "    "
-                                             << "size : " << property->cargoSize
-                                             << " m^3";
-                                    qDebug() << "    "
-                                             << "    "
-                                             << "}";
-                                } break;
-                            }
-                        }
-                        qDebug() << "    "
-                                 << "}";
-                        qDebug() << "}";
-                    }
+                    // Add module.
+                    QVector<::std::shared_ptr<StationModule>> *modules
+                        = ::std::any_cast<
+                            QVector<::std::shared_ptr<StationModule>> *>(
+                            loader["modules"]);
+                    modules->push_back(module);
                     currentContext.setOnStopElement(nullptr);
                 }
                 return true;
@@ -762,7 +1445,7 @@ bool GameStationModules::onStartElementInMacroOfModuleMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &                  name,
-    const QMap<QString, QString> &   attr,
+    const XMLLoader::Attributes &   attr,
     ::std::shared_ptr<StationModule> module)
 {
     // Get environemnt.
@@ -779,20 +1462,14 @@ bool GameStationModules::onStartElementInMacroOfModuleMacro(
             loader["components"]);
 
     // Parse node.
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "component") {
         module->component = attr["ref"];
-        auto iter         = m_componentTmpIndex.find(attr["ref"]);
-        if (iter == m_componentTmpIndex.end()) {
-            m_componentTmpIndex[module->component] = {module};
-        } else {
-            m_componentTmpIndex[module->component].push_back(module);
-        }
-
-        this->loadComponent(attr["ref"], module, vfs, macros, texts, wares,
-                            components);
+        this->loadComponent(
+            attr["ref"], module,
+            *::std::any_cast<QStringList *>(loader["unknowWares"]), vfs,
+            macros, texts, wares, components);
     } else if (name == "properties") {
         context->setOnStartElement(::std::bind(
             &GameStationModules::onStartElementInPropertiesOfModuleMacro, this,
@@ -816,14 +1493,10 @@ bool GameStationModules::onStartElementInPropertiesOfModuleMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &                  name,
-    const QMap<QString, QString> &   attr,
+    const XMLLoader::Attributes &   attr,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
-
-    ::std::shared_ptr<GameTexts> texts
-        = ::std::any_cast<::std::shared_ptr<GameTexts>>(loader["texts"]);
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "identification") {
         module->name        = GameTexts::IDPair(attr["name"]);
@@ -836,27 +1509,6 @@ bool GameStationModules::onStartElementInPropertiesOfModuleMacro(
             module->races         = {*iter};
             module->racialLimited = true;
         }
-        for (auto &otherModule : m_componentTmpIndex[module->component]) {
-            if (otherModule == module) {
-                continue;
-            }
-            if (module->racialLimited && (! otherModule->racialLimited)) {
-                for (auto &race : module->races) {
-                    auto iter = otherModule->races.find(race);
-                    if (iter != otherModule->races.end()) {
-                        otherModule->races.erase(iter);
-                    }
-                }
-            }
-            if ((! module->racialLimited) && otherModule->racialLimited) {
-                for (auto &race : otherModule->races) {
-                    auto iter = module->races.find(race);
-                    if (iter != module->races.end()) {
-                        module->races.erase(iter);
-                    }
-                }
-            }
-        }
     } else if (name == "build") {
         context->setOnStartElement(::std::bind(
             &GameStationModules::onStartElementInBuildOfModuleMacro, this,
@@ -882,33 +1534,33 @@ bool GameStationModules::onStartElementInPropertiesOfModuleMacro(
             property->workforce = attr["capacity"].toUInt();
 
             /// Supply
-            ::std::shared_ptr<GameWares> wares
-                = ::std::any_cast<::std::shared_ptr<GameWares>>(
-                    loader["wares"]);
             const ::std::shared_ptr<::GameWares::Ware> workunit
-                = wares->ware("workunit_busy", texts);
-            for (auto &info : workunit->productionInfos) {
-                if (info->method == attr["race"] || info->method == "default") {
-                    ::std::shared_ptr<::GameWares::ProductionInfo> supplyInfo(
-                        new ::GameWares::ProductionInfo());
-                    supplyInfo->id         = "";
-                    supplyInfo->time       = info->time;
-                    supplyInfo->amount     = attr["capacity"].toULong();
-                    supplyInfo->method     = attr["race"];
-                    supplyInfo->workEffect = 0;
-                    for (auto &res : info->resources) {
-                        ::std::shared_ptr<GameWares::Resource> resource(
-                            new GameWares::Resource);
-                        resource->id     = res->id;
-                        resource->amount = (quint32)::round(
-                            ((long double)res->amount) * supplyInfo->amount
-                            / info->amount);
-                        supplyInfo->resources[resource->id] = resource;
-                    }
+                = this->findWare(loader, "workunit_busy");
+            if (workunit != nullptr) {
+                for (auto &info : workunit->productionInfos) {
+                    if (info->method == attr["race"]
+                        || info->method == "default") {
+                        ::std::shared_ptr<::GameWares::ProductionInfo>
+                            supplyInfo(new ::GameWares::ProductionInfo());
+                        supplyInfo->id         = "";
+                        supplyInfo->time       = info->time;
+                        supplyInfo->amount     = attr["capacity"].toULong();
+                        supplyInfo->method     = attr["race"];
+                        supplyInfo->workEffect = 0;
+                        for (auto &res : info->resources) {
+                            ::std::shared_ptr<GameWares::Resource> resource(
+                                new GameWares::Resource);
+                            resource->id     = res->id;
+                            resource->amount = (quint32)::round(
+                                ((long double)res->amount)
+                                * supplyInfo->amount / info->amount);
+                            supplyInfo->resources[resource->id] = resource;
+                        }
 
-                    property->supplyInfo = supplyInfo;
-                    if (info->method == attr["race"]) {
-                        break;
+                        property->supplyInfo = supplyInfo;
+                        if (info->method == attr["race"]) {
+                            break;
+                        }
                     }
                 }
             }
@@ -975,11 +1627,10 @@ bool GameStationModules::onStartElementInBuildOfModuleMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &,
+    const XMLLoader::Attributes &,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "sets") {
         context->setOnStartElement(::std::bind(
@@ -999,11 +1650,10 @@ bool GameStationModules::onStartElementInSetsOfModuleMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &                  name,
-    const QMap<QString, QString> &   attr,
+    const XMLLoader::Attributes &   attr,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "set") {
         if (attr["ref"] == "headquarters_player") {
@@ -1022,36 +1672,33 @@ bool GameStationModules::onStartElementInProductionOfModuleMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &                  name,
-    const QMap<QString, QString> &   attr,
+    const XMLLoader::Attributes &   attr,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
-
-    ::std::shared_ptr<GameTexts> texts
-        = ::std::any_cast<::std::shared_ptr<GameTexts>>(loader["texts"]);
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "queue") {
-        ::std::shared_ptr<GameWares> wares
-            = ::std::any_cast<::std::shared_ptr<GameWares>>(loader["wares"]);
-
         QString method = "default";
         auto    iter   = attr.find("method");
         if (iter != attr.end()) {
             method = *iter;
         }
         ::std::shared_ptr<GameWares::Ware> ware
-            = wares->ware(attr["ware"], texts);
+            = this->findWare(loader, attr["ware"]);
 
-        auto productionInfoIter = ware->productionInfos.find(method);
-        if (productionInfoIter == ware->productionInfos.end()) {
-            productionInfoIter = ware->productionInfos.find("default");
+        ::std::shared_ptr<GameWares::ProductionInfo> productionInfo = nullptr;
+        if (ware != nullptr) {
+            auto productionInfoIter = ware->productionInfos.find(method);
+            if (productionInfoIter == ware->productionInfos.end()) {
+                productionInfoIter = ware->productionInfos.find("default");
+            }
+            if (productionInfoIter != ware->productionInfos.end()) {
+                productionInfo = *productionInfoIter;
+            }
         }
 
-        if (productionInfoIter != ware->productionInfos.end()) {
-            ::std::shared_ptr<SupplyProduct>             property;
-            ::std::shared_ptr<GameWares::ProductionInfo> productionInfo
-                = *productionInfoIter;
+        if (productionInfo != nullptr) {
+            ::std::shared_ptr<SupplyProduct> property;
             auto iter = module->properties.find(Property::Type::SupplyProduct);
             if (iter == module->properties.end()) {
                 property = ::std::shared_ptr<SupplyProduct>(new SupplyProduct);
@@ -1076,11 +1723,10 @@ bool GameStationModules::onStartElementInConnectionsOfModuleMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &,
+    const XMLLoader::Attributes &,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "connection") {
         context->setOnStartElement(::std::bind(
@@ -1100,11 +1746,10 @@ bool GameStationModules::onStartElementInConnectionOfModuleMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &                  name,
-    const QMap<QString, QString> &   attr,
+    const XMLLoader::Attributes &   attr,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "macro") {
         QString reference = attr["ref"];
@@ -1181,8 +1826,7 @@ void GameStationModules::loadConnectionMacro(
 
     QXmlStreamReader                      reader(file->readAll());
     XMLLoader                             loader;
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
     context->setOnStartElement(
         ::std::bind(&GameStationModules::onStartElementInRootOfConnectionMacro,
                     this, ::std::placeholders::_1, ::std::placeholders::_2,
@@ -1202,11 +1846,10 @@ bool GameStationModules::onStartElementInRootOfConnectionMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &,
+    const XMLLoader::Attributes &,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "macros") {
         context->setOnStartElement(::std::bind(
@@ -1226,11 +1869,10 @@ bool GameStationModules::onStartElementInMacrosOfConnectionMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &                  name,
-    const QMap<QString, QString> &   attr,
+    const XMLLoader::Attributes &   attr,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "macro") {
         auto iter = attr.find("class");
@@ -1254,11 +1896,10 @@ bool GameStationModules::onStartElementInMacroOfConnectionMacro(
     XMLLoader &         loader,
     XMLLoader::Context &currentContext,
     const QString &     name,
-    const QMap<QString, QString> &,
+    const XMLLoader::Attributes &,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "properties") {
         ::std::shared_ptr<TmpDockingBayInfo> info
@@ -1424,22 +2065,21 @@ bool GameStationModules::onStartElementInMacroOfConnectionMacro(
 bool GameStationModules::onStartElementInnPropertiesOfConnectionMacro(
     XMLLoader &loader,
     XMLLoader::Context &,
-    const QString &               name,
-    const QMap<QString, QString> &attr,
+    const QString &              name,
+    const XMLLoader::Attributes &attr,
     ::std::shared_ptr<StationModule>,
     ::std::shared_ptr<TmpDockingBayInfo> info)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
     if (name == "dock") {
         auto iter = attr.find("external");
         if (iter != attr.end()) {
-            info->count = iter->toUInt();
+            info->count = iter.value().toUInt();
         }
 
         iter = attr.find("capacity");
         if (iter != attr.end()) {
-            info->capacity = iter->toUInt();
+            info->capacity = iter.value().toUInt();
         }
     } else if (name == "docksize") {
         QSet<QString> tags;
@@ -1474,6 +2114,7 @@ bool GameStationModules::onStartElementInnPropertiesOfConnectionMacro(
 void GameStationModules::loadComponent(
     const QString &                   component,
     ::std::shared_ptr<StationModule>  module,
+    QStringList &                     unknowWares,
     ::std::shared_ptr<GameVFS>        vfs,
     ::std::shared_ptr<GameMacros>     macros,
     ::std::shared_ptr<GameTexts>      texts,
@@ -1489,17 +2130,17 @@ void GameStationModules::loadComponent(
 
     QXmlStreamReader                      reader(file->readAll());
     XMLLoader                             loader;
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
     context->setOnStartElement(
         ::std::bind(&GameStationModules::onStartElementInRootOfModuleComponent,
                     this, ::std::placeholders::_1, ::std::placeholders::_2,
                     ::std::placeholders::_3, ::std::placeholders::_4, module));
-    loader["vfs"]        = vfs;
-    loader["macros"]     = macros;
-    loader["texts"]      = texts;
-    loader["wares"]      = wares;
-    loader["components"] = components;
+    loader["vfs"]         = vfs;
+    loader["macros"]      = macros;
+    loader["texts"]       = texts;
+    loader["wares"]       = wares;
+    loader["components"]  = components;
+    loader["unknowWares"] = &unknowWares;
     loader.parse(reader, ::std::move(context));
 }
 
@@ -1510,11 +2151,10 @@ bool GameStationModules::onStartElementInRootOfModuleComponent(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &,
+    const XMLLoader::Attributes &,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "components") {
         context->setOnStartElement(::std::bind(
@@ -1534,11 +2174,10 @@ bool GameStationModules::onStartElementInComponentsOfModuleComponent(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &,
+    const XMLLoader::Attributes &,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "component") {
         context->setOnStartElement(::std::bind(
@@ -1558,11 +2197,10 @@ bool GameStationModules::onStartElementInComponentOfModuleComponent(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &,
+    const XMLLoader::Attributes &,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "properties") {
         context->setOnStartElement(::std::bind(
@@ -1587,17 +2225,16 @@ bool GameStationModules::onStartElementInConnectionsOfModuleComponent(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &                  name,
-    const QMap<QString, QString> &   attr,
+    const XMLLoader::Attributes &   attr,
     ::std::shared_ptr<StationModule> module)
 {
-    ::std::unique_ptr<XMLLoader::Context> context
-        = XMLLoader::Context::create();
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
 
     if (name == "connection") {
         auto iter = attr.find("tags");
         if (iter != attr.end()) {
-            auto tags
-                = iter->split(" ", Qt::SplitBehaviorFlags::SkipEmptyParts);
+            auto tags = iter.value().split(
+                " ", Qt::SplitBehaviorFlags::SkipEmptyParts);
             bool foundTurret = false;
             bool foundShield = false;
             bool foundMedium = false;
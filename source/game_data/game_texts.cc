@@ -1,21 +1,28 @@
+#include <algorithm>
+#include <numeric>
+
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QReadLocker>
 #include <QtCore/QRegExp>
+#include <QtCore/QWriteLocker>
 
 #include <common.h>
+#include <config.h>
 #include <game_data/game_texts.h>
 #include <locale/string_table.h>
 
 /**
- * @brief		Constructor.
+ * @brief		Constructor, load the texts of the base game.
  */
 GameTexts::GameTexts(::std::shared_ptr<GameVFS>             vfs,
                      ::std::function<void(const QString &)> setTextFunc) :
-    m_unknowIndex(0)
+    m_unknowIndex(0), m_resolvedGeneration(0), m_cacheHits(0),
+    m_cacheMisses(0), m_referenceCycles(0), m_cacheSavedNs(0), m_vfs(vfs)
 {
-    QStringList textFiles;
-    QRegExp     nameFilter("\\d+-L\\d+\\.xml");
+    QRegExp nameFilter("\\d+-L(\\d+)\\.xml");
     nameFilter.setCaseSensitivity(Qt::CaseSensitivity::CaseInsensitive);
 
     // Master files
@@ -23,19 +30,155 @@ GameTexts::GameTexts(::std::shared_ptr<GameVFS>             vfs,
     for (auto iter = dirReader->begin(); iter != dirReader->end(); ++iter) {
         if (iter->type == ::GameVFS::DirReader::EntryType::File
             && nameFilter.exactMatch(iter->name)) {
-            textFiles.append(dirReader->absPath(iter->name));
+            m_languageFiles[nameFilter.cap(1).toUInt()].append(
+                dirReader->absPath(iter->name));
+        }
+    }
+
+    this->loadStartupLanguages(setTextFunc);
+
+    this->setInitialized();
+}
+
+/**
+ * @brief		Constructor, load texts from snapshot.
+ */
+GameTexts::GameTexts(::std::shared_ptr<GameVFS>             vfs,
+                     QDataStream &                          stream,
+                     ::std::function<void(const QString &)> setTextFunc) :
+    m_unknowIndex(0), m_resolvedGeneration(0), m_cacheHits(0),
+    m_cacheMisses(0), m_referenceCycles(0), m_cacheSavedNs(0), m_vfs(vfs)
+{
+    qint32  unknowIndex;
+    quint32 languageCount;
+    stream >> m_languageFiles >> m_extensionLanguageFiles >> unknowIndex
+        >> languageCount;
+    if (stream.status() != QDataStream::Status::Ok
+        || ! GameTexts::readTextStore(stream, m_addedTexts)) {
+        return;
+    }
+    m_unknowIndex.store(unknowIndex);
+
+    for (quint32 i = 0; i < languageCount; ++i) {
+        quint32   languageID;
+        TextStore store;
+        stream >> languageID;
+        if (! GameTexts::readTextStore(stream, store)) {
+            return;
         }
+        m_languages[languageID] = ::std::move(store);
+        m_loadedLanguages.insert(languageID);
     }
+    qDebug() << "Texts of" << m_languages.size()
+             << "languages loaded from snapshot.";
+
+    this->loadStartupLanguages(setTextFunc);
+
+    this->setInitialized();
+}
+
+/**
+ * @brief		Load texts from snapshot.
+ */
+::std::shared_ptr<GameTexts>
+    GameTexts::loadSnapshot(::std::shared_ptr<GameVFS>             vfs,
+                            QDataStream &                          stream,
+                            ::std::function<void(const QString &)> setTextFunc)
+{
+    ::std::shared_ptr<GameTexts> ret(new GameTexts(vfs, stream, setTextFunc));
+
+    if (ret == nullptr || ! ret->initialized()) {
+        return nullptr;
+    } else {
+        return ret;
+    }
+}
+
+/**
+ * @brief		Save texts to snapshot.
+ */
+void GameTexts::saveSnapshot(QDataStream &stream)
+{
+    QReadLocker locker(&m_languageLock);
+    stream << m_languageFiles << m_extensionLanguageFiles
+           << (qint32)(m_unknowIndex.load()) << (quint32)(m_languages.size());
+    GameTexts::writeTextStore(stream, m_addedTexts);
+    for (auto iter = m_languages.begin(); iter != m_languages.end(); ++iter) {
+        stream << iter.key();
+        GameTexts::writeTextStore(stream, iter.value());
+    }
+}
+
+/**
+ * @brief		Get text.
+ */
+QString GameTexts::text(qint32 pageID, qint32 textID)
+{
+    QVector<quint64> resolving;
+    return this->cachedText(pageID, textID,
+                            StringTable::instance()->languageId(), resolving);
+}
+
+/**
+ * @brief		Get text.
+ */
+QString GameTexts::text(const IDPair &idPair)
+{
+    return this->text(idPair.pageID, idPair.textID);
+}
+
+/**
+ * @brief		Add text.
+ */
+GameTexts::IDPair GameTexts::addText(const QString &str)
+{
+    // The IDs are allocated in the lock to keep the keys sorted.
+    QWriteLocker locker(&m_languageLock);
+    qint32       id = m_unknowIndex.fetchAndAddAcquire(1);
+    this->parseText(str, GameTexts::textKey(-1, id), m_addedTexts);
+
+    return IDPair(static_cast<qint32>(-1), id);
+}
+
+/**
+ * @brief		Get statistics of resolved text cache.
+ */
+GameTexts::CacheStatistics GameTexts::cacheStatistics() const
+{
+    return CacheStatistics({m_cacheHits, m_cacheMisses, m_referenceCycles,
+                            m_cacheSavedNs});
+}
+
+/**
+ * @brief		Destructor.
+ */
+GameTexts::~GameTexts()
+{
+    QObject::disconnect(m_languageConnection);
+    m_loadingTasks.wait();
+    this->printCacheStatistics();
+}
+
+/**
+ * @brief		Load the texts of extensions in the languages loaded.
+ */
+bool GameTexts::applyExtensions(
+    ::std::function<void(const QString &)> setTextFunc)
+{
+    QRegExp nameFilter("\\d+-L(\\d+)\\.xml");
+    nameFilter.setCaseSensitivity(Qt::CaseSensitivity::CaseInsensitive);
 
     // Extension files
+    QMap<quint32, QStringList>              extensionLanguageFiles;
     ::std::shared_ptr<::GameVFS::DirReader> extensionsDir
-        = vfs->openDir("/extensions");
+        = m_vfs->openDir("/extensions");
     if (extensionsDir != nullptr) {
         for (auto iter = extensionsDir->begin(); iter != extensionsDir->end();
              ++iter) {
             if (iter->type == ::GameVFS::DirReader::EntryType::Directory) {
                 ::std::shared_ptr<GameVFS::DirReader> dirReader
-                    = vfs->openDir(QString("/extensions/%1/t").arg(iter->name));
+                    = m_vfs->openDir(
+                        QString("/extensions/%1/t").arg(iter->name));
                 if (dirReader == nullptr) {
                     continue;
                 }
@@ -43,92 +186,387 @@ GameTexts::GameTexts(::std::shared_ptr<GameVFS>             vfs,
                      ++iter) {
                     if (iter->type == ::GameVFS::DirReader::EntryType::File
                         && nameFilter.exactMatch(iter->name)) {
-                        textFiles.append(dirReader->absPath(iter->name));
+                        extensionLanguageFiles[nameFilter.cap(1).toUInt()]
+                            .append(dirReader->absPath(iter->name));
                     }
                 }
             }
         }
     }
 
-    // Search file
-    auto                   allFileIter = textFiles.begin();
-    QMutex                 allFileIterLock;
-    ::std::atomic<quint64> finishedCount;
-    size_t                 total = textFiles.count();
-    finishedCount                = 0;
+    // Load files of the languages loaded.
+    QStringList textFiles;
+    {
+        QWriteLocker locker(&m_languageLock);
+        m_extensionLanguageFiles = extensionLanguageFiles;
+        for (quint32 languageID : m_loadedLanguages) {
+            textFiles.append(extensionLanguageFiles.value(languageID));
+        }
+    }
+    size_t      total = textFiles.count();
+    QStringList failedFiles;
+    setTextFunc(STR("STR_LOADING_TEXT_FILE").arg(0).arg(total));
+    QMap<quint32, TextStore> texts = this->loadFiles(
+        textFiles,
+        [&setTextFunc, total](quint64 finishedCount) -> void {
+            setTextFunc(
+                STR("STR_LOADING_TEXT_FILE").arg(finishedCount).arg(total));
+        },
+        failedFiles);
+    if (! failedFiles.empty()) {
+        return false;
+    }
+
+    // Merge texts.
+    {
+        QWriteLocker locker(&m_languageLock);
+        for (auto iter = texts.begin(); iter != texts.end(); ++iter) {
+            m_languages[iter.key()] = GameTexts::compactTexts(
+                {&(m_languages[iter.key()]), &(iter.value())});
+        }
+    }
+    {
+        QWriteLocker locker(&m_resolvedLock);
+        m_resolved.clear();
+        ++m_resolvedGeneration;
+    }
+
+    return true;
+}
+
+/**
+ * @brief		Load the languages used at startup.
+ */
+void GameTexts::loadStartupLanguages(
+    ::std::function<void(const QString &)> setTextFunc)
+{
+    // Languages to load, the other languages are loaded when the language
+    // changes.
+    QSet<quint32> languages;
+    if (Config::instance()->getBool("/textLoadAllLanguages", false)) {
+        for (auto iter = m_languageFiles.begin(); iter != m_languageFiles.end();
+             ++iter) {
+            languages.insert(iter.key());
+        }
+    } else {
+        languages.insert(StringTable::instance()->languageId());
+        languages.insert(44);
+    }
+    QStringList textFiles;
+    for (quint32 languageID : languages) {
+        if (! m_loadedLanguages.contains(languageID)) {
+            m_loadedLanguages.insert(languageID);
+            textFiles.append(this->languageFiles(languageID));
+        }
+    }
+
+    // Load files.
+    if (! textFiles.empty()) {
+        size_t      total = textFiles.count();
+        QStringList failedFiles;
+        setTextFunc(STR("STR_LOADING_TEXT_FILE").arg(0).arg(total));
+        QMap<quint32, TextStore> texts = this->loadFiles(
+            textFiles,
+            [&setTextFunc, total](quint64 finishedCount) -> void {
+                setTextFunc(
+                    STR("STR_LOADING_TEXT_FILE").arg(finishedCount).arg(total));
+            },
+            failedFiles);
+        for (auto iter = texts.begin(); iter != texts.end(); ++iter) {
+            m_languages[iter.key()] = iter.value();
+        }
+    }
+
+    m_languageConnection = QObject::connect(
+        StringTable::instance().get(), &StringTable::languageChanged,
+        StringTable::instance().get(),
+        [this]() -> void { this->onLanguageChanged(); });
+}
+
+/**
+ * @brief		Get text files of language.
+ */
+QStringList GameTexts::languageFiles(quint32 languageID) const
+{
+    return m_languageFiles.value(languageID)
+           + m_extensionLanguageFiles.value(languageID);
+}
+
+/**
+ * @brief		Load text files.
+ */
+QMap<quint32, GameTexts::TextStore>
+    GameTexts::loadFiles(const QStringList &             files,
+                         ::std::function<void(quint64)> onFileLoaded,
+                         QStringList &                   failedFiles)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Each thread parses files into its own texts, the texts are merged
+    // after all files parsed.
+    QVector<QMap<quint32, TextStore>> threadTexts;
+    QMutex                            threadTextsLock;
+    QAtomicInt                        nextFile(0);
+    ::std::atomic<quint64>            finishedCount;
+    finishedCount = 0;
     MultiRun loadTask(::std::function<void()>([&]() -> void {
-        QStringList::iterator fileIter;
+        QMap<quint32, TextStore> texts;
         while (true) {
             // Get file
-            {
-                QMutexLocker locker(&allFileIterLock);
-                if (allFileIter == textFiles.end()) {
-                    return;
-                } else {
-                    fileIter = allFileIter;
-                    allFileIter += 1;
-                }
+            int index = nextFile.fetchAndAddOrdered(1);
+            if (index >= files.size()) {
+                break;
             }
 
             // Load file
-            qDebug() << "Loading file" << *fileIter << ".";
+            qDebug() << "Loading file" << files[index] << ".";
 
             // Open
             ::std::shared_ptr<GameVFS::FileReader> fileReader
-                = vfs->open(*fileIter);
+                = m_vfs->open(files[index]);
+            if (fileReader == nullptr) {
+                qWarning() << "Failed to open text file" << files[index]
+                           << ".";
+                QMutexLocker locker(&threadTextsLock);
+                failedFiles.append(files[index]);
+                continue;
+            }
 
             // Parse xml
             QXmlStreamReader                      reader(fileReader->readAll());
             XMLLoader                             loader;
             ::std::unique_ptr<XMLLoader::Context> context
-                = XMLLoader::Context::create();
+                = loader.createContext();
+            loader["texts"] = &texts;
             context->setOnStartElement(
                 ::std::bind(&GameTexts::onStartElementInRoot, this,
                             ::std::placeholders::_1, ::std::placeholders::_2,
                             ::std::placeholders::_3, ::std::placeholders::_4));
-            loader.parse(reader, ::std::move(context));
+            if (! loader.parse(reader, ::std::move(context))
+                || reader.hasError()) {
+                qWarning() << "Failed to parse text file" << files[index]
+                           << ":" << reader.errorString();
+                QMutexLocker locker(&threadTextsLock);
+                failedFiles.append(files[index]);
+            }
+
+            // Set load order of the texts, the texts in files loaded later
+            // overwrite the texts with the same ID.
+            for (TextStore &store : texts) {
+                int count = store.orders.size();
+                store.orders.resize(store.keys.size());
+                ::std::fill(store.orders.begin() + count, store.orders.end(),
+                            static_cast<quint32>(index));
+            }
 
             finishedCount += 1;
-            setTextFunc(
-                STR("STR_LOADING_TEXT_FILE").arg(finishedCount).arg(total));
+            if (onFileLoaded) {
+                onFileLoaded(finishedCount);
+            }
         }
-    }));
 
-    setTextFunc(STR("STR_LOADING_TEXT_FILE").arg(finishedCount).arg(total));
+        if (! texts.empty()) {
+            QMutexLocker locker(&threadTextsLock);
+            threadTexts.append(::std::move(texts));
+        }
+    }));
     loadTask.run();
+    qint64 parseTime = timer.elapsed();
 
-    this->setInitialized();
+    // Merge texts of each language in parallel.
+    QMap<quint32, QVector<const TextStore *>> languageTexts;
+    for (auto &texts : threadTexts) {
+        for (auto iter = texts.begin(); iter != texts.end(); ++iter) {
+            languageTexts[iter.key()].append(&(iter.value()));
+        }
+    }
+    QList<quint32>     languageIDs = languageTexts.keys();
+    QVector<TextStore> merged(languageIDs.size());
+    TextStore *        mergedData = merged.data();
+    TaskPool::parallelFor(
+        0, languageIDs.size(), [&](int begin, int end) -> void {
+            for (int i = begin; i < end; ++i) {
+                mergedData[i] = GameTexts::compactTexts(
+                    languageTexts.value(languageIDs[i]));
+            }
+        });
+    int threadCount = threadTexts.size();
+    threadTexts.clear();
+
+    QMap<quint32, TextStore> ret;
+    for (int i = 0; i < languageIDs.size(); ++i) {
+        const TextStore &store = merged[i];
+        qDebug() << "Language" << languageIDs[i] << ":" << store.keys.size()
+                 << "texts," << store.links.size() << "links,"
+                 << store.pool.size() << "characters in string pool.";
+        ret[languageIDs[i]] = store;
+    }
+    qDebug() << files.size() << "text files parsed by" << threadCount
+             << "threads in" << parseTime << "ms, merged in"
+             << timer.elapsed() - parseTime << "ms.";
+
+    return ret;
 }
 
 /**
- * @brief		Get text.
+ * @brief		Called when the language changes.
  */
-QString GameTexts::text(qint32 pageID, qint32 textID)
+void GameTexts::onLanguageChanged()
 {
-    QString ret      = "";
-    auto    pageIter = m_textPages.find(pageID);
-    if (pageIter == m_textPages.end()) {
-        return "";
+    this->printCacheStatistics();
+
+    quint32 languageID = StringTable::instance()->languageId();
+    {
+        QWriteLocker locker(&m_languageLock);
+        if (m_loadedLanguages.contains(languageID)) {
+            return;
+        }
+        m_loadedLanguages.insert(languageID);
+    }
+
+    QStringList files = this->languageFiles(languageID);
+    if (files.empty()) {
+        return;
     }
-    auto textIter = (*pageIter)->texts.find(textID);
-    if (textIter == (*pageIter)->texts.end()) {
+
+    // Load texts in background, en_US texts are shown until the texts has
+    // been loaded.
+    qDebug() << "Loading texts of language" << languageID << "in background.";
+    m_loadingTasks.run([this, files]() -> void {
+        QStringList              failedFiles;
+        QMap<quint32, TextStore> texts
+            = this->loadFiles(files, nullptr, failedFiles);
+        {
+            QWriteLocker locker(&m_languageLock);
+            for (auto iter = texts.begin(); iter != texts.end(); ++iter) {
+                m_languages[iter.key()] = iter.value();
+            }
+        }
+
+        // Drop the texts resolved before, they may be resolved with the
+        // en_US texts.
+        {
+            QWriteLocker locker(&m_resolvedLock);
+            m_resolved.clear();
+            ++m_resolvedGeneration;
+        }
+
+        QMetaObject::invokeMethod(
+            StringTable::instance().get(),
+            []() -> void { StringTable::instance()->refreshLanguage(); },
+            Qt::ConnectionType::QueuedConnection);
+    });
+}
+
+/**
+ * @brief		Print statistics of resolved text cache.
+ */
+void GameTexts::printCacheStatistics() const
+{
+    CacheStatistics statistics = this->cacheStatistics();
+    quint64         total      = statistics.hits + statistics.misses;
+    qDebug() << "Text cache :" << statistics.hits << "hits,"
+             << statistics.misses << "misses, hit rate"
+             << (total == 0 ? 0.0 : (double)statistics.hits / total)
+             << ", saved" << statistics.savedNs / 1000000 << "ms,"
+             << statistics.cycles << "reference cycles.";
+}
+
+/**
+ * @brief		Get text from resolved text cache.
+ */
+QString GameTexts::cachedText(qint32            pageID,
+                              qint32            textID,
+                              quint32           languageID,
+                              QVector<quint64> &resolving)
+{
+    quint64 key = GameTexts::textKey(pageID, textID);
+    quint64 generation;
+
+    // Get resolved text.
+    {
+        QReadLocker locker(&m_resolvedLock);
+        generation        = m_resolvedGeneration;
+        auto languageIter = m_resolved.constFind(languageID);
+        if (languageIter != m_resolved.constEnd()) {
+            auto iter = languageIter->constFind(key);
+            if (iter != languageIter->constEnd()) {
+                m_cacheHits += 1;
+                m_cacheSavedNs += iter->cost;
+                return iter->text;
+            }
+        }
+    }
+
+    // Check reference cycle.
+    if (resolving.contains(key)) {
+        m_referenceCycles += 1;
+        qWarning() << "Reference cycle found in text"
+                   << QString("{%1,%2}").arg(pageID).arg(textID) << ".";
         return "";
     }
 
-    auto linkIter
-        = (*textIter)->links.find(StringTable::instance()->languageId());
-    if (linkIter == (*textIter)->links.end()) {
-        linkIter = (*textIter)->links.find(44);
-        if (linkIter == (*textIter)->links.end()) {
-            return "";
+    // Resolve text.
+    m_cacheMisses += 1;
+    QElapsedTimer timer;
+    timer.start();
+    resolving.append(key);
+    QString ret = this->resolveText(pageID, textID, languageID, resolving);
+    resolving.removeLast();
+
+    // The text is not cached if the texts have been changed while resolving.
+    QWriteLocker locker(&m_resolvedLock);
+    if (generation == m_resolvedGeneration) {
+        m_resolved[languageID][key] = ResolvedText({ret, timer.nsecsElapsed()});
+    }
+
+    return ret;
+}
+
+/**
+ * @brief		Resolve text.
+ */
+QString GameTexts::resolveText(qint32            pageID,
+                               qint32            textID,
+                               quint32           languageID,
+                               QVector<quint64> &resolving)
+{
+    quint64   key   = GameTexts::textKey(pageID, textID);
+    int       index = -1;
+    TextStore store;
+    {
+        QReadLocker locker(&m_languageLock);
+        if (pageID == -1) {
+            store = m_addedTexts;
+            index = GameTexts::findText(store, key);
+        } else {
+            // Current language, en_US if not found.
+            for (quint32 id : {languageID, (quint32)44}) {
+                auto iter = m_languages.constFind(id);
+                if (iter == m_languages.constEnd()) {
+                    continue;
+                }
+                index = GameTexts::findText(*iter, key);
+                if (index >= 0) {
+                    store = *iter;
+                    break;
+                }
+            }
         }
     }
+    if (index < 0) {
+        return "";
+    }
 
-    for (auto &link : *linkIter) {
+    QString ret = "";
+    for (quint32 i = store.ranges[index]; i < store.ranges[index + 1]; ++i) {
+        const TextLink &link = store.links[i];
         if (link.isRef) {
-            ret.append(this->text(link.refInfo.pageID, link.refInfo.textID));
+            ret.append(this->cachedText(link.first, link.second, languageID,
+                                        resolving));
         } else {
-            ret.append(link.text);
+            ret.append(store.pool.constData() + link.first, link.second);
         }
     }
 
@@ -136,59 +574,149 @@ QString GameTexts::text(qint32 pageID, qint32 textID)
 }
 
 /**
- * @brief		Get text.
+ * @brief		Find text in compacted texts.
  */
-QString GameTexts::text(const IDPair &idPair)
+int GameTexts::findText(const TextStore &store, quint64 key)
 {
-    return this->text(idPair.pageID, idPair.textID);
+    auto iter = ::std::lower_bound(store.keys.begin(), store.keys.end(), key);
+    if (iter == store.keys.end() || *iter != key) {
+        return -1;
+    }
+
+    return static_cast<int>(iter - store.keys.begin());
 }
 
 /**
- * @brief		Add text.
+ * @brief		Merge and compact texts.
  */
-GameTexts::IDPair GameTexts::addText(const QString &str)
+GameTexts::TextStore
+    GameTexts::compactTexts(const QVector<const TextStore *> &stores)
 {
-    // Get page.
-    ::std::shared_ptr<TextPage> page;
-    {
-        QMutexLocker lock(&m_pageLock);
-        auto         pageIter = m_textPages.find(-1);
-        if (pageIter == m_textPages.end()) {
-            page            = ::std::shared_ptr<TextPage>(new TextPage);
-            page->pageID    = -1;
-            m_textPages[-1] = page;
-        } else {
-            page = *pageIter;
+    /**
+     * @brief	Text to merge.
+     */
+    struct Entry {
+        quint64 key;   ///< Key.
+        quint32 order; ///< Load order.
+        int     store; ///< Index of store.
+        int     index; ///< Index of text in the store.
+    };
+
+    // Sort texts by key and load order.
+    QVector<Entry> entries;
+    for (int i = 0; i < stores.size(); ++i) {
+        const TextStore *store = stores[i];
+        for (int j = 0; j < store->keys.size(); ++j) {
+            entries.append({store->keys[j], store->orders.value(j), i, j});
         }
     }
+    ::std::sort(entries.begin(), entries.end(),
+                [](const Entry &a, const Entry &b) -> bool {
+                    if (a.key != b.key) {
+                        return a.key < b.key;
+                    } else if (a.order != b.order) {
+                        return a.order < b.order;
+                    } else if (a.store != b.store) {
+                        return a.store < b.store;
+                    } else {
+                        return a.index < b.index;
+                    }
+                });
 
-    // set text;
-    qint32 id = m_unknowIndex.fetchAndAddAcquire(1);
-    {
-        QMutexLocker            locker(&(page->lock));
-        ::std::shared_ptr<Text> text;
-        text            = ::std::shared_ptr<Text>(new Text);
-        text->pageID    = page->pageID;
-        text->textID    = id;
-        text->links[44] = this->parseText(str);
-        page->texts[id] = text;
+    // Copy the last loaded text of each key.
+    TextStore ret;
+    ret.keys.reserve(entries.size());
+    ret.ranges.reserve(entries.size() + 1);
+    ret.ranges.append(0);
+    for (int i = 0; i < entries.size(); ++i) {
+        const Entry &entry = entries[i];
+        if (i + 1 < entries.size() && entries[i + 1].key == entry.key) {
+            continue;
+        }
+
+        const TextStore &store = *(stores[entry.store]);
+        ret.keys.append(entry.key);
+        for (quint32 j = store.ranges[entry.index];
+             j < store.ranges[entry.index + 1]; ++j) {
+            TextLink link = store.links[j];
+            if (! link.isRef) {
+                qint32 offset = ret.pool.size();
+                ret.pool.append(store.pool.constData() + link.first,
+                                link.second);
+                link.first = offset;
+            }
+            ret.links.append(link);
+        }
+        ret.ranges.append(static_cast<quint32>(ret.links.size()));
     }
+    ret.links.squeeze();
+    ret.pool.squeeze();
 
-    return IDPair(static_cast<qint32>(-1), id);
+    return ret;
 }
 
 /**
- * @brief		Destructor.
+ * @brief		Write compacted texts to snapshot.
  */
-GameTexts::~GameTexts() {}
+void GameTexts::writeTextStore(QDataStream &stream, const TextStore &store)
+{
+    stream << store.keys << store.ranges << (quint32)store.links.size();
+    for (const TextLink &link : store.links) {
+        stream << link.isRef << link.first << link.second;
+    }
+    stream << store.pool;
+}
+
+/**
+ * @brief		Read compacted texts from snapshot.
+ */
+bool GameTexts::readTextStore(QDataStream &stream, TextStore &store)
+{
+    quint32 linkCount;
+    stream >> store.keys >> store.ranges >> linkCount;
+    if (stream.status() != QDataStream::Status::Ok
+        || linkCount > (quint32)(stream.device()->bytesAvailable())) {
+        return false;
+    }
+    store.links.resize(linkCount);
+    for (TextLink &link : store.links) {
+        stream >> link.isRef >> link.first >> link.second;
+    }
+    stream >> store.pool;
+    store.orders.clear();
+    if (stream.status() != QDataStream::Status::Ok) {
+        return false;
+    }
+
+    // Check ranges and links.
+    if (store.ranges.empty()) {
+        return store.keys.empty() && store.links.empty();
+    }
+    if (store.ranges.size() != store.keys.size() + 1
+        || store.ranges.front() != 0
+        || store.ranges.back() != (quint32)(store.links.size())
+        || ! ::std::is_sorted(store.ranges.begin(), store.ranges.end())
+        || ! ::std::is_sorted(store.keys.begin(), store.keys.end())) {
+        return false;
+    }
+    for (const TextLink &link : store.links) {
+        if (! link.isRef
+            && (link.first < 0 || link.second < 0
+                || link.first > store.pool.size() - link.second)) {
+            return false;
+        }
+    }
+
+    return true;
+}
 
 /**
  * @brief		Start element callback in root.
  */
-bool GameTexts::onStartElementInRoot(XMLLoader &                   loader,
-                                     XMLLoader::Context &          context,
-                                     const QString &               name,
-                                     const QMap<QString, QString> &attr)
+bool GameTexts::onStartElementInRoot(XMLLoader &                  loader,
+                                     XMLLoader::Context &         context,
+                                     const QString &              name,
+                                     const XMLLoader::Attributes &attr)
 {
     UNREFERENCED_PARAMETER(context);
     if (name == "language") {
@@ -198,13 +726,16 @@ bool GameTexts::onStartElementInRoot(XMLLoader &                   loader,
             return false;
         }
 
+        quint32 languageID = iter.value().toUInt();
+
         // Context for pages
-        ::std::unique_ptr<XMLLoader::Context> context
-            = XMLLoader::Context::create();
+        QMap<quint32, TextStore> *texts
+            = ::std::any_cast<QMap<quint32, TextStore> *>(loader["texts"]);
+        ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
         context->setOnStartElement(::std::bind(
             &GameTexts::onStartElementInLanguage, this, ::std::placeholders::_1,
             ::std::placeholders::_2, ::std::placeholders::_3,
-            ::std::placeholders::_4, iter.value().toInt()));
+            ::std::placeholders::_4, &((*texts)[languageID])));
         loader.pushContext(::std::move(context));
     } else {
         qWarning() << "Illegal name of start element in xml file";
@@ -217,47 +748,32 @@ bool GameTexts::onStartElementInRoot(XMLLoader &                   loader,
 /**
  * @brief		Start element callback in language.
  */
-bool GameTexts::onStartElementInLanguage(XMLLoader &                   loader,
-                                         XMLLoader::Context &          context,
-                                         const QString &               name,
-                                         const QMap<QString, QString> &attr,
-                                         quint32 languageID)
+bool GameTexts::onStartElementInLanguage(XMLLoader &                  loader,
+                                         XMLLoader::Context &         context,
+                                         const QString &              name,
+                                         const XMLLoader::Attributes &attr,
+                                         TextStore *                  store)
 {
     UNREFERENCED_PARAMETER(context);
     if (name == "page") {
         auto iter = attr.find("id");
         if (iter == attr.end()) {
             qWarning() << "Missing attribute 'id' in <page> element.";
-            loader.pushContext(XMLLoader::Context::create());
+            loader.skipElement();
             return true;
         }
 
         qint32 pageID = iter.value().toInt();
 
-        // Get page
-        ::std::shared_ptr<TextPage> page;
-        {
-            QMutexLocker locker(&m_pageLock);
-            auto         pageIter = m_textPages.find(pageID);
-            if (pageIter == m_textPages.end()) {
-                page                = ::std::shared_ptr<TextPage>(new TextPage);
-                page->pageID        = pageID;
-                m_textPages[pageID] = page;
-            } else {
-                page = *pageIter;
-            }
-        }
-
         // Context for text
-        ::std::unique_ptr<XMLLoader::Context> context
-            = XMLLoader::Context::create();
+        ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
         context->setOnStartElement(::std::bind(
             &GameTexts::onStartElementInPage, this, ::std::placeholders::_1,
             ::std::placeholders::_2, ::std::placeholders::_3,
-            ::std::placeholders::_4, languageID, page));
+            ::std::placeholders::_4, store, pageID));
         loader.pushContext(::std::move(context));
     } else {
-        loader.pushContext(XMLLoader::Context::create());
+        loader.skipElement();
     }
 
     return true;
@@ -266,53 +782,39 @@ bool GameTexts::onStartElementInLanguage(XMLLoader &                   loader,
 /**
  * @brief		Start element callback in page.
  */
-bool GameTexts::onStartElementInPage(XMLLoader &                   loader,
-                                     XMLLoader::Context &          context,
-                                     const QString &               name,
-                                     const QMap<QString, QString> &attr,
-                                     quint32                       languageID,
-                                     ::std::shared_ptr<TextPage>   page)
+bool GameTexts::onStartElementInPage(XMLLoader &                  loader,
+                                     XMLLoader::Context &         context,
+                                     const QString &              name,
+                                     const XMLLoader::Attributes &attr,
+                                     TextStore *                  store,
+                                     qint32                       pageID)
 {
     UNREFERENCED_PARAMETER(context);
     if (name == "t") {
         auto iter = attr.find("id");
         if (iter == attr.end()) {
             qWarning() << "Missing attribute 'id' in <t> element.";
-            loader.pushContext(XMLLoader::Context::create());
+            loader.skipElement();
             return true;
         }
 
-        qint32 id = iter.value().toInt();
-
-        // Get text
-        QMutexLocker            locker(&(page->lock));
-        ::std::shared_ptr<Text> text;
-        auto                    textIter = page->texts.find(id);
-        if (textIter == page->texts.end()) {
-            text            = ::std::shared_ptr<Text>(new Text);
-            text->pageID    = page->pageID;
-            text->textID    = id;
-            page->texts[id] = text;
-        } else {
-            text = *textIter;
-        }
+        quint64 key = GameTexts::textKey(pageID, iter.value().toInt());
 
         // Context for text
-        ::std::unique_ptr<XMLLoader::Context> context
-            = XMLLoader::Context::create();
+        ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
         context->setOnStartElement([](XMLLoader &loader, XMLLoader::Context &,
                                       const QString &,
-                                      const QMap<QString, QString> &) -> bool {
-            loader.pushContext(XMLLoader::Context::create());
+                                      const XMLLoader::Attributes &) -> bool {
+            loader.skipElement();
             return true;
         });
         context->setOnCharacters(
             ::std::bind(&GameTexts::onTextCharacters, this,
                         ::std::placeholders::_1, ::std::placeholders::_2,
-                        ::std::placeholders::_3, languageID, text));
+                        ::std::placeholders::_3, store, key));
         loader.pushContext(::std::move(context));
     } else {
-        loader.pushContext(XMLLoader::Context::create());
+        loader.skipElement();
     }
 
     return true;
@@ -321,21 +823,18 @@ bool GameTexts::onStartElementInPage(XMLLoader &                   loader,
 /**
  * @brief		Characters callback.
  */
-bool GameTexts::onTextCharacters(XMLLoader &             loader,
-                                 XMLLoader::Context &    context,
-                                 const QString &         s,
-                                 quint32                 languageID,
-                                 ::std::shared_ptr<Text> text)
+bool GameTexts::onTextCharacters(XMLLoader &         loader,
+                                 XMLLoader::Context &context,
+                                 const QString &     s,
+                                 TextStore *         store,
+                                 quint64             key)
 {
     UNREFERENCED_PARAMETER(loader);
     UNREFERENCED_PARAMETER(context);
 
-    // Read and parse text.
-    QVector<GameTexts::TextLink> links = this->parseText(s);
-
-    // Set text.
-    QMutexLocker locker(&(text->lock));
-    text->links[languageID] = ::std::move(links);
+    // Read and parse text, the texts appended later overwrite the texts
+    // appended before when compacted.
+    this->parseText(s, key, *store);
 
     return true;
 }
@@ -343,58 +842,128 @@ bool GameTexts::onTextCharacters(XMLLoader &             loader,
 /**
  * @brief		Parse text.
  */
-QVector<GameTexts::TextLink> GameTexts::parseText(QString s)
+void GameTexts::parseText(const QString &s, quint64 key, TextStore &store)
 {
-    QVector<GameTexts::TextLink> ret;
-    TextLink                     link;
-    QRegExp                      ignoreExp("\\(.*\\)");
-    QRegExp                      whiteSpacewExp("\\s");
-    QRegExp referenceExp("\\{\\s*(\\d+)\\s*,\\s*(\\d+)\\s*\\}");
-    QRegExp numExp("\\d+");
-
-    s = s.replace(ignoreExp, "");
-    while (s != "") {
-        int index = referenceExp.indexIn(s);
-        if (index == -1) {
-            // No reference exists.
-            link.isRef          = false;
-            link.text           = this->parseEscape(s);
-            link.refInfo.pageID = 0;
-            link.refInfo.textID = 0;
-            ret.append(link);
-            break;
-        } else {
-            // Reference found.
-            if (index > 0) {
-                // Before
-                link.isRef          = false;
-                link.text           = this->parseEscape(s.left(index));
-                link.refInfo.pageID = 0;
-                link.refInfo.textID = 0;
-                ret.append(link);
-            }
+    TextLink link;
 
-            // Reference
-            link.isRef          = true;
-            link.text           = "";
-            link.refInfo.pageID = referenceExp.cap(1).toInt();
-            link.refInfo.textID = referenceExp.cap(2).toInt();
-            ret.append(link);
+    if (store.ranges.empty()) {
+        store.ranges.append(0);
+    }
 
-            // After
-            s = s.mid(index + referenceExp.cap().size());
+    // Remove comment, from the first '(' to the last ')'.
+    QString str          = s;
+    int     commentBegin = str.indexOf('(');
+    int     commentEnd   = str.lastIndexOf(')');
+    if (commentBegin >= 0 && commentEnd > commentBegin) {
+        str.remove(commentBegin, commentEnd - commentBegin + 1);
+    }
+
+    // Scan references.
+    const QChar *data  = str.constData();
+    int          size  = str.size();
+    int          begin = 0;
+    for (int i = 0; i < size; ++i) {
+        qint32 pageID;
+        qint32 textID;
+        int    end;
+        if (data[i] != '{'
+            || ! GameTexts::matchReference(str, i, pageID, textID, end)) {
+            continue;
         }
+
+        // Before
+        if (i > begin) {
+            link.isRef = false;
+            link.first = store.pool.size();
+            this->parseEscape(str.midRef(begin, i - begin), store.pool);
+            link.second = store.pool.size() - link.first;
+            store.links.append(link);
+        }
+
+        // Reference
+        link.isRef  = true;
+        link.first  = pageID;
+        link.second = textID;
+        store.links.append(link);
+
+        begin = end;
+        i     = end - 1;
     }
 
-    return ret;
+    // After
+    if (begin < size) {
+        link.isRef = false;
+        link.first = store.pool.size();
+        this->parseEscape(str.midRef(begin), store.pool);
+        link.second = store.pool.size() - link.first;
+        store.links.append(link);
+    }
+
+    store.keys.append(key);
+    store.ranges.append(static_cast<quint32>(store.links.size()));
+}
+
+/**
+ * @brief		Match reference.
+ */
+bool GameTexts::matchReference(const QString &s,
+                               int            index,
+                               qint32 &       pageID,
+                               qint32 &       textID,
+                               int &          end)
+{
+    const QChar *data = s.constData();
+    int          size = s.size();
+    int          i    = index + 1;
+
+    // Skip white spaces.
+    auto skipSpaces = [&]() -> void {
+        while (i < size && data[i].isSpace()) {
+            ++i;
+        }
+    };
+
+    // Read number.
+    auto readNumber = [&](qint32 &number) -> bool {
+        int begin = i;
+        while (i < size && data[i].isDigit()) {
+            ++i;
+        }
+        if (i == begin) {
+            return false;
+        }
+        number = s.midRef(begin, i - begin).toInt();
+        return true;
+    };
+
+    // {page,text}
+    skipSpaces();
+    if (! readNumber(pageID)) {
+        return false;
+    }
+    skipSpaces();
+    if (i >= size || data[i] != ',') {
+        return false;
+    }
+    ++i;
+    skipSpaces();
+    if (! readNumber(textID)) {
+        return false;
+    }
+    skipSpaces();
+    if (i >= size || data[i] != '}') {
+        return false;
+    }
+    end = i + 1;
+
+    return true;
 }
 
 /**
  * @brief		Parse excape characters.
  */
-QString GameTexts::parseEscape(const QString &s)
+void GameTexts::parseEscape(const QStringRef &s, QString &ret)
 {
-    QString ret = "";
     for (auto iter = s.begin(); iter < s.end(); iter++) {
         if (*iter == '\\') {
             ++iter;
@@ -512,6 +1081,4 @@ QString GameTexts::parseEscape(const QString &s)
             ret.append(*iter);
         }
     }
-
-    return ret;
 }
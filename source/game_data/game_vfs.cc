@@ -1,19 +1,35 @@
 #include <atomic>
+#include <cstring>
 
 #include <QtCore/QCryptographicHash>
 #include <QtCore/QDateTime>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QReadLocker>
+#include <QtCore/QSaveFile>
 #include <QtCore/QWriteLocker>
 
 #include <common.h>
+#include <config.h>
 #include <game_data/game_vfs.h>
+#include <global.h>
 #include <locale/string_table.h>
 
+const char GameVFS::_indexCacheMagic[8]
+    = {'X', '4', 'S', 'C', 'V', 'F', 'S', 'I'};
+const quint32 GameVFS::_indexCacheVersion = 2;
+const quint32 GameVFS::_fileNode          = 0xFFFFFFFF;
+const quint32 GameVFS::_invalidIndex      = 0xFFFFFFFF;
+const char    GameVFS::_hashCacheMagic[8]
+    = {'X', '4', 'S', 'C', 'V', 'F', 'S', 'H'};
+const quint32 GameVFS::_hashCacheVersion = 1;
+const int     GameVFS::FileReader::_readAheadSize = 64 * 1024;
+
 /**
  * @brief		Constructor.
  */
@@ -21,136 +37,149 @@ GameVFS::GameVFS(const QString &                        gamePath,
                  const QMap<QString, CatFileInfo> &     info,
                  ::std::function<void(const QString &)> setTextFunc,
                  ::std::function<void(const QString &)> errFunc) :
-    m_gamePath(gamePath),
-    m_datEntry(new DatFileEntery("/"))
+    m_gamePath(gamePath), m_datEntry(new DatFileEntery("/")),
+    m_mapDatFiles(Config::instance()->getBool("/vfsMapDatFiles", true)),
+    m_verifyPolicy(VerifyPolicy::Now), m_hashCacheDirty(false),
+    m_verifyThread(nullptr), m_verifyThreadStop(false)
 {
-    QDir dir(gamePath);
-
-    // Load cat/dat files.
-    for (auto &catDatInfo : info) {
-        QFile catFile(dir.absoluteFilePath(catDatInfo.cat));
-        if (! catFile.open(QIODevice::OpenModeFlag::ReadOnly
-                           | QIODevice::OpenModeFlag::ExistingOnly)) {
-            qDebug() << "Failed to open file :" << catFile.fileName() << ".";
-            errFunc(STR("STR_FAILED_OPEN_FILE").arg(catFile.fileName()));
+    QDir                  dir(gamePath);
+    QVector<CatFileStamp> stamps = this->catFileStamps(dir, info);
+    for (auto &stamp : stamps) {
+        m_datModified[dir.absoluteFilePath(stamp.dat)] = stamp.datModified;
+    }
 
-            return;
+    // Fingerprints.
+    QByteArray  stampData;
+    QByteArray  baseStampData;
+    QDataStream stampStream(&stampData, QIODevice::OpenModeFlag::WriteOnly);
+    QDataStream baseStampStream(&baseStampData,
+                                QIODevice::OpenModeFlag::WriteOnly);
+    stampStream.setVersion(QDataStream::Version::Qt_5_14);
+    baseStampStream.setVersion(QDataStream::Version::Qt_5_14);
+    stampStream << gamePath;
+    baseStampStream << gamePath;
+    for (auto &stamp : stamps) {
+        stampStream << stamp.cat << stamp.catSize << stamp.catModified
+                    << stamp.dat << stamp.datSize << stamp.datModified;
+        if (! stamp.cat.startsWith("extensions/")) {
+            baseStampStream << stamp.cat << stamp.catSize << stamp.catModified
+                            << stamp.dat << stamp.datSize
+                            << stamp.datModified;
         }
-
-        quint64 printTm = 0;
-        quint64 total   = 0;
-
-        // Open dat file.
-        QFile datFile(dir.absoluteFilePath(catDatInfo.dat));
-        if (! datFile.open(QIODevice::OpenModeFlag::ReadOnly
-                           | QIODevice::OpenModeFlag::ExistingOnly)) {
-            qDebug() << "Failed to open file :" << datFile.fileName() << ".";
-            errFunc(STR("STR_FAILED_OPEN_FILE").arg(datFile.fileName()));
+    }
+    m_fingerprint = QCryptographicHash::hash(
+        stampData, QCryptographicHash::Algorithm::Sha1);
+    m_baseFingerprint = QCryptographicHash::hash(
+        baseStampData, QCryptographicHash::Algorithm::Sha1);
+
+    // Verify policy.
+    QString verifyPolicy
+        = Config::instance()->getString("/vfsVerifyPolicy", "now");
+    if (verifyPolicy == "background") {
+        m_verifyPolicy = VerifyPolicy::Background;
+        m_verifyThread = ::std::unique_ptr<SimpleThread>(new SimpleThread(
+            ::std::bind(&GameVFS::verifyThread, this)));
+        m_verifyThread->start(QThread::Priority::LowestPriority);
+    } else if (verifyPolicy == "cache") {
+        m_verifyPolicy = VerifyPolicy::Cache;
+        this->loadHashCache();
+    } else {
+        m_verifyPolicy = VerifyPolicy::Now;
+    }
+    qDebug() << "Verify policy of packed files :" << verifyPolicy << ".";
+
+    // Load index cache.
+    bool useIndexCache = Config::instance()->getBool("/vfsIndexCache", true);
+    if (useIndexCache) {
+        setTextFunc(STR("STR_LOADING_VFS_INDEX_CACHE"));
+        if (this->loadIndexCache(stamps)) {
+            this->buildPathIndex();
+            this->setInitialized();
             return;
         }
+    }
 
-        setTextFunc(STR("STR_LOADING_CAT_DAT_FILE")
-                        .arg(catDatInfo.cat)
-                        .arg(catDatInfo.dat)
-                        .arg(total)
-                        .arg(datFile.size()));
-
-        // Scan cat file.
-        while (! catFile.atEnd()) {
-            // Get file info
-            QString line = catFile.readLine();
-            line.remove(QChar('\r'));
-            line.remove(QChar('\n'));
-            if (line == "") {
-                continue;
-            }
-
-            QStringList splittedLine = this->splitCatLine(line);
-            if (splittedLine.size() != 4) {
-                qDebug() << "Broken cat file :" << catFile.fileName();
-                errFunc(STR("STR_FILE_BROKEN").arg(catFile.fileName()));
-                return;
+    // Load cat/dat files.
+    QVector<CatFileInfo>                      catDatInfos;
+    QVector<::std::shared_ptr<DatFileEntery>> partialEntries;
+    QVector<QString>                          errors;
+    int                                       nextIndex = 0;
+    QMutex                                    nextIndexLock;
+    ::std::atomic<int>                        finishedCount;
+    ::std::atomic<bool>                       failed;
+    catDatInfos = info.values().toVector();
+    partialEntries.resize(catDatInfos.size());
+    errors.resize(catDatInfos.size());
+    finishedCount = 0;
+    failed        = false;
+
+    MultiRun scanTask(::std::function<void()>([&]() -> void {
+        while (true) {
+            // Get cat file
+            int index;
+            {
+                QMutexLocker locker(&nextIndexLock);
+                if (nextIndex >= catDatInfos.size() || failed) {
+                    return;
+                } else {
+                    index = nextIndex;
+                    nextIndex += 1;
+                }
             }
 
-            quint64 size   = splittedLine[1].toULongLong();
-            quint64 offset = total;
-            total += size;
-
-            if ((qint64)(datFile.size()) < (qint64)size + (qint64)offset) {
-                qDebug() << "Broken dat file :" << datFile.fileName();
-                errFunc(STR("STR_FILE_BROKEN").arg(datFile.fileName()));
+            // Scan cat file into a partial tree.
+            const CatFileInfo &catDatInfo = catDatInfos[index];
+            auto progressFunc = [&](quint64 loaded, quint64 total) -> void {
+                setTextFunc(STR("STR_LOADING_CAT_DAT_FILES")
+                                .arg(catDatInfo.cat)
+                                .arg(catDatInfo.dat)
+                                .arg(loaded)
+                                .arg(total)
+                                .arg(finishedCount.load())
+                                .arg(catDatInfos.size()));
+            };
+            ::std::shared_ptr<DatFileEntery> entry(new DatFileEntery("/"));
+            if (! this->scanCatFile(dir, catDatInfo, entry, progressFunc,
+                                    errors[index])) {
+                failed = true;
                 return;
             }
-
-            // Append file
-            // Split path
-            auto basename = catDatInfo.cat.split(
-                '/', Qt::SplitBehaviorFlags::SkipEmptyParts);
-            basename.pop_back();
-            auto splittedPath
-                = basename
-                  + splittedLine[0].split(
-                      '/', Qt::SplitBehaviorFlags::SkipEmptyParts);
-            if (splittedPath.empty()) {
+            partialEntries[index] = entry;
+            finishedCount += 1;
+        }
+    }));
+    scanTask.run(! Config::instance()->getBool("/vfsParallelScan", true));
+
+    // Report the first error in override order.
+    if (failed) {
+        for (auto &err : errors) {
+            if (! err.isEmpty()) {
+                errFunc(err);
                 break;
             }
+        }
+        return;
+    }
 
-            // Parent
-            ::std::shared_ptr<DatFileEntery> entry = m_datEntry;
-
-            QString path = "";
-            for (auto iter = splittedPath.begin();
-                 iter < splittedPath.end() - 1; iter++) {
-                path += *iter + "/";
-                {
-                    QMutexLocker locker(&(entry->lock));
-                    auto         pathIter = entry->children.find(*iter);
-                    if (pathIter == entry->children.end()) {
-                        // Create new
-                        pathIter = entry->children.find(*iter);
-                        entry->children[*iter]
-                            = ::std::shared_ptr<DatFileEntery>(
-                                new DatFileEntery(*iter));
-                        entry = entry->children[*iter];
-                    } else {
-                        entry = *pathIter;
-                    }
-                }
-                if (! entry->isDirectory) {
-                    qDebug() << "Broken cat file :" << catFile.fileName();
-                    errFunc(STR("STR_FILE_BROKEN").arg(catFile.fileName()));
-                    return;
-                }
-            }
+    // Merge partial trees in override order.
+    for (int i = 0; i < partialEntries.size(); ++i) {
+        if (! this->mergeEntry(m_datEntry, partialEntries[i])) {
+            qDebug() << "Broken cat file :" << catDatInfos[i].cat;
+            errFunc(STR("STR_FILE_BROKEN")
+                        .arg(dir.absoluteFilePath(catDatInfos[i].cat)));
+            return;
+        }
+    }
 
-            // File
-            entry->children[splittedPath.back()]
-                = ::std::shared_ptr<DatFileEntery>(
-                    new DatFileEntery(splittedPath.back(), datFile.fileName(),
-                                      offset, size, splittedLine.back()));
-            path += splittedPath.back();
-            qDebug() << "Packed file loaded from " << catDatInfo.cat << ":"
-                     << path << ".";
+    // Compact enteries.
+    this->compactEntries();
 
-            {
-                quint64 tm = QDateTime::currentMSecsSinceEpoch();
-                if (tm - printTm > 150) {
-                    printTm = tm;
-                    setTextFunc(STR("STR_LOADING_CAT_DAT_FILE")
-                                    .arg(catDatInfo.cat)
-                                    .arg(catDatInfo.dat)
-                                    .arg(total)
-                                    .arg(datFile.size()));
-                }
-            }
-        }
-        setTextFunc(STR("STR_LOADING_CAT_DAT_FILE")
-                        .arg(catDatInfo.cat)
-                        .arg(catDatInfo.dat)
-                        .arg(total)
-                        .arg(datFile.size()));
+    // Save index cache.
+    if (useIndexCache) {
+        this->saveIndexCache(stamps);
     }
 
+    this->buildPathIndex();
     this->setInitialized();
 }
 
@@ -198,66 +227,36 @@ GameVFS::GameVFS(const QString &                        gamePath,
     }
 
     // Search
-    QStringList splittedPath
-        = path.split('/', Qt::SplitBehaviorFlags::SkipEmptyParts);
+    quint32 node = this->findNode(path);
+    if (node == _invalidIndex || m_nodes.at(node).isDirectory()) {
+        return nullptr;
+    }
+    const PackedFile &packedFile = m_packedFiles.at(m_nodes.at(node).index);
 
-    ::std::shared_ptr<DatFileEntery> entry = m_datEntry;
-    for (auto name : splittedPath) {
-        if (! entry->isDirectory) {
-            return nullptr;
-        }
+    // Verify file.
+    if (! this->verifyFile(m_nodes.at(node).index)) {
+        return nullptr;
+    }
 
-        auto pathIter = entry->children.find(name);
-        if (pathIter == entry->children.end()) {
-            bool found = false;
-            for (auto &key : entry->children.keys()) {
-                if (key.toLower() == name.toLower()) {
-                    entry = entry->children[key];
-                    found = true;
-                    break;
-                }
-            }
-            if (! found) {
-                return nullptr;
-            }
-        } else {
-            entry = *pathIter;
+    // Read from mapped dat file.
+    if (m_mapDatFiles) {
+        ::std::shared_ptr<MappedDatFile> mappedFile
+            = this->mapDatFile(m_datNames.at(packedFile.dat));
+        if (mappedFile != nullptr) {
+            return ::std::shared_ptr<FileReader>(
+                new PackedFileReader(path, mappedFile, packedFile.offset,
+                                     packedFile.size, m_this.lock()));
         }
     }
-    if (entry->isDirectory) {
-        return nullptr;
-    }
 
     // Open dat file
     ::std::unique_ptr<QFile> file(
-        new QFile(dir.absoluteFilePath(entry->fileInfo.datName)));
+        new QFile(dir.absoluteFilePath(m_datNames.at(packedFile.dat))));
     if (file->open(QIODevice::OpenModeFlag::ReadOnly
                    | QIODevice::OpenModeFlag::ExistingOnly)) {
-        QMutexLocker locker(&(entry->lock));
-        if (! entry->fileInfo.checked) {
-            // Check hash.
-            QCryptographicHash hash(QCryptographicHash::Algorithm::Md5);
-
-            // Checksum
-            if (entry->fileInfo.size != 0) {
-                // Get hash
-                hash.reset();
-                uchar *data
-                    = file->map(entry->fileInfo.offset, entry->fileInfo.size);
-                hash.addData((const char *)data, entry->fileInfo.size);
-                file->unmap(data);
-
-                // Check
-                if (hash.result().toHex() != entry->fileInfo.hash) {
-                    return nullptr;
-                }
-            }
-            entry->fileInfo.checked = true;
-        }
-
-        return ::std::shared_ptr<FileReader>(new PackedFileReader(
-            path, ::std::move(file), entry->fileInfo.offset,
-            entry->fileInfo.size, m_this.lock()));
+        return ::std::shared_ptr<FileReader>(
+            new PackedFileReader(path, ::std::move(file), packedFile.offset,
+                                 packedFile.size, m_this.lock()));
     }
 
     return nullptr;
@@ -280,39 +279,105 @@ GameVFS::GameVFS(const QString &                        gamePath,
     }
 
     // Search dat files.
-    QStringList splittedPath
-        = path.split('/', Qt::SplitBehaviorFlags::SkipEmptyParts);
-
-    ::std::shared_ptr<DatFileEntery> entry = m_datEntry;
-    for (auto name : splittedPath) {
-        if (! entry->isDirectory) {
+    quint32 node = this->findNode(path);
+    if (node == _invalidIndex) {
+        if (exists) {
+            return ::std::shared_ptr<DirReader>(
+                new DirReader(path, _invalidIndex, m_this.lock()));
+        } else {
             return nullptr;
         }
-
-        auto pathIter = entry->children.find(name);
-        if (pathIter == entry->children.end()) {
-            if (exists) {
-                return ::std::shared_ptr<DirReader>(
-                    new DirReader(path, nullptr, m_this.lock()));
-            } else {
-                return nullptr;
-            }
-        }
-        entry = *pathIter;
     }
 
-    if (! entry->isDirectory) {
+    if (! m_nodes.at(node).isDirectory()) {
         return nullptr;
     }
 
     return ::std::shared_ptr<DirReader>(
-        new DirReader(path, entry, m_this.lock()));
+        new DirReader(path, node, m_this.lock()));
+}
+
+/**
+ * @brief		Get fingerprint of the cat/dat files.
+ */
+const QByteArray &GameVFS::fingerprint() const
+{
+    return m_fingerprint;
+}
+
+/**
+ * @brief		Get fingerprint of the cat/dat files of the base game.
+ */
+const QByteArray &GameVFS::baseFingerprint() const
+{
+    return m_baseFingerprint;
+}
+
+/**
+ * @brief		Save hashes verified into hash cache.
+ */
+void GameVFS::saveHashCache()
+{
+    if (m_verifyPolicy != VerifyPolicy::Cache) {
+        return;
+    }
+
+    QMutexLocker locker(&m_hashCacheLock);
+
+    // Drop the hashes of the dat files which have been removed or modified,
+    // the key ends with the offset, size and modify time of the dat file.
+    for (auto iter = m_hashCache.begin(); iter != m_hashCache.end();) {
+        auto datIter = m_datModified.constFind(iter.key().section(':', 0, -4));
+        if (datIter == m_datModified.constEnd()
+            || iter.key().section(':', -1) != QString::number(*datIter)) {
+            iter             = m_hashCache.erase(iter);
+            m_hashCacheDirty = true;
+        } else {
+            ++iter;
+        }
+    }
+
+    if (! m_hashCacheDirty) {
+        return;
+    }
+
+    QSaveFile file(this->hashCachePath());
+    if (! file.open(QIODevice::OpenModeFlag::WriteOnly)) {
+        qWarning() << "Failed to open file :" << file.fileName() << ".";
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Version::Qt_5_14);
+    stream.writeRawData(_hashCacheMagic, sizeof(_hashCacheMagic));
+    stream << _hashCacheVersion << m_hashCache;
+
+    if (stream.status() != QDataStream::Status::Ok || ! file.commit()) {
+        qWarning() << "Failed to write hash cache :" << file.fileName()
+                   << ".";
+        return;
+    }
+    m_hashCacheDirty = false;
+    qDebug() << "Hash cache of vfs saved :" << file.fileName() << ".";
 }
 
 /**
  * @brief	Destructor.
  */
-GameVFS::~GameVFS() {}
+GameVFS::~GameVFS()
+{
+    // Stop verify thread.
+    if (m_verifyThread != nullptr) {
+        {
+            QMutexLocker locker(&m_verifyQueueLock);
+            m_verifyThreadStop = true;
+            m_verifyQueueCond.wakeAll();
+        }
+        m_verifyThread->wait();
+    }
+
+    this->saveHashCache();
+}
 
 /**
  * @brief		Open directory.
@@ -396,183 +461,1377 @@ QStringList GameVFS::splitCatLine(const QString &line)
 }
 
 /**
- * @brief		Constructor.
+ * @brief		Build path index.
  */
-GameVFS::FileReader::FileReader(const QString &            path,
-                                ::std::shared_ptr<GameVFS> vfs) :
-    m_path(path.split('/', Qt::SplitBehaviorFlags::SkipEmptyParts)),
-    m_name(m_path.back()), m_vfs(vfs)
-{}
+void GameVFS::buildPathIndex()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Capacity is a power of 2 and at least twice of the count of nodes.
+    int capacity = 16;
+    while (capacity < m_nodes.size() * 2) {
+        capacity *= 2;
+    }
+    m_pathIndex.fill({0, _invalidIndex}, capacity);
+    m_foldedPathIndex.fill({0, _invalidIndex}, capacity);
+
+    for (quint32 parent = 0; parent < (quint32)(m_nodes.size()); ++parent) {
+        const CompactNode &dirNode = m_nodes.at(parent);
+        if (! dirNode.isDirectory()) {
+            continue;
+        }
+
+        // Children are in the order of names, so if names differ only in
+        // case, the first one in order is used.
+        for (quint32 i = dirNode.index; i < dirNode.index + dirNode.count;
+             ++i) {
+            this->insertPathIndex(m_pathIndex, parent, i, false);
+            this->insertPathIndex(m_foldedPathIndex, parent, i, true);
+        }
+    }
+
+    qDebug() << "Path index of vfs built," << m_nodes.size()
+             << "enteries indexed in" << timer.elapsed() << "ms,"
+             << capacity * 2 * sizeof(PathIndexEntry) << "bytes used.";
+}
 
 /**
- * @brief	Get path of the file.
+ * @brief		Look up node in path index.
  */
-QString GameVFS::FileReader::path() const
+quint32 GameVFS::findNode(const QString &path)
 {
-    QString ret = "";
-    for (auto &n : m_path) {
-        ret += "/";
-        ret += n;
-    }
+    const QChar *iter = path.constData();
+    const QChar *end  = iter + path.size();
+    quint32      node = 0;
+    while (true) {
+        // Skip separators.
+        while (iter != end && (*iter == '/' || *iter == '\\')) {
+            ++iter;
+        }
+        if (iter == end) {
+            return node;
+        }
 
-    return ret;
+        // Name.
+        const QChar *name = iter;
+        while (iter != end && *iter != '/' && *iter != '\\') {
+            ++iter;
+        }
+        int size = (int)(iter - name);
+
+        if (! m_nodes.at(node).isDirectory()) {
+            return _invalidIndex;
+        }
+
+        // The name matches exactly wins in each directory.
+        quint32 child
+            = this->findPathIndex(m_pathIndex, node, name, size, false);
+        if (child == _invalidIndex) {
+            child = this->findPathIndex(m_foldedPathIndex, node, name, size,
+                                        true);
+            if (child == _invalidIndex) {
+                return _invalidIndex;
+            }
+        }
+        node = child;
+    }
 }
 
 /**
- * @brief	Get name of the file.
+ * @brief		Hash of the key of path index.
  */
-const QString &GameVFS::FileReader::name() const
+uint GameVFS::pathIndexHash(quint32      parent,
+                            const QChar *name,
+                            int          size,
+                            bool         folded)
 {
-    return m_name;
+    uint ret = parent * 2654435761U;
+    for (const QChar *iter = name; iter != name + size; ++iter) {
+        ushort c = folded ? iter->toCaseFolded().unicode() : iter->unicode();
+        ret      = (ret ^ c) * 16777619U;
+    }
+
+    return ret;
 }
 
 /**
- * @brief		Read a line.
+ * @brief		Compare the name of node.
  */
-QByteArray GameVFS::FileReader::readLine()
+bool GameVFS::nodeNameEquals(quint32      node,
+                             const QChar *name,
+                             int          size,
+                             bool         folded) const
 {
-    QByteArray array;
-    for (auto c = this->read(1); c.size() != 0; c = this->read(1)) {
-        array.append(c[0]);
-        if (c[0] == '\n') {
-            break;
+    const CompactNode &compactNode = m_nodes.at(node);
+    if (compactNode.nameSize != (quint32)size) {
+        return false;
+    }
+
+    const QChar *nodeName = m_namePool.constData() + compactNode.name;
+    for (int i = 0; i < size; ++i) {
+        if (folded ? nodeName[i].toCaseFolded() != name[i].toCaseFolded()
+                   : nodeName[i] != name[i]) {
+            return false;
         }
     }
 
-    return array;
+    return true;
 }
 
 /**
- * @brief	Destructor.
- *
+ * @brief		Insert node into path index.
  */
-GameVFS::FileReader::~FileReader() {}
+void GameVFS::insertPathIndex(QVector<PathIndexEntry> &index,
+                              quint32                  parent,
+                              quint32                  node,
+                              bool                     folded)
+{
+    const CompactNode &compactNode = m_nodes.at(node);
+    const QChar *      name        = m_namePool.constData() + compactNode.name;
+    int                size        = (int)(compactNode.nameSize);
+    uint               mask        = (uint)(index.size() - 1);
+    for (uint pos = GameVFS::pathIndexHash(parent, name, size, folded) & mask;;
+         pos      = (pos + 1) & mask) {
+        PathIndexEntry &entry = index[pos];
+        if (entry.node == _invalidIndex) {
+            entry = {parent, node};
+            return;
+        } else if (entry.parent == parent
+                   && this->nodeNameEquals(entry.node, name, size, folded)) {
+            return;
+        }
+    }
+}
 
 /**
- * @brief		Constructor.
+ * @brief		Find child node in path index.
  */
-GameVFS::PackedFileReader::PackedFileReader(const QString &            path,
-                                            ::std::unique_ptr<QFile>   file,
-                                            quint64                    offset,
-                                            quint64                    size,
-                                            ::std::shared_ptr<GameVFS> vfs) :
-    GameVFS::FileReader(path, vfs),
-    m_file(::std::move(file)), m_offset(offset), m_size(size)
+quint32 GameVFS::findPathIndex(const QVector<PathIndexEntry> &index,
+                               quint32                        parent,
+                               const QChar *                  name,
+                               int                            size,
+                               bool                           folded) const
 {
-    m_file->seek(m_offset);
+    const PathIndexEntry *entries = index.constData();
+    uint                  mask    = (uint)(index.size() - 1);
+    for (uint pos = GameVFS::pathIndexHash(parent, name, size, folded) & mask;;
+         pos      = (pos + 1) & mask) {
+        const PathIndexEntry &entry = entries[pos];
+        if (entry.node == _invalidIndex) {
+            return _invalidIndex;
+        } else if (entry.parent == parent
+                   && this->nodeNameEquals(entry.node, name, size, folded)) {
+            return entry.node;
+        }
+    }
 }
 
 /**
- * @brief		Read file.
+ * @brief		Get name of node.
  */
-qint64 GameVFS::PackedFileReader::read(void *buffer, quint64 size)
+QString GameVFS::nodeName(quint32 node) const
 {
-    size = min(size, m_offset + m_size - m_file->pos());
-    return m_file->read((char *)buffer, size);
+    const CompactNode &compactNode = m_nodes.at(node);
+    return QString(m_namePool.constData() + compactNode.name,
+                   compactNode.nameSize);
 }
 
 /**
- * @brief		Read file.
+ * @brief		Compact the tree of \c m_datEntry into node arrays.
  */
-QByteArray GameVFS::PackedFileReader::read(quint64 size)
+void GameVFS::compactEntries()
 {
-    size = min(size, m_offset + m_size - m_file->pos());
-    return m_file->read(size);
+    QElapsedTimer timer;
+    timer.start();
+
+    m_nodes.clear();
+    m_packedFiles.clear();
+    m_namePool.clear();
+    m_datNames.clear();
+
+    QHash<QString, quint32> nameIndex;
+    QHash<QString, quint32> datIndex;
+    quint64                 treeSize = 0;
+
+    // Append node, children of the node are appended later.
+    auto appendNode
+        = [&](const ::std::shared_ptr<DatFileEntery> &entry) -> void {
+        CompactNode node;
+
+        // Same names share the space in name pool.
+        auto nameIter = nameIndex.find(entry->name);
+        if (nameIter == nameIndex.end()) {
+            nameIter
+                = nameIndex.insert(entry->name, (quint32)(m_namePool.size()));
+            m_namePool.append(entry->name);
+        }
+        node.name     = *nameIter;
+        node.nameSize = (quint32)(entry->name.size());
+
+        if (entry->isDirectory) {
+            node.index = _invalidIndex;
+            node.count = (quint32)(entry->children.size());
+
+        } else {
+            auto datIter = datIndex.find(entry->fileInfo.datName);
+            if (datIter == datIndex.end()) {
+                datIter = datIndex.insert(entry->fileInfo.datName,
+                                          (quint32)(m_datNames.size()));
+                m_datNames.append(entry->fileInfo.datName);
+            }
+
+            PackedFile file;
+            QByteArray hash
+                = QByteArray::fromHex(entry->fileInfo.hash.toLatin1());
+            file.node   = (quint32)(m_nodes.size());
+            file.dat    = *datIter;
+            file.offset = entry->fileInfo.offset;
+            file.size   = entry->fileInfo.size;
+            ::memset(file.hash, 0, sizeof(file.hash));
+            ::memcpy(file.hash, hash.constData(),
+                     min((size_t)(hash.size()), sizeof(file.hash)));
+
+            node.index = (quint32)(m_packedFiles.size());
+            node.count = _fileNode;
+            m_packedFiles.append(file);
+        }
+        m_nodes.append(node);
+
+        // Entery, control block, node in the map of parent and strings.
+        treeSize += sizeof(DatFileEntery) + sizeof(::std::shared_ptr<void>) * 3
+                    + sizeof(QString) + sizeof(void *) * 3
+                    + (entry->name.size() * 2 + entry->fileInfo.hash.size())
+                          * sizeof(QChar);
+    };
+
+    // Breadth-first, so children of each directory are continuous.
+    QQueue<::std::shared_ptr<DatFileEntery>> queue;
+    appendNode(m_datEntry);
+    queue.enqueue(m_datEntry);
+    for (quint32 current = 0; ! queue.empty(); ++current) {
+        ::std::shared_ptr<DatFileEntery> entry = queue.dequeue();
+        if (entry->isDirectory) {
+            m_nodes[current].index = (quint32)(m_nodes.size());
+            for (auto &child : entry->children) {
+                appendNode(child);
+                queue.enqueue(child);
+            }
+        }
+    }
+
+    m_nodes.squeeze();
+    m_packedFiles.squeeze();
+    m_namePool.squeeze();
+    m_fileStates.fill(FileState::Unchecked, m_packedFiles.size());
+    m_datEntry = nullptr;
+
+    qDebug() << "Enteries of vfs compacted," << m_nodes.size() << "nodes,"
+             << m_packedFiles.size() << "files," << this->compactSize()
+             << "bytes used, about" << treeSize << "bytes used by the tree,"
+             << "finished in" << timer.elapsed() << "ms.";
 }
 
 /**
- * @brief		Read all data after corrent position in the file.
+ * @brief		Get memory used by compacted enteries.
  */
-QByteArray GameVFS::PackedFileReader::readAll()
+quint64 GameVFS::compactSize() const
 {
-    quint64 size = m_offset + m_size - m_file->pos();
-    return m_file->read(size);
+    quint64 ret = m_nodes.size() * sizeof(CompactNode)
+                  + m_packedFiles.size() * sizeof(PackedFile)
+                  + m_fileStates.size() * sizeof(FileState)
+                  + m_namePool.size() * sizeof(QChar);
+    for (auto &datName : m_datNames) {
+        ret += sizeof(QString) + datName.size() * sizeof(QChar);
+    }
+
+    return ret;
 }
 
 /**
- * @brief		Seek file.
+ * @brief		Map dat file into memory.
  */
-qint64 GameVFS::PackedFileReader::seek(qint64 offset, Whence whence)
+::std::shared_ptr<GameVFS::MappedDatFile>
+    GameVFS::mapDatFile(const QString &datName)
 {
-    qint64 pos;
-    switch (whence) {
-        case Whence::Set:
-            pos = m_offset;
-            break;
-
-        case Whence::Current:
-            pos = m_file->pos();
-            break;
+    QMutexLocker locker(&m_mappedDatFilesLock);
+    auto         iter = m_mappedDatFiles.find(datName);
+    if (iter != m_mappedDatFiles.end()) {
+        return *iter;
+    }
 
-        case Whence::End:
-            pos = m_offset + m_size;
-            break;
+    // Map whole file.
+    ::std::shared_ptr<MappedDatFile> ret = nullptr;
+    ::std::unique_ptr<QFile>         file(
+        new QFile(QDir(m_gamePath).absoluteFilePath(datName)));
+    if (file->open(QIODevice::OpenModeFlag::ReadOnly
+                   | QIODevice::OpenModeFlag::ExistingOnly)) {
+        qint64 size = file->size();
+        uchar *data = file->map(0, size);
+        if (data != nullptr) {
+            ret = ::std::shared_ptr<MappedDatFile>(
+                new MappedDatFile(::std::move(file), data, size));
+            qDebug() << "Dat file mapped :" << datName << ".";
+        } else {
+            qDebug() << "Failed to map dat file :" << datName
+                     << ", fallback to reading.";
+        }
     }
 
-    pos += offset;
-    pos = min(pos, (qint64)(m_offset + m_size));
-    m_file->seek(pos);
+    // Failed files are also recorded to avoid retrying.
+    m_mappedDatFiles[datName] = ret;
 
-    return m_file->pos() - m_offset;
+    return ret;
 }
 
 /**
- * @brief		Check if current position is at the end of current file.
+ * @brief		Check hash of packed file.
  */
-bool GameVFS::PackedFileReader::atEnd()
+bool GameVFS::checkHash(const PackedFile &file, const char *data)
 {
-    return (quint64)(m_file->pos()) >= m_offset + m_size;
+    if (file.size == 0) {
+        return true;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Algorithm::Md5);
+    hash.addData(data, file.size);
+
+    return ::memcmp(hash.result().constData(), file.hash, sizeof(file.hash))
+           == 0;
 }
 
 /**
- * @brief	Destructor.
+ * @brief		Read the data of packed file and check hash.
  */
-GameVFS::PackedFileReader::~PackedFileReader() {}
+bool GameVFS::checkFile(const PackedFile &file)
+{
+    if (file.size == 0) {
+        return true;
+    }
 
-/**
- * @brief		Constructor.
- */
-GameVFS::NormalFileReader::NormalFileReader(const QString &            path,
-                                            ::std::unique_ptr<QFile>   file,
-                                            ::std::shared_ptr<GameVFS> vfs) :
-    GameVFS::FileReader(path, vfs),
-    m_file(::std::move(file))
-{}
+    // Mapped dat file.
+    if (m_mapDatFiles) {
+        ::std::shared_ptr<MappedDatFile> mappedFile
+            = this->mapDatFile(m_datNames.at(file.dat));
+        if (mappedFile != nullptr) {
+            return this->checkHash(
+                file, (const char *)(mappedFile->data) + file.offset);
+        }
+    }
+
+    // Map the file.
+    QFile datFile(QDir(m_gamePath).absoluteFilePath(m_datNames.at(file.dat)));
+    if (! datFile.open(QIODevice::OpenModeFlag::ReadOnly
+                       | QIODevice::OpenModeFlag::ExistingOnly)) {
+        return false;
+    }
+    uchar *data = datFile.map(file.offset, file.size);
+    if (data == nullptr) {
+        return false;
+    }
+    bool ret = this->checkHash(file, (const char *)data);
+    datFile.unmap(data);
+
+    return ret;
+}
 
 /**
- * @brief		Read file.
+ * @brief		Verify packed file according to verify policy.
  */
-qint64 GameVFS::NormalFileReader::read(void *buffer, quint64 size)
+bool GameVFS::verifyFile(quint32 file)
 {
-    return m_file->read((char *)buffer, size);
+    const PackedFile &packedFile = m_packedFiles.at(file);
+    QMutexLocker      locker(&m_fileStatesLock);
+    if (m_fileStates[file] == FileState::Broken) {
+        return false;
+    } else if (m_fileStates[file] == FileState::Checked) {
+        return true;
+    }
+
+    bool ret;
+    switch (m_verifyPolicy) {
+        case VerifyPolicy::Background: {
+            // Verify later, the file is treated as checked until the
+            // background thread finds it broken.
+            m_fileStates[file] = FileState::Checked;
+            locker.unlock();
+            QMutexLocker queueLocker(&m_verifyQueueLock);
+            m_verifyQueue.enqueue(file);
+            m_verifyQueueCond.wakeAll();
+            return true;
+        }
+
+        case VerifyPolicy::Cache: {
+            locker.unlock();
+            QString key  = this->hashCacheKey(packedFile);
+            QString hash = QString::fromLatin1(
+                QByteArray::fromRawData(packedFile.hash,
+                                        sizeof(packedFile.hash))
+                    .toHex());
+            QMutexLocker cacheLocker(&m_hashCacheLock);
+            auto         iter = m_hashCache.find(key);
+            if (iter != m_hashCache.end() && *iter == hash) {
+                ret = true;
+            } else {
+                cacheLocker.unlock();
+                ret = this->checkFile(packedFile);
+                if (ret) {
+                    cacheLocker.relock();
+                    m_hashCache[key] = hash;
+                    m_hashCacheDirty = true;
+                }
+            }
+        } break;
+
+        case VerifyPolicy::Now:
+        default:
+            locker.unlock();
+            ret = this->checkFile(packedFile);
+            break;
+    }
+
+    locker.relock();
+    m_fileStates[file] = ret ? FileState::Checked : FileState::Broken;
+
+    return ret;
 }
 
 /**
- * @brief		Read file.
+ * @brief		Get key of hash cache.
  */
-QByteArray GameVFS::NormalFileReader::read(quint64 size)
+QString GameVFS::hashCacheKey(const PackedFile &file)
 {
-    return m_file->read(size);
+    return QString("%1:%2:%3:%4")
+        .arg(m_datNames.at(file.dat))
+        .arg(file.offset)
+        .arg(file.size)
+        .arg(m_datModified.value(m_datNames.at(file.dat), -1));
 }
 
 /**
- * @brief		Read all data after corrent position in the file.
+ * @brief		Get path of hash cache file.
  */
-QByteArray GameVFS::NormalFileReader::readAll()
+QString GameVFS::hashCachePath()
 {
-    return m_file->readAll();
+    return QDir(Global::instance()->cacheDir())
+        .absoluteFilePath("vfs_hashes.cache");
 }
 
 /**
- * @brief		Seek file.
+ * @brief		Load hash cache.
  */
-qint64 GameVFS::NormalFileReader::seek(qint64 offset, Whence whence)
+void GameVFS::loadHashCache()
 {
-    qint64 pos;
-    switch (whence) {
-        case Whence::Set:
-            pos = 0;
-            break;
+    QFile file(this->hashCachePath());
+    if (! file.open(QIODevice::OpenModeFlag::ReadOnly
+                    | QIODevice::OpenModeFlag::ExistingOnly)) {
+        qDebug() << "Hash cache of vfs does not exist.";
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Version::Qt_5_14);
+
+    char    magic[sizeof(_hashCacheMagic)];
+    quint32 version;
+    if (stream.readRawData(magic, sizeof(magic)) != sizeof(magic)
+        || ::memcmp(magic, _hashCacheMagic, sizeof(magic)) != 0) {
+        qDebug() << "Illegal hash cache :" << file.fileName() << ".";
+        return;
+    }
+    stream >> version;
+    if (version != _hashCacheVersion) {
+        qDebug() << "Version of hash cache mismatch.";
+        return;
+    }
+
+    QMutexLocker locker(&m_hashCacheLock);
+    stream >> m_hashCache;
+    if (stream.status() != QDataStream::Status::Ok) {
+        qDebug() << "Illegal hash cache :" << file.fileName() << ".";
+        m_hashCache.clear();
+        return;
+    }
+    qDebug() << m_hashCache.size()
+             << "verified hashes loaded from hash cache.";
+}
+
+/**
+ * @brief		Background verify thread.
+ */
+void GameVFS::verifyThread()
+{
+    while (true) {
+        // Get file.
+        quint32 file;
+        {
+            QMutexLocker locker(&m_verifyQueueLock);
+            while (m_verifyQueue.empty() && ! m_verifyThreadStop) {
+                m_verifyQueueCond.wait(&m_verifyQueueLock);
+            }
+            if (m_verifyThreadStop) {
+                return;
+            }
+            file = m_verifyQueue.dequeue();
+        }
+
+        // Check file.
+        const PackedFile &packedFile = m_packedFiles.at(file);
+        if (! this->checkFile(packedFile)) {
+            QMutexLocker locker(&m_fileStatesLock);
+            m_fileStates[file] = FileState::Broken;
+            qWarning() << "Packed file" << this->nodeName(packedFile.node)
+                       << "is broken, it will not be opened again.";
+        }
+    }
+}
+
+/**
+ * @brief		Scan cat file.
+ */
+bool GameVFS::scanCatFile(const QDir &                            dir,
+                          const CatFileInfo &                     catDatInfo,
+                          ::std::shared_ptr<DatFileEntery>        root,
+                          ::std::function<void(quint64, quint64)> progressFunc,
+                          QString &                               err)
+{
+    QFile catFile(dir.absoluteFilePath(catDatInfo.cat));
+    if (! catFile.open(QIODevice::OpenModeFlag::ReadOnly
+                       | QIODevice::OpenModeFlag::ExistingOnly)) {
+        qDebug() << "Failed to open file :" << catFile.fileName() << ".";
+        err = STR("STR_FAILED_OPEN_FILE").arg(catFile.fileName());
+        return false;
+    }
+
+    quint64 printTm = 0;
+    quint64 total   = 0;
+
+    // Open dat file.
+    QFile datFile(dir.absoluteFilePath(catDatInfo.dat));
+    if (! datFile.open(QIODevice::OpenModeFlag::ReadOnly
+                       | QIODevice::OpenModeFlag::ExistingOnly)) {
+        qDebug() << "Failed to open file :" << datFile.fileName() << ".";
+        err = STR("STR_FAILED_OPEN_FILE").arg(datFile.fileName());
+        return false;
+    }
+
+    progressFunc(total, datFile.size());
+
+    // Prefix of path.
+    QStringList basename
+        = catDatInfo.cat.split('/', Qt::SplitBehaviorFlags::SkipEmptyParts);
+    basename.pop_back();
+
+    // Scan cat file.
+    quint64 count = 0;
+    while (! catFile.atEnd()) {
+        // Get file info
+        QString line = catFile.readLine();
+        line.remove(QChar('\r'));
+        line.remove(QChar('\n'));
+        if (line == "") {
+            continue;
+        }
+
+        QStringList splittedLine = this->splitCatLine(line);
+        if (splittedLine.size() != 4) {
+            qDebug() << "Broken cat file :" << catFile.fileName();
+            err = STR("STR_FILE_BROKEN").arg(catFile.fileName());
+            return false;
+        }
+
+        quint64 size   = splittedLine[1].toULongLong();
+        quint64 offset = total;
+        total += size;
+
+        if ((qint64)(datFile.size()) < (qint64)size + (qint64)offset) {
+            qDebug() << "Broken dat file :" << datFile.fileName();
+            err = STR("STR_FILE_BROKEN").arg(datFile.fileName());
+            return false;
+        }
+
+        // Append file
+        // Split path
+        auto splittedPath
+            = basename
+              + splittedLine[0].split('/',
+                                      Qt::SplitBehaviorFlags::SkipEmptyParts);
+        if (splittedPath.empty()) {
+            break;
+        }
+
+        // Parent, the tree is owned by current thread so no lock is needed.
+        ::std::shared_ptr<DatFileEntery> entry = root;
+        for (auto iter = splittedPath.begin(); iter < splittedPath.end() - 1;
+             iter++) {
+            auto pathIter = entry->children.find(*iter);
+            if (pathIter == entry->children.end()) {
+                // Create new
+                pathIter = entry->children.insert(
+                    *iter, ::std::shared_ptr<DatFileEntery>(
+                               new DatFileEntery(*iter)));
+            }
+            entry = *pathIter;
+            if (! entry->isDirectory) {
+                qDebug() << "Broken cat file :" << catFile.fileName();
+                err = STR("STR_FILE_BROKEN").arg(catFile.fileName());
+                return false;
+            }
+        }
+
+        // File
+        entry->children[splittedPath.back()]
+            = ::std::shared_ptr<DatFileEntery>(
+                new DatFileEntery(splittedPath.back(), datFile.fileName(),
+                                  offset, size, splittedLine.back()));
+        ++count;
+
+        {
+            quint64 tm = QDateTime::currentMSecsSinceEpoch();
+            if (tm - printTm > 150) {
+                printTm = tm;
+                progressFunc(total, datFile.size());
+            }
+        }
+    }
+    progressFunc(total, datFile.size());
+    qDebug() << count << "packed files loaded from" << catDatInfo.cat << ".";
+
+    return true;
+}
+
+/**
+ * @brief		Merge enteries.
+ */
+bool GameVFS::mergeEntry(::std::shared_ptr<DatFileEntery> dest,
+                         ::std::shared_ptr<DatFileEntery> src)
+{
+    for (auto srcIter = src->children.begin(); srcIter != src->children.end();
+         ++srcIter) {
+        auto destIter = dest->children.find(srcIter.key());
+        if (destIter == dest->children.end() || ! (*srcIter)->isDirectory) {
+            // Add new entery or override file.
+            dest->children[srcIter.key()] = *srcIter;
+
+        } else if ((*destIter)->isDirectory) {
+            // Merge directory.
+            if (! this->mergeEntry(*destIter, *srcIter)) {
+                return false;
+            }
+
+        } else {
+            // Directory overrides file.
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief		Get stamps of cat/dat files.
+ */
+QVector<GameVFS::CatFileStamp>
+    GameVFS::catFileStamps(const QDir &                      dir,
+                           const QMap<QString, CatFileInfo> &info)
+{
+    QVector<CatFileStamp> ret;
+    for (auto &catDatInfo : info) {
+        QFileInfo catInfo(dir.absoluteFilePath(catDatInfo.cat));
+        QFileInfo datInfo(dir.absoluteFilePath(catDatInfo.dat));
+        ret.append({catDatInfo.cat,
+                    catInfo.exists() ? catInfo.size() : -1,
+                    catInfo.exists()
+                        ? catInfo.lastModified().toMSecsSinceEpoch()
+                        : -1,
+                    catDatInfo.dat,
+                    datInfo.exists() ? datInfo.size() : -1,
+                    datInfo.exists()
+                        ? datInfo.lastModified().toMSecsSinceEpoch()
+                        : -1});
+    }
+
+    return ret;
+}
+
+/**
+ * @brief		Get path of index cache file.
+ */
+QString GameVFS::indexCachePath()
+{
+    return QDir(Global::instance()->cacheDir())
+        .absoluteFilePath("vfs_index.cache");
+}
+
+/**
+ * @brief		Load enteries from index cache.
+ */
+bool GameVFS::loadIndexCache(const QVector<CatFileStamp> &stamps)
+{
+    QFile file(this->indexCachePath());
+    if (! file.open(QIODevice::OpenModeFlag::ReadOnly
+                    | QIODevice::OpenModeFlag::ExistingOnly)) {
+        qDebug() << "Index cache of vfs does not exist.";
+        return false;
+    }
+
+    // Map file.
+    qint64 fileSize = file.size();
+    uchar *data     = file.map(0, fileSize);
+    if (data == nullptr) {
+        qDebug() << "Failed to map index cache :" << file.fileName() << ".";
+        return false;
+    }
+    AutoRelease<uchar *> unmapper(data, [&file](uchar *&data) -> void {
+        file.unmap(data);
+    });
+
+    QByteArray  buffer = QByteArray::fromRawData((const char *)data, fileSize);
+    QDataStream stream(buffer);
+    stream.setVersion(QDataStream::Version::Qt_5_14);
+
+    // Check header.
+    char magic[sizeof(_indexCacheMagic)];
+    if (stream.readRawData(magic, sizeof(magic)) != sizeof(magic)
+        || ::memcmp(magic, _indexCacheMagic, sizeof(magic)) != 0) {
+        qDebug() << "Illegal index cache :" << file.fileName() << ".";
+        return false;
+    }
+
+    quint32 version;
+    stream >> version;
+    if (version != _indexCacheVersion) {
+        qDebug() << "Version of index cache mismatch.";
+        return false;
+    }
+
+    // Check stamps.
+    QString gamePath;
+    quint32 stampCount;
+    stream >> gamePath >> stampCount;
+    if (stream.status() != QDataStream::Status::Ok || gamePath != m_gamePath
+        || stampCount != (quint32)(stamps.size())) {
+        qDebug() << "Index cache is outdated.";
+        return false;
+    }
+    for (auto &stamp : stamps) {
+        CatFileStamp cachedStamp;
+        stream >> cachedStamp.cat >> cachedStamp.catSize
+            >> cachedStamp.catModified >> cachedStamp.dat
+            >> cachedStamp.datSize >> cachedStamp.datModified;
+        if (stream.status() != QDataStream::Status::Ok
+            || cachedStamp.cat != stamp.cat
+            || cachedStamp.catSize != stamp.catSize
+            || cachedStamp.catModified != stamp.catModified
+            || cachedStamp.dat != stamp.dat
+            || cachedStamp.datSize != stamp.datSize
+            || cachedStamp.datModified != stamp.datModified) {
+            qDebug() << "Index cache is outdated.";
+            return false;
+        }
+    }
+
+    // Load enteries.
+    quint32 nodeCount;
+    stream >> m_datNames >> m_namePool >> nodeCount;
+    if (stream.status() != QDataStream::Status::Ok
+        || nodeCount > (quint64)fileSize / sizeof(CompactNode)) {
+        qDebug() << "Illegal index cache :" << file.fileName() << ".";
+        return false;
+    }
+    m_nodes.resize(nodeCount);
+    for (auto &node : m_nodes) {
+        stream >> node.name >> node.nameSize >> node.index >> node.count;
+    }
+
+    quint32 fileCount;
+    stream >> fileCount;
+    if (stream.status() != QDataStream::Status::Ok
+        || fileCount > (quint64)fileSize / sizeof(PackedFile)) {
+        qDebug() << "Illegal index cache :" << file.fileName() << ".";
+        return false;
+    }
+    m_packedFiles.resize(fileCount);
+    for (auto &packedFile : m_packedFiles) {
+        stream >> packedFile.node >> packedFile.dat >> packedFile.offset
+            >> packedFile.size;
+        stream.readRawData(packedFile.hash, sizeof(packedFile.hash));
+    }
+
+    if (stream.status() != QDataStream::Status::Ok
+        || ! this->checkCompactEntries()) {
+        qDebug() << "Illegal index cache :" << file.fileName() << ".";
+        m_nodes.clear();
+        m_packedFiles.clear();
+        m_namePool.clear();
+        m_datNames.clear();
+        return false;
+    }
+    m_fileStates.fill(FileState::Unchecked, m_packedFiles.size());
+    m_datEntry = nullptr;
+    qDebug() << "Index cache of vfs loaded :" << file.fileName() << ","
+             << m_nodes.size() << "nodes," << this->compactSize()
+             << "bytes used.";
+
+    return true;
+}
+
+/**
+ * @brief		Save enteries to index cache.
+ */
+void GameVFS::saveIndexCache(const QVector<CatFileStamp> &stamps)
+{
+    QSaveFile file(this->indexCachePath());
+    if (! file.open(QIODevice::OpenModeFlag::WriteOnly)) {
+        qWarning() << "Failed to open file :" << file.fileName() << ".";
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Version::Qt_5_14);
+
+    // Header.
+    stream.writeRawData(_indexCacheMagic, sizeof(_indexCacheMagic));
+    stream << _indexCacheVersion;
+
+    // Stamps.
+    stream << m_gamePath << (quint32)(stamps.size());
+    for (auto &stamp : stamps) {
+        stream << stamp.cat << stamp.catSize << stamp.catModified << stamp.dat
+               << stamp.datSize << stamp.datModified;
+    }
+
+    // Enteries.
+    stream << m_datNames << m_namePool << (quint32)(m_nodes.size());
+    for (auto &node : m_nodes) {
+        stream << node.name << node.nameSize << node.index << node.count;
+    }
+    stream << (quint32)(m_packedFiles.size());
+    for (auto &packedFile : m_packedFiles) {
+        stream << packedFile.node << packedFile.dat << packedFile.offset
+               << packedFile.size;
+        stream.writeRawData(packedFile.hash, sizeof(packedFile.hash));
+    }
+
+    if (stream.status() != QDataStream::Status::Ok || ! file.commit()) {
+        qWarning() << "Failed to write index cache :" << file.fileName()
+                   << ".";
+        return;
+    }
+    qDebug() << "Index cache of vfs saved :" << file.fileName() << ".";
+}
+
+/**
+ * @brief		Check if compacted enteries are legal.
+ */
+bool GameVFS::checkCompactEntries() const
+{
+    if (m_nodes.empty() || ! m_nodes.front().isDirectory()) {
+        return false;
+    }
+
+    // Children are stored in breadth-first order, the children of each
+    // directory must follow the children of previous directory.
+    quint64 next = 1;
+    for (quint32 i = 0; i < (quint32)(m_nodes.size()); ++i) {
+        const CompactNode &node = m_nodes[i];
+        if ((i > 0 && i >= next)
+            || (quint64)(node.name) + node.nameSize
+                   > (quint64)(m_namePool.size())) {
+            return false;
+        }
+
+        if (node.isDirectory()) {
+            if (node.index != next) {
+                return false;
+            }
+            next += node.count;
+
+        } else if (node.index >= (quint32)(m_packedFiles.size())
+                   || m_packedFiles[node.index].node != i) {
+            return false;
+        }
+    }
+    if (next != (quint64)(m_nodes.size())) {
+        return false;
+    }
+
+    for (auto &packedFile : m_packedFiles) {
+        if (packedFile.dat >= (quint32)(m_datNames.size())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief		Constructor.
+ */
+GameVFS::FileReader::FileReader(const QString &            path,
+                                ::std::shared_ptr<GameVFS> vfs) :
+    m_path(path.split('/', Qt::SplitBehaviorFlags::SkipEmptyParts)),
+    m_name(m_path.back()), m_vfs(vfs), m_readBufferPos(0)
+{}
+
+/**
+ * @brief	Get path of the file.
+ */
+QString GameVFS::FileReader::path() const
+{
+    QString ret = "";
+    for (auto &n : m_path) {
+        ret += "/";
+        ret += n;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief	Get name of the file.
+ */
+const QString &GameVFS::FileReader::name() const
+{
+    return m_name;
+}
+
+/**
+ * @brief		Read file.
+ */
+qint64 GameVFS::FileReader::read(void *buffer, quint64 size)
+{
+    this->flushReadBuffer();
+    return this->readData(buffer, size);
+}
+
+/**
+ * @brief		Read file.
+ */
+QByteArray GameVFS::FileReader::read(quint64 size)
+{
+    this->flushReadBuffer();
+    return this->readData(size);
+}
+
+/**
+ * @brief		Read all data after corrent position in the file.
+ */
+QByteArray GameVFS::FileReader::readAll()
+{
+    this->flushReadBuffer();
+    return this->readAllData();
+}
+
+/**
+ * @brief		Read a line.
+ */
+QByteArray GameVFS::FileReader::readLine()
+{
+    QByteArray line;
+    if (! this->nextLine(line)) {
+        return QByteArray();
+    }
+
+    return QByteArray(line.constData(), line.size());
+}
+
+/**
+ * @brief		Read next line without copying.
+ */
+bool GameVFS::FileReader::nextLine(QByteArray &line)
+{
+    // Mapped file, lines refer to the mapped memory directly.
+    if (m_readBufferPos >= m_readBuffer.size()) {
+        quint64     size;
+        const char *data = this->viewData(size);
+        if (data != nullptr) {
+            if (size == 0) {
+                line = QByteArray();
+                return false;
+            }
+            const char *lineBreak = (const char *)::memchr(data, '\n', size);
+            quint64     len = lineBreak == nullptr ? size : lineBreak - data + 1;
+            line            = QByteArray::fromRawData(data, len);
+            this->seekData(len, Whence::Current);
+            return true;
+        }
+    }
+
+    // Buffered.
+    while (true) {
+        // Search line break in buffered data.
+        const char *begin     = m_readBuffer.constData() + m_readBufferPos;
+        int         remaining = m_readBuffer.size() - m_readBufferPos;
+        const char *lineBreak
+            = (const char *)::memchr(begin, '\n', remaining);
+        if (lineBreak != nullptr) {
+            int len = lineBreak - begin + 1;
+            line    = QByteArray::fromRawData(begin, len);
+            m_readBufferPos += len;
+            return true;
+        }
+
+        // Move remaining data to the begining of the buffer.
+        if (m_readBufferPos > 0) {
+            ::memmove(m_readBuffer.data(), begin, remaining);
+            m_readBuffer.resize(remaining);
+            m_readBufferPos = 0;
+        }
+
+        // Read more data, the buffer grows if the line is longer than it.
+        qint64 readSize = 0;
+        if (! this->atEndData()) {
+            int chunk = max(_readAheadSize, remaining);
+            m_readBuffer.resize(remaining + chunk);
+            readSize = this->readData(m_readBuffer.data() + remaining, chunk);
+            m_readBuffer.resize(remaining + max(readSize, (qint64)0));
+        }
+
+        // Last line.
+        if (readSize <= 0) {
+            if (remaining == 0) {
+                line = QByteArray();
+                return false;
+            }
+            line = QByteArray::fromRawData(m_readBuffer.constData(), remaining);
+            m_readBufferPos = remaining;
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief		Get lines after current position.
+ */
+GameVFS::FileReader::Lines GameVFS::FileReader::lines()
+{
+    return Lines(this);
+}
+
+/**
+ * @brief		Get a read-only view of the data after current position.
+ */
+const char *GameVFS::FileReader::view(quint64 &size)
+{
+    this->flushReadBuffer();
+    return this->viewData(size);
+}
+
+/**
+ * @brief		Check if current position is at the end of current file.
+ */
+bool GameVFS::FileReader::atEnd()
+{
+    if (m_readBufferPos < m_readBuffer.size()) {
+        return false;
+    }
+
+    return this->atEndData();
+}
+
+/**
+ * @brief		Seek file.
+ */
+qint64 GameVFS::FileReader::seek(qint64 offset, Whence whence)
+{
+    this->flushReadBuffer();
+    return this->seekData(offset, whence);
+}
+
+/**
+ * @brief		Get a read-only view of the data after current position.
+ */
+const char *GameVFS::FileReader::viewData(quint64 &size)
+{
+    size = 0;
+    return nullptr;
+}
+
+/**
+ * @brief		Give the data in read-ahead buffer back to the file.
+ */
+void GameVFS::FileReader::flushReadBuffer()
+{
+    int remaining = m_readBuffer.size() - m_readBufferPos;
+    if (remaining > 0) {
+        this->seekData(-remaining, Whence::Current);
+    }
+    m_readBuffer.resize(0);
+    m_readBufferPos = 0;
+}
+
+/**
+ * @brief	Destructor.
+ *
+ */
+GameVFS::FileReader::~FileReader() {}
+
+/**
+ * @brief		Constructor.
+ */
+GameVFS::FileReader::LineIterator::LineIterator(FileReader *reader) :
+    m_reader(reader)
+{
+    ++(*this);
+}
+
+// Operators
+const QByteArray &GameVFS::FileReader::LineIterator::operator*() const
+{
+    return m_line;
+}
+
+const QByteArray *GameVFS::FileReader::LineIterator::operator->() const
+{
+    return &m_line;
+}
+
+GameVFS::FileReader::LineIterator &
+    GameVFS::FileReader::LineIterator::operator++()
+{
+    if (m_reader != nullptr && ! m_reader->nextLine(m_line)) {
+        m_reader = nullptr;
+    }
+
+    return *this;
+}
+
+bool GameVFS::FileReader::LineIterator::operator==(
+    const LineIterator &iter) const
+{
+    return m_reader == iter.m_reader;
+}
+
+bool GameVFS::FileReader::LineIterator::operator!=(
+    const LineIterator &iter) const
+{
+    return m_reader != iter.m_reader;
+}
+
+/**
+ * @brief		Constructor.
+ */
+GameVFS::FileReader::Lines::Lines(FileReader *reader) : m_reader(reader) {}
+
+/**
+ * @brief		Get iterator point to the first line.
+ */
+GameVFS::FileReader::LineIterator GameVFS::FileReader::Lines::begin()
+{
+    return LineIterator(m_reader);
+}
+
+/**
+ * @brief		Get iterator point to the end.
+ */
+GameVFS::FileReader::LineIterator GameVFS::FileReader::Lines::end()
+{
+    return LineIterator(nullptr);
+}
+
+/**
+ * @brief		Constructor.
+ */
+GameVFS::PackedFileReader::PackedFileReader(const QString &            path,
+                                            ::std::unique_ptr<QFile>   file,
+                                            quint64                    offset,
+                                            quint64                    size,
+                                            ::std::shared_ptr<GameVFS> vfs) :
+    GameVFS::FileReader(path, vfs),
+    m_file(::std::move(file)), m_mappedFile(nullptr), m_offset(offset),
+    m_size(size), m_pos(0)
+{
+    m_file->seek(m_offset);
+}
+
+/**
+ * @brief		Constructor, read data from mapped dat file.
+ */
+GameVFS::PackedFileReader::PackedFileReader(
+    const QString &                  path,
+    ::std::shared_ptr<MappedDatFile> mappedFile,
+    quint64                          offset,
+    quint64                          size,
+    ::std::shared_ptr<GameVFS>       vfs) :
+    GameVFS::FileReader(path, vfs),
+    m_file(nullptr), m_mappedFile(mappedFile), m_offset(offset),
+    m_size(size), m_pos(0)
+{}
+
+/**
+ * @brief		Read file.
+ */
+qint64 GameVFS::PackedFileReader::readData(void *buffer, quint64 size)
+{
+    if (m_mappedFile != nullptr) {
+        size = min(size, m_size - m_pos);
+        ::memcpy(buffer, m_mappedFile->data + m_offset + m_pos, size);
+        m_pos += size;
+        return size;
+    }
+
+    size = min(size, m_offset + m_size - m_file->pos());
+    return m_file->read((char *)buffer, size);
+}
+
+/**
+ * @brief		Read file.
+ */
+QByteArray GameVFS::PackedFileReader::readData(quint64 size)
+{
+    if (m_mappedFile != nullptr) {
+        size = min(size, m_size - m_pos);
+        QByteArray ret(
+            (const char *)(m_mappedFile->data + m_offset + m_pos), size);
+        m_pos += size;
+        return ret;
+    }
+
+    size = min(size, m_offset + m_size - m_file->pos());
+    return m_file->read(size);
+}
+
+/**
+ * @brief		Read all data after corrent position in the file.
+ */
+QByteArray GameVFS::PackedFileReader::readAllData()
+{
+    if (m_mappedFile != nullptr) {
+        quint64     size;
+        const char *data = this->viewData(size);
+        m_pos            = m_size;
+        return QByteArray::fromRawData(data, size);
+    }
+
+    quint64 size = m_offset + m_size - m_file->pos();
+    return m_file->read(size);
+}
+
+/**
+ * @brief		Get a read-only view of the data after current position.
+ */
+const char *GameVFS::PackedFileReader::viewData(quint64 &size)
+{
+    if (m_mappedFile != nullptr) {
+        size = m_size - m_pos;
+        return (const char *)(m_mappedFile->data + m_offset + m_pos);
+    }
+
+    size = 0;
+    return nullptr;
+}
+
+/**
+ * @brief		Seek file.
+ */
+qint64 GameVFS::PackedFileReader::seekData(qint64 offset, Whence whence)
+{
+    if (m_mappedFile != nullptr) {
+        qint64 pos;
+        switch (whence) {
+            case Whence::Set:
+                pos = 0;
+                break;
+
+            case Whence::Current:
+                pos = m_pos;
+                break;
+
+            case Whence::End:
+                pos = m_size;
+                break;
+        }
+
+        pos += offset;
+        m_pos = (quint64)(max((qint64)0, min(pos, (qint64)m_size)));
+
+        return m_pos;
+    }
+
+    qint64 pos;
+    switch (whence) {
+        case Whence::Set:
+            pos = m_offset;
+            break;
+
+        case Whence::Current:
+            pos = m_file->pos();
+            break;
+
+        case Whence::End:
+            pos = m_offset + m_size;
+            break;
+    }
+
+    pos += offset;
+    pos = min(pos, (qint64)(m_offset + m_size));
+    m_file->seek(pos);
+
+    return m_file->pos() - m_offset;
+}
+
+/**
+ * @brief		Check if current position is at the end of current file.
+ */
+bool GameVFS::PackedFileReader::atEndData()
+{
+    if (m_mappedFile != nullptr) {
+        return m_pos >= m_size;
+    }
+
+    return (quint64)(m_file->pos()) >= m_offset + m_size;
+}
+
+/**
+ * @brief	Destructor.
+ */
+GameVFS::PackedFileReader::~PackedFileReader() {}
+
+/**
+ * @brief		Constructor.
+ */
+GameVFS::NormalFileReader::NormalFileReader(const QString &            path,
+                                            ::std::unique_ptr<QFile>   file,
+                                            ::std::shared_ptr<GameVFS> vfs) :
+    GameVFS::FileReader(path, vfs),
+    m_file(::std::move(file))
+{}
+
+/**
+ * @brief		Read file.
+ */
+qint64 GameVFS::NormalFileReader::readData(void *buffer, quint64 size)
+{
+    return m_file->read((char *)buffer, size);
+}
+
+/**
+ * @brief		Read file.
+ */
+QByteArray GameVFS::NormalFileReader::readData(quint64 size)
+{
+    return m_file->read(size);
+}
+
+/**
+ * @brief		Read all data after corrent position in the file.
+ */
+QByteArray GameVFS::NormalFileReader::readAllData()
+{
+    return m_file->readAll();
+}
+
+/**
+ * @brief		Seek file.
+ */
+qint64 GameVFS::NormalFileReader::seekData(qint64 offset, Whence whence)
+{
+    qint64 pos;
+    switch (whence) {
+        case Whence::Set:
+            pos = 0;
+            break;
 
         case Whence::Current:
             pos = m_file->pos();
@@ -592,7 +1851,7 @@ qint64 GameVFS::NormalFileReader::seek(qint64 offset, Whence whence)
 /**
  * @brief		Check if current position is at the end of current file.
  */
-bool GameVFS::NormalFileReader::atEnd()
+bool GameVFS::NormalFileReader::atEndData()
 {
     return m_file->atEnd();
 }
@@ -605,9 +1864,9 @@ GameVFS::NormalFileReader::~NormalFileReader() {}
 /**
  * @brief		Constructor.
  */
-GameVFS::DirReader::DirReader(const QString &                  path,
-                              ::std::shared_ptr<DatFileEntery> entry,
-                              ::std::shared_ptr<GameVFS>       vfs) :
+GameVFS::DirReader::DirReader(const QString &            path,
+                              quint32                    node,
+                              ::std::shared_ptr<GameVFS> vfs) :
     m_path(path.split('/', Qt::SplitBehaviorFlags::SkipEmptyParts)),
     m_name(m_path.back()), m_vfs(vfs), m_enteries(new QVector<DirEntry>)
 {
@@ -620,11 +1879,14 @@ GameVFS::DirReader::DirReader(const QString &                  path,
                  (info.isDir() ? EntryType::Directory : EntryType::File)});
         }
     }
-    if (entry != nullptr) {
-        for (auto &datEntry : entry->children) {
-            m_enteries->append(
-                {datEntry->name, (datEntry->isDirectory ? EntryType::Directory
-                                                        : EntryType::File)});
+    if (node != _invalidIndex) {
+        const CompactNode &dirNode = m_vfs->m_nodes.at(node);
+        for (quint32 i = dirNode.index; i < dirNode.index + dirNode.count;
+             ++i) {
+            m_enteries->append({m_vfs->nodeName(i),
+                                (m_vfs->m_nodes.at(i).isDirectory()
+                                     ? EntryType::Directory
+                                     : EntryType::File)});
         }
     }
 }
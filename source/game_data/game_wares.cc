@@ -1,11 +1,13 @@
 #include <QtCore/QDebug>
+#include <QtCore/QReadLocker>
 #include <QtCore/QRegExp>
+#include <QtCore/QWriteLocker>
 
 #include <game_data/game_data.h>
 #include <game_data/game_wares.h>
 
 /**
- * @brief		Constructor.
+ * @brief		Constructor, load the wares of the base game.
  */
 GameWares::GameWares(::std::shared_ptr<GameVFS>             vfs,
                      ::std::shared_ptr<GameTexts>           texts,
@@ -26,12 +28,12 @@ GameWares::GameWares(::std::shared_ptr<GameVFS>             vfs,
     QXmlStreamReader groupReader(data);
 
     // Parse group file
-    auto context = XMLLoader::Context::create();
+    XMLLoader loader;
+    auto      context = loader.createContext();
     context->setOnStartElement(
         ::std::bind(&GameWares::onStartElementInGroupRoot, this,
                     ::std::placeholders::_1, ::std::placeholders::_2,
                     ::std::placeholders::_3, ::std::placeholders::_4));
-    XMLLoader loader;
     loader["texts"] = texts;
     if (! loader.parse(groupReader, ::std::move(context))) {
         return;
@@ -46,7 +48,7 @@ GameWares::GameWares(::std::shared_ptr<GameVFS>             vfs,
     QXmlStreamReader waresReader(data);
 
     // Parse ware file
-    context = XMLLoader::Context::create();
+    context = loader.createContext();
     context->setOnStartElement(
         ::std::bind(&GameWares::onStartElementInWaresRoot, this,
                     ::std::placeholders::_1, ::std::placeholders::_2,
@@ -55,35 +57,192 @@ GameWares::GameWares(::std::shared_ptr<GameVFS>             vfs,
     if (! loader.parse(waresReader, ::std::move(context))) {
         return;
     }
+    this->internWares();
+
+    this->setInitialized();
+}
+
+/**
+ * @brief		Constructor, load wares from snapshot.
+ */
+GameWares::GameWares(QDataStream &stream) :
+    m_unknowWareIndex(0), m_unknowWareGroupIndex(0)
+{
+    // Ware groups.
+    qint32  unknowWareIndex;
+    qint32  unknowWareGroupIndex;
+    quint32 groupCount;
+    stream >> unknowWareIndex >> unknowWareGroupIndex >> groupCount;
+    for (quint32 i = 0; i < groupCount; ++i) {
+        ::std::shared_ptr<WareGroup> group(new WareGroup());
+        stream >> group->id >> group->name >> group->tags;
+        if (stream.status() != QDataStream::Status::Ok) {
+            return;
+        }
+        m_wareGroups[group->id] = group;
+    }
+    m_unknowWareIndex.store(unknowWareIndex);
+    m_unknowWareGroupIndex.store(unknowWareGroupIndex);
+
+    // Wares.
+    quint32 wareCount;
+    stream >> wareCount;
+    for (quint32 i = 0; i < wareCount; ++i) {
+        ::std::shared_ptr<Ware> ware(new Ware());
+        qint32                  transportType;
+        quint32                 infoCount;
+        stream >> ware->id >> ware->name >> ware->description >> ware->group
+            >> transportType >> ware->volume >> ware->tags >> ware->minPrice
+            >> ware->averagePrice >> ware->maxPrice >> infoCount;
+        if (stream.status() != QDataStream::Status::Ok) {
+            return;
+        }
+        ware->transportType = (TransportType)transportType;
+        for (quint32 j = 0; j < infoCount; ++j) {
+            QString key;
+            stream >> key;
+            ::std::shared_ptr<ProductionInfo> info
+                = GameWares::readProductionInfo(stream);
+            if (info == nullptr) {
+                return;
+            }
+            ware->productionInfos[key] = info;
+        }
+        m_wares[ware->id] = ware;
+    }
+    this->internWares();
+    qDebug() << m_wareGroups.size() << "ware groups and" << m_wares.size()
+             << "wares loaded from snapshot.";
+
+    this->setInitialized();
+}
 
-    // Parse extension ware files
+/**
+ * @brief		Load wares from snapshot.
+ */
+::std::shared_ptr<GameWares> GameWares::loadSnapshot(QDataStream &stream)
+{
+    ::std::shared_ptr<GameWares> ret(new GameWares(stream));
+
+    if (ret == nullptr || ! ret->initialized()) {
+        return nullptr;
+    } else {
+        return ret;
+    }
+}
+
+/**
+ * @brief		Save wares to snapshot.
+ */
+void GameWares::saveSnapshot(QDataStream &stream)
+{
+    QReadLocker locker(&m_lock);
+
+    // Ware groups.
+    stream << (qint32)(m_unknowWareIndex.load())
+           << (qint32)(m_unknowWareGroupIndex.load())
+           << (quint32)(m_wareGroups.size());
+    for (auto &group : m_wareGroups) {
+        stream << group->id << group->name << group->tags;
+    }
+
+    // Wares.
+    stream << (quint32)(m_wares.size());
+    for (auto &ware : m_wares) {
+        stream << ware->id << ware->name << ware->description << ware->group
+               << (qint32)(ware->transportType) << ware->volume << ware->tags
+               << ware->minPrice << ware->averagePrice << ware->maxPrice
+               << (quint32)(ware->productionInfos.size());
+        for (auto iter = ware->productionInfos.begin();
+             iter != ware->productionInfos.end(); ++iter) {
+            stream << iter.key();
+            GameWares::writeProductionInfo(stream, *(iter.value()));
+        }
+    }
+}
+
+/**
+ * @brief		Write production information to snapshot.
+ */
+void GameWares::writeProductionInfo(QDataStream &         stream,
+                                    const ProductionInfo &info)
+{
+    stream << info.id << info.time << info.amount << info.method
+           << info.workEffect << (quint32)(info.resources.size());
+    for (auto &resource : info.resources) {
+        stream << resource->id << resource->amount;
+    }
+}
+
+/**
+ * @brief		Read production information from snapshot.
+ */
+::std::shared_ptr<GameWares::ProductionInfo>
+    GameWares::readProductionInfo(QDataStream &stream)
+{
+    ::std::shared_ptr<ProductionInfo> info(new ProductionInfo());
+    quint32                           resourceCount;
+    stream >> info->id >> info->time >> info->amount >> info->method
+        >> info->workEffect >> resourceCount;
+    for (quint32 i = 0; i < resourceCount; ++i) {
+        ::std::shared_ptr<Resource> resource(new Resource());
+        stream >> resource->id >> resource->amount;
+        if (stream.status() != QDataStream::Status::Ok) {
+            return nullptr;
+        }
+        info->resources[resource->id] = resource;
+    }
+    if (stream.status() != QDataStream::Status::Ok) {
+        return nullptr;
+    }
+
+    return info;
+}
+
+/**
+ * @brief		Apply the diffs of wares in extensions.
+ */
+bool GameWares::applyExtensions(::std::shared_ptr<GameVFS>   vfs,
+                                ::std::shared_ptr<GameTexts> texts)
+{
+    XMLLoader                               loader;
     ::std::shared_ptr<::GameVFS::DirReader> extensionsDir
         = vfs->openDir("/extensions");
     if (extensionsDir != nullptr) {
         for (auto iter = extensionsDir->begin(); iter != extensionsDir->end();
              ++iter) {
             if (iter->type == ::GameVFS::DirReader::EntryType::Directory) {
-                file = vfs->open(QString("/extensions/%1/libraries/wares.xml")
-                                     .arg(iter->name));
+                ::std::shared_ptr<GameVFS::FileReader> file
+                    = vfs->open(QString("/extensions/%1/libraries/wares.xml")
+                                    .arg(iter->name));
                 if (file == nullptr) {
                     continue;
                 }
-                data = file->readAll();
+                QByteArray       data = file->readAll();
                 QXmlStreamReader waresReader(data);
 
                 // Parse ware file
-                context = XMLLoader::Context::create();
+                auto context = loader.createContext();
                 context->setOnStartElement(::std::bind(
                     &GameWares::onStartElementInExtensionsWaresRoot, this,
                     ::std::placeholders::_1, ::std::placeholders::_2,
                     ::std::placeholders::_3, ::std::placeholders::_4));
                 loader["texts"] = texts;
-                loader.parse(waresReader, ::std::move(context));
+                if (! loader.parse(waresReader, ::std::move(context))
+                    || waresReader.hasError()) {
+                    qWarning() << "Failed to parse ware file of extension"
+                               << iter->name << ":"
+                               << waresReader.errorString();
+                    return false;
+                }
             }
         }
     }
 
-    this->setInitialized();
+    QWriteLocker locker(&m_lock);
+    this->internWares();
+
+    return true;
 }
 
 /**
@@ -96,7 +255,16 @@ GameWares::GameWares(::std::shared_ptr<GameVFS>             vfs,
         texts = GameData::instance()->texts();
     }
 
-    auto iter = m_wareGroups.find(id);
+    {
+        QReadLocker locker(&m_lock);
+        auto        iter = m_wareGroups.find(id);
+        if (iter != m_wareGroups.end()) {
+            return iter.value();
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    auto         iter = m_wareGroups.find(id);
     if (iter == m_wareGroups.end()) {
         ::std::shared_ptr<GameWares::WareGroup> unknowWareGroup(new WareGroup(
             {id,
@@ -122,7 +290,16 @@ GameWares::GameWares(::std::shared_ptr<GameVFS>             vfs,
         texts = GameData::instance()->texts();
     }
 
-    auto iter = m_wares.find(id);
+    {
+        QReadLocker locker(&m_lock);
+        auto        iter = m_wares.find(id);
+        if (iter != m_wares.end()) {
+            return iter.value();
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    auto         iter = m_wares.find(id);
     if (iter == m_wares.end()) {
         // Generate an unknow ware.
         ::std::shared_ptr<GameWares::Ware> unknowWare(new Ware(
@@ -139,6 +316,7 @@ GameWares::GameWares(::std::shared_ptr<GameVFS>             vfs,
              1,
              {}}));
         m_wares[id] = unknowWare;
+        this->internWares();
         qWarning() << "Unknow ware, id =" << id << ".";
         return unknowWare;
     } else {
@@ -146,28 +324,100 @@ GameWares::GameWares(::std::shared_ptr<GameVFS>             vfs,
     }
 }
 
+/**
+ * @brief	Find ware information.
+ */
+::std::shared_ptr<GameWares::Ware> GameWares::findWare(const QString &id)
+{
+    QReadLocker locker(&m_lock);
+    auto        iter = m_wares.find(id);
+    if (iter != m_wares.end()) {
+        return iter.value();
+    } else {
+        return nullptr;
+    }
+}
+
+/**
+ * @brief	Get ordinal of ware.
+ */
+int GameWares::wareOrdinal(const QString &              id,
+                           ::std::shared_ptr<GameTexts> texts)
+{
+    {
+        QReadLocker locker(&m_lock);
+        auto        iter = m_wareOrdinals.find(id);
+        if (iter != m_wareOrdinals.end()) {
+            return iter.value();
+        }
+    }
+
+    // Generate an unknow ware, it is interned when created.
+    this->ware(id, texts);
+
+    QReadLocker locker(&m_lock);
+    return m_wareOrdinals.value(id, -1);
+}
+
+/**
+ * @brief	Get ware ID by ordinal.
+ */
+QString GameWares::wareID(int ordinal)
+{
+    QReadLocker locker(&m_lock);
+    if (ordinal < 0 || ordinal >= m_wareIDs.size()) {
+        return QString();
+    }
+
+    return m_wareIDs[ordinal];
+}
+
+/**
+ * @brief	Get count of ware ordinals.
+ */
+int GameWares::wareCount()
+{
+    QReadLocker locker(&m_lock);
+    return m_wareIDs.size();
+}
+
 /**
  * @brief		Destructor.
  */
 GameWares::~GameWares() {}
 
+/**
+ * @brief		Assign ordinals to the wares which have not been interned.
+ */
+void GameWares::internWares()
+{
+    // The ordinals of interned wares never change, so the ordinals held by
+    // the other game data stay valid after the extensions are applied.
+    for (auto iter = m_wares.begin(); iter != m_wares.end(); ++iter) {
+        if (! m_wareOrdinals.contains(iter.key())) {
+            m_wareOrdinals[iter.key()] = m_wareIDs.size();
+            m_wareIDs.push_back(iter.key());
+        }
+    }
+}
+
 /**
  * @brief		Start element callback in root of group file.
  */
 bool GameWares::onStartElementInGroupRoot(XMLLoader &loader,
                                           XMLLoader::Context &,
                                           const QString &name,
-                                          const QMap<QString, QString> &)
+                                          const XMLLoader::Attributes &)
 {
     if (name == "groups") {
-        auto context = XMLLoader::Context::create();
+        auto context = loader.createContext();
         context->setOnStartElement(
             ::std::bind(&GameWares::onStartElementInGroups, this,
                         ::std::placeholders::_1, ::std::placeholders::_2,
                         ::std::placeholders::_3, ::std::placeholders::_4));
         loader.pushContext(::std::move(context));
     } else {
-        loader.pushContext(XMLLoader::Context::create());
+        loader.skipElement();
     }
     return true;
 }
@@ -177,8 +427,8 @@ bool GameWares::onStartElementInGroupRoot(XMLLoader &loader,
  */
 bool GameWares::onStartElementInGroups(XMLLoader &loader,
                                        XMLLoader::Context &,
-                                       const QString &               name,
-                                       const QMap<QString, QString> &attr)
+                                       const QString &              name,
+                                       const XMLLoader::Attributes &attr)
 {
     ::std::shared_ptr<GameTexts> texts
         = ::std::any_cast<::std::shared_ptr<GameTexts>>(loader["texts"]);
@@ -197,7 +447,7 @@ bool GameWares::onStartElementInGroups(XMLLoader &loader,
                  << ", name:" << texts->text(group->name)
                  << ", tags: " << group->tags;
     }
-    loader.pushContext(XMLLoader::Context::create());
+    loader.skipElement();
     return true;
 }
 
@@ -207,17 +457,17 @@ bool GameWares::onStartElementInGroups(XMLLoader &loader,
 bool GameWares::onStartElementInWaresRoot(XMLLoader &loader,
                                           XMLLoader::Context &,
                                           const QString &name,
-                                          const QMap<QString, QString> &)
+                                          const XMLLoader::Attributes &)
 {
     if (name == "wares") {
-        auto context = XMLLoader::Context::create();
+        auto context = loader.createContext();
         context->setOnStartElement(
             ::std::bind(&GameWares::onStartElementInWares, this,
                         ::std::placeholders::_1, ::std::placeholders::_2,
                         ::std::placeholders::_3, ::std::placeholders::_4));
         loader.pushContext(::std::move(context));
     } else {
-        loader.pushContext(XMLLoader::Context::create());
+        loader.skipElement();
     }
     return true;
 }
@@ -225,14 +475,14 @@ bool GameWares::onStartElementInWaresRoot(XMLLoader &loader,
 /**
  * @brief		Start element callback in wares.
  */
-bool GameWares::onStartElementInWares(XMLLoader &                   loader,
-                                      XMLLoader::Context &          context,
-                                      const QString &               name,
-                                      const QMap<QString, QString> &attr)
+bool GameWares::onStartElementInWares(XMLLoader &                  loader,
+                                      XMLLoader::Context &         context,
+                                      const QString &              name,
+                                      const XMLLoader::Attributes &attr)
 {
     if (name == "ware") {
         if (attr.find("id") == attr.end()) {
-            loader.pushContext(XMLLoader::Context::create());
+            loader.skipElement();
             return true;
         } else if (attr["id"] != "workunit_busy"
                    && (attr.find("name") == attr.end()
@@ -241,7 +491,7 @@ bool GameWares::onStartElementInWares(XMLLoader &                   loader,
                        || attr.find("transport") == attr.end()
                        || attr.find("volume") == attr.end()
                        || attr.find("tags") == attr.end())) {
-            loader.pushContext(XMLLoader::Context::create());
+            loader.skipElement();
             return true;
         }
         ::std::shared_ptr<Ware> ware;
@@ -271,7 +521,7 @@ bool GameWares::onStartElementInWares(XMLLoader &                   loader,
             } else if (attr["transport"] == "solid") {
                 transType = TransportType::Solid;
             } else {
-                loader.pushContext(XMLLoader::Context::create());
+                loader.skipElement();
                 return true;
             }
 
@@ -336,14 +586,14 @@ bool GameWares::onStartElementInWares(XMLLoader &                   loader,
             ::std::placeholders::_1, ::std::placeholders::_2,
             ::std::placeholders::_3, ware));
         // Push context
-        auto context = XMLLoader::Context::create();
+        auto context = loader.createContext();
         context->setOnStartElement(::std::bind(
             &GameWares::onStartElementInWare, this, ::std::placeholders::_1,
             ::std::placeholders::_2, ::std::placeholders::_3,
             ::std::placeholders::_4, ware));
         loader.pushContext(::std::move(context));
     } else {
-        loader.pushContext(XMLLoader::Context::create());
+        loader.skipElement();
     }
     return true;
 }
@@ -351,11 +601,11 @@ bool GameWares::onStartElementInWares(XMLLoader &                   loader,
 /**
  * @brief		Start element callback in ware.
  */
-bool GameWares::onStartElementInWare(XMLLoader &                   loader,
-                                     XMLLoader::Context &          context,
-                                     const QString &               name,
-                                     const QMap<QString, QString> &attr,
-                                     ::std::shared_ptr<Ware>       ware)
+bool GameWares::onStartElementInWare(XMLLoader &                  loader,
+                                     XMLLoader::Context &         context,
+                                     const QString &              name,
+                                     const XMLLoader::Attributes &attr,
+                                     ::std::shared_ptr<Ware>      ware)
 {
     if (name == "price") {
         // Price
@@ -371,7 +621,7 @@ bool GameWares::onStartElementInWare(XMLLoader &                   loader,
         if (iter != attr.end()) {
             ware->maxPrice = iter.value().toUInt();
         }
-        loader.pushContext(XMLLoader::Context::create());
+        loader.skipElement();
     } else if (name == "production") {
         ::std::shared_ptr<ProductionInfo> info(
             new ProductionInfo({ware->id,
@@ -395,14 +645,14 @@ bool GameWares::onStartElementInWare(XMLLoader &                   loader,
             ::std::placeholders::_3));
 
         // Push context
-        auto context = XMLLoader::Context::create();
+        auto context = loader.createContext();
         context->setOnStartElement(::std::bind(
             &GameWares::onStartElementInProduction, this,
             ::std::placeholders::_1, ::std::placeholders::_2,
             ::std::placeholders::_3, ::std::placeholders::_4, info));
         loader.pushContext(::std::move(context));
     } else {
-        loader.pushContext(XMLLoader::Context::create());
+        loader.skipElement();
     }
 
     return true;
@@ -415,14 +665,14 @@ bool GameWares::onStartElementInProduction(
     XMLLoader &                       loader,
     XMLLoader::Context &              context,
     const QString &                   name,
-    const QMap<QString, QString> &    attr,
+    const XMLLoader::Attributes &     attr,
     ::std::shared_ptr<ProductionInfo> info)
 {
     UNREFERENCED_PARAMETER(context);
     UNREFERENCED_PARAMETER(attr);
     if (name == "primary") {
         // Push context
-        auto context = XMLLoader::Context::create();
+        auto context = loader.createContext();
         context->setOnStartElement(::std::bind(
             &GameWares::onStartElementInPrimary, this, ::std::placeholders::_1,
             ::std::placeholders::_2, ::std::placeholders::_3,
@@ -430,14 +680,14 @@ bool GameWares::onStartElementInProduction(
         loader.pushContext(::std::move(context));
     } else if (name == "effects") {
         // Push context
-        auto context = XMLLoader::Context::create();
+        auto context = loader.createContext();
         context->setOnStartElement(::std::bind(
             &GameWares::onStartElementInEffects, this, ::std::placeholders::_1,
             ::std::placeholders::_2, ::std::placeholders::_3,
             ::std::placeholders::_4, info));
         loader.pushContext(::std::move(context));
     } else {
-        loader.pushContext(XMLLoader::Context::create());
+        loader.skipElement();
     }
 
     return true;
@@ -446,10 +696,10 @@ bool GameWares::onStartElementInProduction(
 /**
  * @brief		Start element callback in primary.
  */
-bool GameWares::onStartElementInPrimary(XMLLoader &                   loader,
-                                        XMLLoader::Context &          context,
-                                        const QString &               name,
-                                        const QMap<QString, QString> &attr,
+bool GameWares::onStartElementInPrimary(XMLLoader &                  loader,
+                                        XMLLoader::Context &         context,
+                                        const QString &              name,
+                                        const XMLLoader::Attributes &attr,
                                         ::std::shared_ptr<ProductionInfo> info)
 {
     UNREFERENCED_PARAMETER(context);
@@ -457,17 +707,17 @@ bool GameWares::onStartElementInPrimary(XMLLoader &                   loader,
         info->resources[attr["ware"]] = ::std::shared_ptr<Resource>(
             new Resource({attr["ware"], attr["amount"].toUInt()}));
     }
-    loader.pushContext(XMLLoader::Context::create());
+    loader.skipElement();
     return true;
 }
 
 /**
  * @brief		Start element callback in effects.
  */
-bool GameWares::onStartElementInEffects(XMLLoader &                   loader,
-                                        XMLLoader::Context &          context,
-                                        const QString &               name,
-                                        const QMap<QString, QString> &attr,
+bool GameWares::onStartElementInEffects(XMLLoader &                  loader,
+                                        XMLLoader::Context &         context,
+                                        const QString &              name,
+                                        const XMLLoader::Attributes &attr,
                                         ::std::shared_ptr<ProductionInfo> info)
 {
     UNREFERENCED_PARAMETER(context);
@@ -476,7 +726,7 @@ bool GameWares::onStartElementInEffects(XMLLoader &                   loader,
             info->workEffect = attr["product"].toDouble();
         }
     }
-    loader.pushContext(XMLLoader::Context::create());
+    loader.skipElement();
     return true;
 }
 
@@ -488,9 +738,9 @@ bool GameWares::onStartElementInExtensionsWaresRoot(
     XMLLoader &loader,
     XMLLoader::Context &,
     const QString &name,
-    const QMap<QString, QString> &)
+    const XMLLoader::Attributes &)
 {
-    auto context = XMLLoader::Context::create();
+    auto context = loader.createContext();
     if (name == "diff") {
         context->setOnStartElement(
             ::std::bind(&GameWares::onStartElementInExtensionDiff, this,
@@ -505,12 +755,12 @@ bool GameWares::onStartElementInExtensionsWaresRoot(
  * @brief		Start element callback in wares of extensions.
  */
 bool GameWares::onStartElementInExtensionDiff(
-    XMLLoader &                   loader,
-    XMLLoader::Context &          currentContext,
-    const QString &               name,
-    const QMap<QString, QString> &attr)
+    XMLLoader &                  loader,
+    XMLLoader::Context &         currentContext,
+    const QString &              name,
+    const XMLLoader::Attributes &attr)
 {
-    auto context = XMLLoader::Context::create();
+    auto context = loader.createContext();
     // Filters
     QRegExp wareFilter("\\/wares\\/ware\\[@id='(\\w+)'\\]");
     wareFilter.setCaseSensitivity(Qt::CaseSensitivity::CaseInsensitive);
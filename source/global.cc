@@ -50,6 +50,14 @@ Global::Global(int &argc, char **&argv, int &exitCode)
     m_configPath = configDir.absoluteFilePath(".config");
     qDebug() << "Path of config file : " << m_configPath;
 
+    // Directory of cache files
+    QDir cacheDir(configDir.absoluteFilePath("cache"));
+    if (! cacheDir.exists()) {
+        cacheDir.mkpath(".");
+    }
+    m_cacheDir = cacheDir.absolutePath();
+    qDebug() << "Directory of cache files : " << m_cacheDir;
+
     this->setInitialized();
 }
 
@@ -69,6 +77,14 @@ const QString &Global::configPath() const
     return m_configPath;
 }
 
+/**
+ * @brief       Get directory of cache files.
+ */
+const QString &Global::cacheDir() const
+{
+    return m_cacheDir;
+}
+
 /**
  * @brief       Check if there is a file to open.
  */
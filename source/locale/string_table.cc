@@ -206,6 +206,15 @@ void StringTable::setLanguage(const QString &language)
     emit this->afterLanguageChanged();
 }
 
+/**
+ * @brief       Emit the signals of language changes again.
+ */
+void StringTable::refreshLanguage()
+{
+    emit this->languageChanged();
+    emit this->afterLanguageChanged();
+}
+
 /**
  * @brief   Get a \c QCollator object.
  */
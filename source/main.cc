@@ -72,6 +72,10 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (TaskPool::initialize() == nullptr) {
+        return 1;
+    }
+
     if (OpenFileListener::initialize() == nullptr) {
         return 1;
     } else {
@@ -1,3 +1,5 @@
+#include <cmath>
+
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
 #include <QtCore/QMimeData>
@@ -9,6 +11,7 @@
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QMessageBox>
 
+#include <common/compare.h>
 #include <config.h>
 #include <locale/string_table.h>
 #include <ui/main_window/editor_widget/editor_widget.h>
@@ -44,6 +47,7 @@ EditorWidget::EditorWidget(::std::shared_ptr<Save>  save,
     m_save(save), m_savedUndoCount(0), m_fileActions(fileActions),
     m_editActions(editActions), m_backgroundTasks(new BackgroundTask(
                                     BackgroundTask::RunType::Newest, this)),
+    m_summaryModel(new SummaryModel(save)), m_summaryGeneration(0),
     m_treeEditor(nullptr)
 {
     this->connect(this, &EditorWidget::windowTitleChanged, parent,
@@ -239,7 +243,12 @@ EditorWidget::EditorWidget(::std::shared_ptr<Save>  save,
 /**
  * @brief	Destructors.
  */
-EditorWidget::~EditorWidget() {}
+EditorWidget::~EditorWidget()
+{
+    // The running summary task posts its result to this widget.
+    m_backgroundTasks->cancle();
+    m_backgroundTasks->wait();
+}
 
 /**
  * @brief		Do operation.
@@ -452,12 +461,41 @@ void EditorWidget::updateSummary()
 {
     this->disableSuggestedAmounts();
 
-    SummaryInfo summary;
-    this->makeSummary(summary);
-    this->showSummary(summary);
-    this->checkSummary(summary);
+    // The summary is made from a snapshot of the summary model in background.
+    // Only the newest task is kept in the queue, and the summaries made by
+    // the tasks started before the newest update are dropped.
+    quint64 generation = m_summaryGeneration.fetchAndAddOrdered(1) + 1;
+    ::std::shared_ptr<const SummaryModel> model(
+        new SummaryModel(*m_summaryModel));
+    QVector<quint64> amounts;
+#ifndef QT_NO_DEBUG
+    amounts = this->moduleAmounts();
+#endif
+
+    m_backgroundTasks->runTask([this, generation, model, amounts]() -> void {
+        if (m_summaryGeneration.loadAcquire() != generation) {
+            return;
+        }
+
+        ::std::shared_ptr<SummaryInfo> summary(new SummaryInfo());
+        model->makeSummary(*summary);
 
-    this->updateSuggestedAmounts(summary);
+#ifndef QT_NO_DEBUG
+        // Check the incremental summary with a full recomputation.
+        SummaryInfo fullSummary;
+        EditorWidget::makeSummary(amounts, fullSummary);
+        if (! EditorWidget::compareSummary(*summary, fullSummary)) {
+            qWarning() << "Incremental summary differs from full summary.";
+        }
+#endif
+
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, summary]() -> void {
+                this->onSummaryReady(generation, summary);
+            },
+            Qt::ConnectionType::QueuedConnection);
+    });
 }
 
 /**
@@ -558,425 +596,132 @@ void EditorWidget::updateSuggestedAmounts(SummaryInfo &summary)
 }
 
 /**
- * @brief       Make summary.
+ * @brief       Get amounts of modules in the station.
  */
-void EditorWidget::makeSummary(SummaryInfo &summary)
+QVector<quint64> EditorWidget::moduleAmounts()
 {
     auto gameStationModules = GameData::instance()->stationModules();
-    auto gameWares          = GameData::instance()->wares();
 
-    // Count summary.
+    QVector<quint64> amounts(gameStationModules->table().size(), 0);
     for (auto saveGroup : m_save->groups()) {
         for (auto saveModule : saveGroup->modules()) {
             auto module = gameStationModules->module(saveModule->module());
+            amounts[module->ordinal] += saveModule->amount();
+        }
+    }
 
-            // Hull & explosion damage.
-            summary.hull += module->hull * saveModule->amount();
-            summary.explosionDamage
-                += module->explosiondamage * saveModule->amount();
-
-            // Properties.
-            for (auto property : module->properties) {
-                switch (property->type) {
-                    case GameStationModules::Property::Type::MTurret:
-                        // Has M turret.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasMTurret>
-                                hasMTurret = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasMTurret>(property);
-                            summary.weapons.mTurret
-                                += hasMTurret->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::MShield:
-                        // Has M shield.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasMShield>
-                                hasMShield = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasMShield>(property);
-                            summary.shields.mShield
-                                += hasMShield->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::LTurret:
-                        // Has L turret.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasLTurret>
-                                hasLTurret = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasLTurret>(property);
-                            summary.weapons.lTurret
-                                += hasLTurret->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::LShield:
-                        // Has L shield.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasLShield>
-                                hasLShield = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasLShield>(property);
-                            summary.shields.lShield
-                                += hasLShield->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::SDock:
-                        // Has S docking bay.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasSDock>
-                                hasSDock = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasSDock>(property);
-                            summary.dockingBay.sDock
-                                += hasSDock->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::SShipCargo:
-                        // Has S ship cargo.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasSShipCargo>
-                                hasSShipCargo = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasSShipCargo>(
-                                    property);
-                            summary.shipStorage.sShipCargo
-                                += hasSShipCargo->capacity
-                                   * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::MDock:
-                        // Has M docking bay.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasMDock>
-                                hasMDock = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasMDock>(property);
-                            summary.dockingBay.mDock
-                                += hasMDock->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::MShipCargo:
-                        // Has M ship cargo.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasMShipCargo>
-                                hasMShipCargo = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasMShipCargo>(
-                                    property);
-                            summary.shipStorage.mShipCargo
-                                += hasMShipCargo->capacity
-                                   * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::LDock:
-                        // Has L docking bay.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasLDock>
-                                hasLDock = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasLDock>(property);
-                            summary.dockingBay.lDock
-                                += hasLDock->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::XLDock:
-                        // Has XL docking bay.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasXLDock>
-                                hasXLDock = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasXLDock>(property);
-                            summary.dockingBay.xlDock
-                                += hasXLDock->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::LXLDock:
-                        // Has L/XL docking bay.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasLXLDock>
-                                hasLXLDock = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasLXLDock>(property);
-                            summary.dockingBay.lXLDock
-                                += hasLXLDock->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::SLaunchTube:
-                        // Has S launch tube.
-                        {
-                            ::std::shared_ptr<
-                                GameStationModules::HasSLaunchTube>
-                                hasSLaunchTube = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasSLaunchTube>(
-                                    property);
-                            summary.weapons.sLaunchTube
-                                += hasSLaunchTube->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::MLaunchTube:
-                        // Has M launch tube.
-                        {
-                            ::std::shared_ptr<
-                                GameStationModules::HasMLaunchTube>
-                                hasMLaunchTube = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasMLaunchTube>(
-                                    property);
-                            summary.weapons.mLaunchTube
-                                += hasMLaunchTube->count * saveModule->amount();
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::SupplyWorkforce:
-                        // Supply workforce.
-                        {
-                            ::std::shared_ptr<
-                                GameStationModules::SupplyWorkforce>
-                                supplyWorkforce = ::std::dynamic_pointer_cast<
-                                    GameStationModules::SupplyWorkforce>(
-                                    property);
-
-                            // Workforce.
-                            summary.workforce += supplyWorkforce->workforce
-                                                 * saveModule->amount();
-                            summary.surplusWorkforce
-                                += (qint64)(supplyWorkforce->workforce)
-                                   * saveModule->amount();
-
-                            // Supply.
-                            for (auto resource :
-                                 supplyWorkforce->supplyInfo->resources) {
-                                // Find/create ware.
-                                const QString &macro = resource->id;
-                                auto iter = summary.resources.find(macro);
-                                if (iter == summary.resources.end()) {
-                                    summary.resources[macro] = Range<
-                                        long double>(
-                                        0.0,
-                                        (((long double)resource->amount)
-                                         * supplyWorkforce->workforce * 3600
-                                         * saveModule->amount()
-                                         / supplyWorkforce->supplyInfo->amount
-                                         / supplyWorkforce->supplyInfo->time));
-                                } else {
-                                    // Increase amount.
-                                    iter->setMax(
-                                        iter->max()
-                                        + (((long double)resource->amount)
-                                           * supplyWorkforce->workforce * 3600
-                                           * saveModule->amount()
-                                           / supplyWorkforce->supplyInfo->amount
-                                           / supplyWorkforce->supplyInfo
-                                                 ->time));
-                                }
-
-                                // Transport type.
-                                switch (gameWares->ware(macro)->transportType) {
-                                    case GameWares::TransportType::Container:
-                                        // Container.
-                                        summary.requirements
-                                            .requireContainerStorage
-                                            = true;
-                                        break;
-
-                                    case GameWares::TransportType::Solid:
-                                        // Solid.
-                                        summary.requirements.requireSolidStorage
-                                            = true;
-                                        break;
-
-                                    case GameWares::TransportType::Liquid:
-                                        // Liquid.
-                                        summary.requirements
-                                            .requireLiquidStorage
-                                            = true;
-                                        break;
-
-                                    default:
-                                        break;
-                                }
-                            }
-                        }
-                        break;
-
-                    case GameStationModules::Property::Type::RequireWorkforce:
-                        // Require workforce.
-                        {
-                            ::std::shared_ptr<
-                                GameStationModules::RequireWorkforce>
-                                requireWorkforce = ::std::dynamic_pointer_cast<
-                                    GameStationModules::RequireWorkforce>(
-                                    property);
-                            summary.surplusWorkforce
-                                -= (qint64)(requireWorkforce->workforce)
-                                   * saveModule->amount();
-                        }
-                        break;
+    return amounts;
+}
 
-                    case GameStationModules::Property::Type::SupplyProduct:
-                        // Supply product.
-                        {
-                            ::std::shared_ptr<GameStationModules::SupplyProduct>
-                                supplyProfduct = ::std::dynamic_pointer_cast<
-                                    GameStationModules::SupplyProduct>(
-                                    property);
-                            ::std::shared_ptr<GameWares::ProductionInfo>
-                                productionInfo = supplyProfduct->productionInfo;
-                            const QString &macro = productionInfo->id;
-
-                            // Product.
-                            // Find/create ware.
-                            auto iter = summary.products.find(macro);
-                            if (iter == summary.products.end()) {
-                                summary.products[macro] = Range<long double>(
-                                    (long double)(productionInfo->amount) * 3600
-                                        * saveModule->amount()
-                                        / productionInfo->time,
-                                    (long double)(productionInfo->amount) * 3600
-                                        * saveModule->amount()
-                                        * (1.0 + productionInfo->workEffect)
-                                        / productionInfo->time);
-                            } else {
-                                // Increase amount.
-                                iter->setRange(
-                                    (long double)(productionInfo->amount) * 3600
-                                            * saveModule->amount()
-                                            / productionInfo->time
-                                        + iter->min(),
-                                    (long double)(productionInfo->amount) * 3600
-                                            * saveModule->amount()
-                                            * (1.0 + productionInfo->workEffect)
-                                            / productionInfo->time
-                                        + iter->max());
-                            }
-
-                            // Transport type.
-                            switch (gameWares->ware(macro)->transportType) {
-                                case GameWares::TransportType::Container:
-                                    // Container.
-                                    summary.requirements.requireContainerStorage
-                                        = true;
-                                    break;
-
-                                case GameWares::TransportType::Solid:
-                                    // Solid.
-                                    summary.requirements.requireSolidStorage
-                                        = true;
-                                    break;
-
-                                case GameWares::TransportType::Liquid:
-                                    // Liquid.
-                                    summary.requirements.requireLiquidStorage
-                                        = true;
-                                    break;
-
-                                default:
-                                    break;
-                            }
-
-                            // Resources.
-                            for (auto resouce : productionInfo->resources) {
-                                const QString &macro = resouce->id;
-
-                                // Find/create ware.
-                                auto iter = summary.resources.find(macro);
-                                if (iter == summary.resources.end()) {
-                                    summary.resources[macro]
-                                        = Range<long double>(
-                                            (long double)(resouce->amount)
-                                                * 3600 * saveModule->amount()
-                                                / productionInfo->time,
-                                            (long double)(resouce->amount)
-                                                * 3600 * saveModule->amount()
-                                                * (1.0
-                                                   + productionInfo->workEffect)
-                                                / productionInfo->time);
-                                } else {
-                                    // Increase amount.
-                                    iter->setRange(
-                                        (long double)(resouce->amount) * 3600
-                                                * saveModule->amount()
-                                                / productionInfo->time
-                                            + iter->min(),
-                                        (long double)(resouce->amount) * 3600
-                                                * saveModule->amount()
-                                                * (1.0
-                                                   + productionInfo->workEffect)
-                                                / productionInfo->time
-                                            + iter->max());
-                                }
-
-                                // Transport type.
-                                switch (gameWares->ware(macro)->transportType) {
-                                    case GameWares::TransportType::Container:
-                                        // Container.
-                                        summary.requirements
-                                            .requireContainerStorage
-                                            = true;
-                                        break;
-
-                                    case GameWares::TransportType::Solid:
-                                        // Solid.
-                                        summary.requirements.requireSolidStorage
-                                            = true;
-                                        break;
-
-                                    case GameWares::TransportType::Liquid:
-                                        // Liquid.
-                                        summary.requirements
-                                            .requireLiquidStorage
-                                            = true;
-                                        break;
-
-                                    default:
-                                        break;
-                                }
-                            }
-                        }
-                        break;
+/**
+ * @brief       Make summary from the amounts of modules.
+ */
+void EditorWidget::makeSummary(const QVector<quint64> &amounts,
+                               SummaryInfo &           summary)
+{
+    auto gameStationModules = GameData::instance()->stationModules();
+    const GameStationModules::ModuleTable &table = gameStationModules->table();
+
+    // Numeric properties.
+    GameStationModules::ColumnValues totals;
+    table.sum(amounts, totals);
+    auto total = [&](GameStationModules::Column column) -> quint64 {
+        return totals[(size_t)column];
+    };
+
+    summary.hull += total(GameStationModules::Column::Hull);
+    summary.explosionDamage
+        += total(GameStationModules::Column::ExplosionDamage);
+    summary.weapons.sLaunchTube
+        += total(GameStationModules::Column::SLaunchTube);
+    summary.weapons.mLaunchTube
+        += total(GameStationModules::Column::MLaunchTube);
+    summary.weapons.mTurret += total(GameStationModules::Column::MTurret);
+    summary.weapons.lTurret += total(GameStationModules::Column::LTurret);
+    summary.shields.mShield += total(GameStationModules::Column::MShield);
+    summary.shields.lShield += total(GameStationModules::Column::LShield);
+    summary.storage.container
+        += total(GameStationModules::Column::ContainerCargo);
+    summary.storage.solid += total(GameStationModules::Column::SolidCargo);
+    summary.storage.liquid += total(GameStationModules::Column::LiquidCargo);
+    summary.dockingBay.sDock += total(GameStationModules::Column::SDock);
+    summary.dockingBay.mDock += total(GameStationModules::Column::MDock);
+    summary.dockingBay.lDock += total(GameStationModules::Column::LDock);
+    summary.dockingBay.xlDock += total(GameStationModules::Column::XLDock);
+    summary.dockingBay.lXLDock += total(GameStationModules::Column::LXLDock);
+    summary.shipStorage.sShipCargo
+        += total(GameStationModules::Column::SShipCargo);
+    summary.shipStorage.mShipCargo
+        += total(GameStationModules::Column::MShipCargo);
+    summary.workforce += total(GameStationModules::Column::SupplyWorkforce);
+    summary.surplusWorkforce
+        += (qint64)(total(GameStationModules::Column::SupplyWorkforce))
+           - (qint64)(total(GameStationModules::Column::RequireWorkforce));
+
+    // Wares, indexed by ordinal of ware.
+    auto                        gameWares = GameData::instance()->wares();
+    int                         wareCount = gameWares->wareCount();
+    QVector<Range<long double>> products(wareCount, Range<long double>(0, 0));
+    QVector<Range<long double>> resources(wareCount,
+                                          Range<long double>(0, 0));
+    QVector<bool>               hasProducts(wareCount, false);
+    QVector<bool>               hasResources(wareCount, false);
+    quint32                     storageRequirements = 0;
+    for (int ordinal = 0; ordinal < table.size(); ++ordinal) {
+        quint64 amount = amounts[ordinal];
+        if (amount == 0) {
+            continue;
+        }
 
-                    case GameStationModules::Property::Type::Cargo:
-                        // Has cargo.
-                        {
-                            ::std::shared_ptr<GameStationModules::HasCargo>
-                                hasCargo = ::std::dynamic_pointer_cast<
-                                    GameStationModules::HasCargo>(property);
-
-                            switch (hasCargo->cargoType) {
-                                case GameWares::TransportType::Container:
-                                    // Container.
-                                    summary.storage.container
-                                        += hasCargo->cargoSize
-                                           * saveModule->amount();
-                                    break;
-
-                                case GameWares::TransportType::Solid:
-                                    // Solid.
-                                    summary.storage.solid
-                                        += hasCargo->cargoSize
-                                           * saveModule->amount();
-                                    break;
-
-                                case GameWares::TransportType::Liquid:
-                                    // Liquid.
-                                    summary.storage.liquid
-                                        += hasCargo->cargoSize
-                                           * saveModule->amount();
-                                    break;
-
-                                default:
-                                    break;
-                            }
-                        }
-                        break;
-                }
+        const GameStationModules::Contribution &contribution
+            = table.contributions[ordinal];
+        auto addRates = [&](QVector<Range<long double>> &              wares,
+                            QVector<bool> &                            has,
+                            const QVector<GameStationModules::WareRate> &rates)
+            -> void {
+            for (auto &rate : rates) {
+                Range<long double> &range = wares[rate.ware];
+                range.setRange(range.min() + rate.min * amount,
+                               range.max() + rate.max * amount);
+                has[rate.ware] = true;
             }
+        };
+        addRates(products, hasProducts, contribution.products);
+        addRates(resources, hasResources, contribution.resources);
+        storageRequirements |= contribution.storageRequirements;
+    }
+
+    // The names of wares are only used by the summary tree.
+    for (int ware = 0; ware < wareCount; ++ware) {
+        if (hasProducts[ware]) {
+            summary.products[gameWares->wareID(ware)] = products[ware];
+        }
+        if (hasResources[ware]) {
+            summary.resources[gameWares->wareID(ware)] = resources[ware];
         }
     }
 
+    // Requirements.
+    auto required = [&](GameStationModules::Storage storage) -> bool {
+        return (storageRequirements & ((quint32)1 << (size_t)storage)) != 0;
+    };
+    summary.requirements.requireContainerStorage
+        = required(GameStationModules::Storage::Container);
+    summary.requirements.requireSolidStorage
+        = required(GameStationModules::Storage::Solid);
+    summary.requirements.requireLiquidStorage
+        = required(GameStationModules::Storage::Liquid);
+
     // Intermediates
+    EditorWidget::makeIntermediates(summary);
+}
+
+/**
+ * @brief       Move the wares both produced and consumed to
+ *              intermediates.
+ */
+void EditorWidget::makeIntermediates(SummaryInfo &summary)
+{
     for (auto macro : summary.products.keys()) {
         if (summary.resources.find(macro) != summary.resources.end()) {
             auto productRange  = summary.products[macro];
@@ -990,6 +735,74 @@ void EditorWidget::makeSummary(SummaryInfo &summary)
     }
 }
 
+/**
+ * @brief       Compare summaries.
+ */
+bool EditorWidget::compareSummary(const SummaryInfo &summary1,
+                                  const SummaryInfo &summary2)
+{
+    // Numeric properties.
+    if (summary1.hull != summary2.hull
+        || summary1.explosionDamage != summary2.explosionDamage
+        || summary1.weapons.sLaunchTube != summary2.weapons.sLaunchTube
+        || summary1.weapons.mLaunchTube != summary2.weapons.mLaunchTube
+        || summary1.weapons.mTurret != summary2.weapons.mTurret
+        || summary1.weapons.lTurret != summary2.weapons.lTurret
+        || summary1.shields.mShield != summary2.shields.mShield
+        || summary1.shields.lShield != summary2.shields.lShield
+        || summary1.storage.container != summary2.storage.container
+        || summary1.storage.solid != summary2.storage.solid
+        || summary1.storage.liquid != summary2.storage.liquid
+        || summary1.dockingBay.sDock != summary2.dockingBay.sDock
+        || summary1.dockingBay.mDock != summary2.dockingBay.mDock
+        || summary1.dockingBay.lDock != summary2.dockingBay.lDock
+        || summary1.dockingBay.xlDock != summary2.dockingBay.xlDock
+        || summary1.dockingBay.lXLDock != summary2.dockingBay.lXLDock
+        || summary1.shipStorage.sShipCargo != summary2.shipStorage.sShipCargo
+        || summary1.shipStorage.mShipCargo != summary2.shipStorage.mShipCargo
+        || summary1.workforce != summary2.workforce
+        || summary1.surplusWorkforce != summary2.surplusWorkforce) {
+        return false;
+    }
+
+    // Requirements.
+    if (summary1.requirements.requireContainerStorage
+            != summary2.requirements.requireContainerStorage
+        || summary1.requirements.requireSolidStorage
+               != summary2.requirements.requireSolidStorage
+        || summary1.requirements.requireLiquidStorage
+               != summary2.requirements.requireLiquidStorage) {
+        return false;
+    }
+
+    // Wares, the rates are summed in different orders.
+    auto compareWares = [](const QMap<QString, Range<long double>> &wares1,
+                           const QMap<QString, Range<long double>> &wares2)
+        -> bool {
+        if (wares1.keys() != wares2.keys()) {
+            return false;
+        }
+        auto equals = [](long double value1, long double value2) -> bool {
+            return ::std::fabs(value1 - value2)
+                   <= 1e-6 * max(::std::fabs(value1), ::std::fabs(value2),
+                                 (long double)1.0);
+        };
+        for (auto iter = wares1.begin(); iter != wares1.end(); ++iter) {
+            const Range<long double> &range = wares2[iter.key()];
+            if (! equals(iter->min(), range.min())
+                || ! equals(iter->max(), range.max())) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    return compareWares(summary1.resources, summary2.resources)
+           && compareWares(summary1.intermediates, summary2.intermediates)
+           && compareWares(summary1.products, summary2.products);
+}
+
 /**
  * @brief       Show summary.
  *
@@ -1057,6 +870,23 @@ void EditorWidget::showSummary(const SummaryInfo &summary)
 #undef SET_HIDE_ZERO
 }
 
+/**
+ * @brief       Called when the summary has been made in background.
+ */
+void EditorWidget::onSummaryReady(quint64                        generation,
+                                  ::std::shared_ptr<SummaryInfo> summary)
+{
+    // Drop the stale summary.
+    if (m_summaryGeneration.loadAcquire() != generation) {
+        return;
+    }
+
+    this->showSummary(*summary);
+    this->checkSummary(*summary);
+
+    this->updateSuggestedAmounts(*summary);
+}
+
 /**
  * @brief       Check summary.
  *
@@ -1302,7 +1132,9 @@ void EditorWidget::redo()
     // Add to redo stack.
     m_undoStack.push_back(op);
 
+    this->updateSaveStatus();
     this->updateUndoRedoStatus();
+    this->updateSummary();
 }
 
 /**
@@ -41,6 +41,8 @@ bool EditorWidget::AddModuleOperation::doOperation()
 
     int newIndex = m_index;
     for (auto &macro : m_macros) {
+        editorWidget->m_summaryModel->addModule(macro, 1);
+
         ModuleItem *moduleItem = groupItem->child(macro);
         if (moduleItem == nullptr) {
             // Add module.
@@ -116,6 +118,8 @@ void EditorWidget::AddModuleOperation::undoOperation()
     ::std::shared_ptr<SaveGroup> saveGroup = groupItem->group();
 
     for (auto &macro : m_macros) {
+        editorWidget->m_summaryModel->addModule(macro, -1);
+
         // Get module.
         ModuleItem *moduleItem = groupItem->child(macro);
         Q_ASSERT(moduleItem != nullptr);
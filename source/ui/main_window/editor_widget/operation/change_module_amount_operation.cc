@@ -31,6 +31,8 @@ bool EditorWidget::ChangeModuleAmountOperation::doOperation()
     ModuleItem *moduleItem
         = static_cast<ModuleItem *>(groupItem->child(m_moduleIndex));
 
+    this->editorWidget()->m_summaryModel->addModule(
+        moduleItem->module()->module(), (qint64)m_newAmount - m_oldAmount);
     moduleItem->setModuleAmount((quint64)m_newAmount);
 
     ModuleItemWidget *moduleWidget = dynamic_cast<ModuleItemWidget *>(
@@ -51,6 +53,8 @@ void EditorWidget::ChangeModuleAmountOperation::undoOperation()
     ModuleItem *moduleItem
         = static_cast<ModuleItem *>(groupItem->child(m_moduleIndex));
 
+    this->editorWidget()->m_summaryModel->addModule(
+        moduleItem->module()->module(), (qint64)m_oldAmount - m_newAmount);
     moduleItem->setModuleAmount((quint64)m_oldAmount);
 
     ModuleItemWidget *moduleWidget = dynamic_cast<ModuleItemWidget *>(
@@ -76,6 +76,8 @@ bool EditorWidget::PasteGroupOperation::doOperation()
             int index
                 = saveGroup->insertModule(-1, module->macro, module->amount);
             Q_ASSERT(index >= 0);
+            editorWidget->m_summaryModel->addModule(module->macro,
+                                                    (qint64)module->amount);
 
             // Get save module.
             ::std::shared_ptr<SaveModule> saveModule = saveGroup->module(index);
@@ -150,6 +152,8 @@ void EditorWidget::PasteGroupOperation::undoOperation()
     EditorWidget *editorWidget = this->editorWidget();
 
     for (int i = 0; i < m_groups.size(); ++i) {
+        editorWidget->m_summaryModel->addGroup(
+            editorWidget->m_save->group(m_firstGroupIndex), -1);
         editorWidget->m_save->removeGroup(m_firstGroupIndex);
         editorWidget->m_itemGroups->removeChild(
             editorWidget->m_itemGroups->child(m_firstGroupIndex));
@@ -60,6 +60,7 @@ bool EditorWidget::PasteModuleOperation::doOperation()
     for (auto module : m_modules) {
         QString &                    macro     = module->macro;
         ::std::shared_ptr<SaveGroup> saveGroup = groupItem->group();
+        editorWidget->m_summaryModel->addModule(macro, (qint64)module->amount);
 
         ModuleItem *moduleItem = groupItem->child(module->macro);
         if (moduleItem == nullptr) {
@@ -145,12 +146,16 @@ void EditorWidget::PasteModuleOperation::undoOperation()
 
         if (moduleItem->moduleAmount() > module->amount) {
             // Decrease amount/
+            editorWidget->m_summaryModel->addModule(macro,
+                                                    -(qint64)module->amount);
             moduleItem->setModuleAmount(moduleItem->moduleAmount()
                                         - module->amount);
             moduleWidget->updateAmount();
         } else {
             // Remove.
             // Remove from save file.
+            editorWidget->m_summaryModel->addModule(
+                macro, -(qint64)moduleItem->moduleAmount());
             editorWidget->m_save->group(m_groupIndex)
                 ->removeModule(groupItem->indexOfChild(moduleItem));
 
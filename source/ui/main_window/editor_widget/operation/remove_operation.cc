@@ -100,6 +100,8 @@ bool EditorWidget::RemoveOperation::doOperation()
         Q_ASSERT(moduleItem != nullptr);
 
         // Remove from save file.
+        editorWidget->m_summaryModel->addModule(moduleInfo->macro,
+                                                -moduleInfo->amount);
         editorWidget->m_save->group(moduleInfo->groupIndex)
             ->removeModule(moduleInfo->moduleIndex);
 
@@ -130,6 +132,8 @@ bool EditorWidget::RemoveOperation::doOperation()
         Q_ASSERT(groupItem != nullptr);
 
         // Remove from save.
+        editorWidget->m_summaryModel->addGroup(
+            editorWidget->m_save->group(groupInfo->groupIndex), -1);
         editorWidget->m_save->removeGroup(groupInfo->groupIndex);
 
         // Remove group item.
@@ -197,6 +201,8 @@ void EditorWidget::RemoveOperation::undoOperation()
             // Add to save.
             int index = saveGroup->insertModule(-1, moduleInfo->macro,
                                                 moduleInfo->amount);
+            editorWidget->m_summaryModel->addModule(moduleInfo->macro,
+                                                    moduleInfo->amount);
 
             // Get save module.
             ::std::shared_ptr<SaveModule> saveModule = saveGroup->module(index);
@@ -236,6 +242,8 @@ void EditorWidget::RemoveOperation::undoOperation()
         int index = groupItem->group()->insertModule(
             moduleInfo->moduleIndex, moduleInfo->macro, moduleInfo->amount);
         Q_ASSERT(index == moduleInfo->moduleIndex);
+        editorWidget->m_summaryModel->addModule(moduleInfo->macro,
+                                                moduleInfo->amount);
 
         // Get Save module.
         ::std::shared_ptr<SaveModule> saveModule
@@ -0,0 +1,164 @@
+#include <ui/main_window/editor_widget/summary_model.h>
+
+/**
+ * @brief		Constructor.
+ */
+EditorWidget::SummaryModel::SummaryModel(::std::shared_ptr<Save> save)
+{
+    m_totals.fill(0);
+    m_storageReferences.fill(0);
+    for (auto group : save->groups()) {
+        this->addGroup(group, 1);
+    }
+}
+
+/**
+ * @brief		Apply the amount change of module.
+ */
+void EditorWidget::SummaryModel::addModule(const QString &macro, qint64 delta)
+{
+    auto gameStationModules = GameData::instance()->stationModules();
+    auto module             = gameStationModules->module(macro);
+    if (module == nullptr || delta == 0) {
+        return;
+    }
+
+    // Numeric properties, the totals never become negative so the unsigned
+    // arithmetic wraps back to the right value.
+    const GameStationModules::ModuleTable &table = gameStationModules->table();
+    for (size_t i = 0; i < m_totals.size(); ++i) {
+        m_totals[i] += table.columns[i][module->ordinal] * (quint64)delta;
+    }
+
+    // Wares.
+    const GameStationModules::Contribution &contribution
+        = table.contributions[module->ordinal];
+    for (auto &rate : contribution.products) {
+        SummaryModel::addWareRate(m_products, rate.ware, rate.min * delta,
+                                  rate.max * delta, delta);
+    }
+    for (auto &rate : contribution.resources) {
+        SummaryModel::addWareRate(m_resources, rate.ware, rate.min * delta,
+                                  rate.max * delta, delta);
+    }
+
+    // Storage requirements.
+    for (size_t i = 0; i < m_storageReferences.size(); ++i) {
+        if (contribution.storageRequirements & ((quint32)1 << i)) {
+            m_storageReferences[i] += delta;
+        }
+    }
+}
+
+/**
+ * @brief		Apply the amount changes of all modules in group.
+ */
+void EditorWidget::SummaryModel::addGroup(::std::shared_ptr<SaveGroup> group,
+                                          qint64                       sign)
+{
+    for (auto module : group->modules()) {
+        this->addModule(module->module(), sign * (qint64)(module->amount()));
+    }
+}
+
+/**
+ * @brief		Make summary.
+ */
+void EditorWidget::SummaryModel::makeSummary(SummaryInfo &summary) const
+{
+    auto total = [&](GameStationModules::Column column) -> quint64 {
+        return m_totals[(size_t)column];
+    };
+
+    // Numeric properties.
+    summary.hull = total(GameStationModules::Column::Hull);
+    summary.explosionDamage
+        = total(GameStationModules::Column::ExplosionDamage);
+    summary.weapons.sLaunchTube
+        = total(GameStationModules::Column::SLaunchTube);
+    summary.weapons.mLaunchTube
+        = total(GameStationModules::Column::MLaunchTube);
+    summary.weapons.mTurret = total(GameStationModules::Column::MTurret);
+    summary.weapons.lTurret = total(GameStationModules::Column::LTurret);
+    summary.shields.mShield = total(GameStationModules::Column::MShield);
+    summary.shields.lShield = total(GameStationModules::Column::LShield);
+    summary.storage.container
+        = total(GameStationModules::Column::ContainerCargo);
+    summary.storage.solid  = total(GameStationModules::Column::SolidCargo);
+    summary.storage.liquid = total(GameStationModules::Column::LiquidCargo);
+    summary.dockingBay.sDock   = total(GameStationModules::Column::SDock);
+    summary.dockingBay.mDock   = total(GameStationModules::Column::MDock);
+    summary.dockingBay.lDock   = total(GameStationModules::Column::LDock);
+    summary.dockingBay.xlDock  = total(GameStationModules::Column::XLDock);
+    summary.dockingBay.lXLDock = total(GameStationModules::Column::LXLDock);
+    summary.shipStorage.sShipCargo
+        = total(GameStationModules::Column::SShipCargo);
+    summary.shipStorage.mShipCargo
+        = total(GameStationModules::Column::MShipCargo);
+    summary.workforce = total(GameStationModules::Column::SupplyWorkforce);
+    summary.surplusWorkforce
+        = (qint64)(total(GameStationModules::Column::SupplyWorkforce))
+          - (qint64)(total(GameStationModules::Column::RequireWorkforce));
+
+    // Wares, the names of wares are only used by the summary tree.
+    auto gameWares = GameData::instance()->wares();
+    for (int ware = 0; ware < m_resources.size(); ++ware) {
+        const WareRate &rate = m_resources[ware];
+        if (rate.references != 0) {
+            summary.resources[gameWares->wareID(ware)]
+                = Range<long double>(rate.min, rate.max);
+        }
+    }
+
+    for (int ware = 0; ware < m_products.size(); ++ware) {
+        const WareRate &rate = m_products[ware];
+        if (rate.references != 0) {
+            summary.products[gameWares->wareID(ware)]
+                = Range<long double>(rate.min, rate.max);
+        }
+    }
+
+    // Requirements.
+    summary.requirements.requireContainerStorage
+        = m_storageReferences[(size_t)GameStationModules::Storage::Container]
+          > 0;
+    summary.requirements.requireSolidStorage
+        = m_storageReferences[(size_t)GameStationModules::Storage::Solid] > 0;
+    summary.requirements.requireLiquidStorage
+        = m_storageReferences[(size_t)GameStationModules::Storage::Liquid] > 0;
+
+    // Intermediates
+    EditorWidget::makeIntermediates(summary);
+}
+
+/**
+ * @brief		Destructor.
+ */
+EditorWidget::SummaryModel::~SummaryModel() {}
+
+/**
+ * @brief		Add rate of ware.
+ */
+void EditorWidget::SummaryModel::addWareRate(QVector<WareRate> &rates,
+                                             int                ware,
+                                             long double        min,
+                                             long double        max,
+                                             qint64             references)
+{
+    if (ware >= rates.size()) {
+        rates.insert(rates.end(), ware + 1 - rates.size(),
+                     WareRate({0.0, 0.0, 0}));
+    }
+
+    // Reset the ware when no module references it, so the rounding errors
+    // of the removed modules are dropped too.
+    WareRate &rate = rates[ware];
+    rate.references += references;
+    if (rate.references == 0) {
+        rate.min = 0.0;
+        rate.max = 0.0;
+    } else {
+        rate.min += min;
+        rate.max += max;
+    }
+}
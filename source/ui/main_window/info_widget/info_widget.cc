@@ -297,191 +297,61 @@ void InfoWidget::updateModule(const QString &macro)
                            QString("%1").arg(module->explosiondamage))));
     m_treeInfo->addTopLevelItem(explosionDamageItem);
 
-    // Weapon/Sield
-    // M turret
-    auto iter
-        = module->properties.find(GameStationModules::Property::Type::MTurret);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasMTurret> property
-            = ::std::static_pointer_cast<GameStationModules::HasMTurret>(*iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_M_TURRET")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // M shield
-    iter = module->properties.find(GameStationModules::Property::Type::MShield);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasMShield> property
-            = ::std::static_pointer_cast<GameStationModules::HasMShield>(*iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_M_SHIELD")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // L turret
-    iter = module->properties.find(GameStationModules::Property::Type::LTurret);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasLTurret> property
-            = ::std::static_pointer_cast<GameStationModules::HasLTurret>(*iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_L_TURRET")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // L shield
-    iter = module->properties.find(GameStationModules::Property::Type::LShield);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasLShield> property
-            = ::std::static_pointer_cast<GameStationModules::HasLShield>(*iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_L_SHIELD")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // S launch tube
-    iter = module->properties.find(
-        GameStationModules::Property::Type::SLaunchTube);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasSLaunchTube> property
-            = ::std::static_pointer_cast<GameStationModules::HasSLaunchTube>(
-                *iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_S_LAUNCH_TUBE")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
+    // Numeric properties are read from the module table.
+    const GameStationModules::ModuleTable &table
+        = GameData::instance()->stationModules()->table();
+    auto addNumericItem = [&](GameStationModules::Property::Type type,
+                              GameStationModules::Column         column,
+                              const QString &title) -> void {
+        if (module->ordinal < 0 || ! table.hasProperty(module->ordinal, type)) {
+            return;
+        }
+        QTreeWidgetItem *item = new InfoItem(
+            ::std::unique_ptr<GenericString>(new LocaleString(title)),
+            ::std::unique_ptr<GenericString>(new QtString(
+                QString("%1").arg(table.value(module->ordinal, column)))));
         m_treeInfo->addTopLevelItem(item);
-    }
+    };
 
-    // M launch tube
-    iter = module->properties.find(
-        GameStationModules::Property::Type::MLaunchTube);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasMLaunchTube> property
-            = ::std::static_pointer_cast<GameStationModules::HasMLaunchTube>(
-                *iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_M_LAUNCH_TUBE")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
+    // Weapon/Sield
+    addNumericItem(GameStationModules::Property::Type::MTurret,
+                   GameStationModules::Column::MTurret, "STR_INFO_M_TURRET");
+    addNumericItem(GameStationModules::Property::Type::MShield,
+                   GameStationModules::Column::MShield, "STR_INFO_M_SHIELD");
+    addNumericItem(GameStationModules::Property::Type::LTurret,
+                   GameStationModules::Column::LTurret, "STR_INFO_L_TURRET");
+    addNumericItem(GameStationModules::Property::Type::LShield,
+                   GameStationModules::Column::LShield, "STR_INFO_L_SHIELD");
+    addNumericItem(GameStationModules::Property::Type::SLaunchTube,
+                   GameStationModules::Column::SLaunchTube,
+                   "STR_INFO_S_LAUNCH_TUBE");
+    addNumericItem(GameStationModules::Property::Type::MLaunchTube,
+                   GameStationModules::Column::MLaunchTube,
+                   "STR_INFO_M_LAUNCH_TUBE");
 
     // Harbor
-    // S docking bay
-    iter = module->properties.find(GameStationModules::Property::Type::SDock);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasSDock> property
-            = ::std::static_pointer_cast<GameStationModules::HasSDock>(*iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_S_DOCK")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // S ship cargo
-    iter = module->properties.find(
-        GameStationModules::Property::Type::SShipCargo);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasSShipCargo> property
-            = ::std::static_pointer_cast<GameStationModules::HasSShipCargo>(
-                *iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_S_SHIP_CAPACITY")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->capacity))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // M docking bay
-    iter = module->properties.find(GameStationModules::Property::Type::MDock);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasMDock> property
-            = ::std::static_pointer_cast<GameStationModules::HasMDock>(*iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_M_DOCK")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // M ship cargo
-    iter = module->properties.find(
-        GameStationModules::Property::Type::MShipCargo);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasMShipCargo> property
-            = ::std::static_pointer_cast<GameStationModules::HasMShipCargo>(
-                *iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_M_SHIP_CAPACITY")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->capacity))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // L docking bay
-    iter = module->properties.find(GameStationModules::Property::Type::LDock);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasLDock> property
-            = ::std::static_pointer_cast<GameStationModules::HasLDock>(*iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_L_DOCK")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // XL docking bay
-    iter = module->properties.find(GameStationModules::Property::Type::XLDock);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasXLDock> property
-            = ::std::static_pointer_cast<GameStationModules::HasXLDock>(*iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_XL_DOCK")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
-
-    // L/XL docking bay
-    iter = module->properties.find(GameStationModules::Property::Type::LXLDock);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::HasLXLDock> property
-            = ::std::static_pointer_cast<GameStationModules::HasLXLDock>(*iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_L_XL_DOCK")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->count))));
-        m_treeInfo->addTopLevelItem(item);
-    }
+    addNumericItem(GameStationModules::Property::Type::SDock,
+                   GameStationModules::Column::SDock, "STR_INFO_S_DOCK");
+    addNumericItem(GameStationModules::Property::Type::SShipCargo,
+                   GameStationModules::Column::SShipCargo,
+                   "STR_INFO_S_SHIP_CAPACITY");
+    addNumericItem(GameStationModules::Property::Type::MDock,
+                   GameStationModules::Column::MDock, "STR_INFO_M_DOCK");
+    addNumericItem(GameStationModules::Property::Type::MShipCargo,
+                   GameStationModules::Column::MShipCargo,
+                   "STR_INFO_M_SHIP_CAPACITY");
+    addNumericItem(GameStationModules::Property::Type::LDock,
+                   GameStationModules::Column::LDock, "STR_INFO_L_DOCK");
+    addNumericItem(GameStationModules::Property::Type::XLDock,
+                   GameStationModules::Column::XLDock, "STR_INFO_XL_DOCK");
+    addNumericItem(GameStationModules::Property::Type::LXLDock,
+                   GameStationModules::Column::LXLDock, "STR_INFO_L_XL_DOCK");
 
     // Habitat
     QTreeWidgetItem *resourcesItem = nullptr;
 
     // Workforce supply
-    iter = module->properties.find(
+    auto iter = module->properties.find(
         GameStationModules::Property::Type::SupplyWorkforce);
     if (iter != module->properties.end()) {
         ::std::shared_ptr<GameStationModules::SupplyWorkforce> property
@@ -518,20 +388,9 @@ void InfoWidget::updateModule(const QString &macro)
     }
 
     // Product/Build
-    // Workforce required
-    iter = module->properties.find(
-        GameStationModules::Property::Type::RequireWorkforce);
-    if (iter != module->properties.end()) {
-        ::std::shared_ptr<GameStationModules::RequireWorkforce> property
-            = ::std::static_pointer_cast<GameStationModules::RequireWorkforce>(
-                *iter);
-        QTreeWidgetItem *item
-            = new InfoItem(::std::unique_ptr<GenericString>(
-                               new LocaleString("STR_INFO_REQUIRE_WORKFORCE")),
-                           ::std::unique_ptr<GenericString>(new QtString(
-                               QString("%1").arg(property->workforce))));
-        m_treeInfo->addTopLevelItem(item);
-    }
+    addNumericItem(GameStationModules::Property::Type::RequireWorkforce,
+                   GameStationModules::Column::RequireWorkforce,
+                   "STR_INFO_REQUIRE_WORKFORCE");
 
     // Product
     iter = module->properties.find(
@@ -0,0 +1,192 @@
+#include <QtCore/QAtomicInt>
+#include <QtCore/QVector>
+
+#include <common/multi_threading/multi_run.h>
+#include <common/multi_threading/task_pool.h>
+#include <test.h>
+
+/**
+ * @brief		Sum [begin, end) with nested task groups, each group splits
+ *				the range and waits for the halves.
+ *
+ * @param[in]	begin		Begin of the range.
+ * @param[in]	end			End of the range.
+ *
+ * @return		Sum of the range.
+ */
+static qint64 nestedSum(qint64 begin, qint64 end)
+{
+    if (end - begin <= 16) {
+        qint64 sum = 0;
+        for (qint64 i = begin; i < end; ++i) {
+            sum += i;
+        }
+        return sum;
+    }
+
+    qint64    mid   = begin + (end - begin) / 2;
+    qint64    left  = 0;
+    qint64    right = 0;
+    TaskGroup group;
+    group.run([&]() -> void {
+        left = nestedSum(begin, mid);
+    });
+    group.run([&]() -> void {
+        right = nestedSum(mid, end);
+    });
+    group.wait();
+
+    return left + right;
+}
+
+/**
+ * @brief		Run a lot of small tasks.
+ */
+static bool testSmallTasks(int count)
+{
+    QAtomicInt counter(0);
+    {
+        TaskGroup group;
+        for (int i = 0; i < count; ++i) {
+            group.run([&]() -> void {
+                counter.fetchAndAddRelaxed(1);
+            });
+        }
+        group.wait();
+    }
+    TEST_CHECK(counter.loadAcquire() == count);
+
+    return true;
+}
+
+/**
+ * @brief		Each index in the range is visited exactly once.
+ */
+static bool testParallelFor(int size)
+{
+    QVector<QAtomicInt> visited(size);
+    for (int grain : {1, 7, 64, size}) {
+        for (auto &v : visited) {
+            v.storeRelease(0);
+        }
+        TaskPool::parallelFor(
+            0, size,
+            [&](int begin, int end) -> void {
+                for (int i = begin; i < end; ++i) {
+                    visited[i].fetchAndAddRelaxed(1);
+                }
+            },
+            grain);
+        for (auto &v : visited) {
+            TEST_CHECK(v.loadAcquire() == 1);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief		Groups waiting inside tasks must not deadlock.
+ */
+static bool testNestedGroups()
+{
+    const qint64 size = 1 << 16;
+    TEST_CHECK(nestedSum(0, size) == size * (size - 1) / 2);
+
+    return true;
+}
+
+/**
+ * @brief		Submit from several external threads at the same time.
+ */
+static bool testConcurrentSubmit(int count)
+{
+    QAtomicInt counter(0);
+    QAtomicInt submitters(0);
+    MultiRun   multiRun(::std::function<void()>([&]() -> void {
+        submitters.fetchAndAddRelaxed(1);
+        TaskGroup group;
+        for (int i = 0; i < count; ++i) {
+            group.run([&]() -> void {
+                counter.fetchAndAddRelaxed(1);
+            });
+        }
+        group.wait();
+    }));
+    multiRun.run();
+    TEST_CHECK(counter.loadAcquire() == submitters.loadAcquire() * count);
+
+    return true;
+}
+
+/**
+ * @brief		Cancel a group with queued tasks.
+ */
+static bool testCancel(int count)
+{
+    QAtomicInt counter(0);
+    {
+        TaskGroup group;
+        for (int i = 0; i < count; ++i) {
+            group.run([&]() -> void {
+                if (! group.canceled()) {
+                    counter.fetchAndAddRelaxed(1);
+                }
+            });
+        }
+        group.cancel();
+        group.wait();
+        TEST_CHECK(group.canceled());
+    }
+    TEST_CHECK(counter.loadAcquire() <= count);
+
+    // The pool is still usable.
+    return testSmallTasks(count);
+}
+
+/**
+ * @brief		Run test, the first argument is the rounds of the stress
+ *				test.
+ */
+static bool runTaskPoolStress(const QStringList &args)
+{
+    int rounds = args.empty() ? 20 : args[0].toInt();
+    qInfo().noquote() << QString("Task pool : %1 threads.")
+                             .arg(TaskPool::instance()->threadCount());
+
+    for (int i = 0; i < rounds; ++i) {
+        if (! (testSmallTasks(10000) && testParallelFor(10007)
+               && testNestedGroups() && testConcurrentSubmit(1000)
+               && testCancel(10000))) {
+            qWarning() << "Failed in round" << i << ".";
+            return false;
+        }
+    }
+
+    // Overhead of tasks.
+    TestCase::benchmark("TaskGroup 10000 empty tasks", rounds,
+                        [&]() -> void {
+                            TaskGroup group;
+                            for (int i = 0; i < 10000; ++i) {
+                                group.run([]() -> void {});
+                            }
+                            group.wait();
+                        });
+    TestCase::benchmark("parallelFor 1M indexes, grain 1024", rounds,
+                        [&]() -> void {
+                            QAtomicInt sum(0);
+                            TaskPool::parallelFor(
+                                0, 1 << 20,
+                                [&](int begin, int end) -> void {
+                                    sum.fetchAndAddRelaxed(end - begin);
+                                },
+                                1024);
+                        });
+    TestCase::benchmark("Nested groups", rounds, [&]() -> void {
+        nestedSum(0, 1 << 16);
+    });
+
+    return true;
+}
+
+static TestCase taskPoolStress("task_pool_stress", &runTaskPoolStress);
@@ -0,0 +1,168 @@
+#include <QtCore/QAtomicInt>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <QtCore/QXmlStreamReader>
+
+#include <common/multi_threading/multi_run.h>
+#include <common/xml_loader.h>
+#include <test.h>
+
+/**
+ * @brief		Generate XML document similar to a macro file.
+ *
+ * @param[in]	count		Count of macros.
+ *
+ * @return		Data of the document.
+ */
+static QByteArray generateXML(int count)
+{
+    QByteArray data = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<macros>\n";
+    for (int i = 0; i < count; ++i) {
+        data.append(QString("  <macro name=\"macro_%1\" class=\"production\">\n"
+                            "    <component ref=\"component_%1\"/>\n"
+                            "    <properties>\n"
+                            "      <identification name=\"{20104,%1}\" "
+                            "makerrace=\"argon\"/>\n"
+                            "      <hull max=\"%1\"/>\n"
+                            "      <workforce max=\"%1\"/>\n"
+                            "    </properties>\n"
+                            "    <connections>\n"
+                            "      <connection ref=\"connection_%1\">\n"
+                            "        <macro ref=\"dock_%1\"/>\n"
+                            "      </connection>\n"
+                            "    </connections>\n"
+                            "  </macro>\n")
+                        .arg(i)
+                        .toUtf8());
+    }
+    data.append("</macros>\n");
+
+    return data;
+}
+
+/**
+ * @brief		Parse document with \c XMLLoader, all elements are handled
+ *				in the first context.
+ *
+ * @param[in]	data		Data of the document.
+ * @param[out]	count		Count of elements.
+ *
+ * @return		If the names of start and stop elements match, true is
+ *				returned. Otherwise returns false.
+ */
+static bool parseWithLoader(const QByteArray &data, int &count)
+{
+    QXmlStreamReader                      reader(data);
+    XMLLoader                             loader;
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
+    QStringList                           names;
+    bool                                  matched = true;
+    count                                         = 0;
+    context->setOnStartElement(
+        [&](XMLLoader &, XMLLoader::Context &, const QString &name,
+            const XMLLoader::Attributes &attr) -> bool {
+            names.append(name);
+            if (name == "macro" && attr["name"].isEmpty()
+                && attr["ref"].isEmpty()) {
+                matched = false;
+            }
+            ++count;
+            return true;
+        });
+    context->setOnStopElement(
+        [&](XMLLoader &, XMLLoader::Context &, const QString &name) -> bool {
+            if (names.empty() || names.back() != name) {
+                matched = false;
+            } else {
+                names.pop_back();
+            }
+            return true;
+        });
+
+    return loader.parse(reader, ::std::move(context)) && matched
+           && names.empty();
+}
+
+/**
+ * @brief		Parse document with \c QXmlStreamReader only.
+ *
+ * @param[in]	data		Data of the document.
+ *
+ * @return		Count of elements.
+ */
+static int parseWithReader(const QByteArray &data)
+{
+    QXmlStreamReader reader(data);
+    int              count = 0;
+    while (! reader.atEnd()) {
+        if (reader.readNext() == QXmlStreamReader::TokenType::StartElement) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief		Run test, the first argument is the iterations of benchmark.
+ */
+static bool runXMLLoaderBenchmark(const QStringList &args)
+{
+    int        iterations = args.empty() ? 20 : args[0].toInt();
+    QByteArray data       = generateXML(2000);
+
+    // Correctness.
+    int count = 0;
+    TEST_CHECK(parseWithLoader(data, count));
+    TEST_CHECK(count == parseWithReader(data));
+    qInfo().noquote() << QString("XML loader : %1 bytes, %2 elements.")
+                             .arg(data.size())
+                             .arg(count);
+
+    // The same names get the same IDs in all threads.
+    QStringList  names = {"macro", "hull", "connection", "benchmark_only"};
+    QVector<int> ids(names.size());
+    for (int i = 0; i < names.size(); ++i) {
+        XMLLoader::internName(QStringRef(&names[i]), ids[i]);
+    }
+    QAtomicInt failed(0);
+    {
+        MultiRun multiRun(::std::function<void()>([&]() -> void {
+            int count;
+            if (! parseWithLoader(data, count)) {
+                failed.fetchAndAddRelaxed(1);
+            }
+            for (int i = names.size() - 1; i >= 0; --i) {
+                int     id;
+                QString name
+                    = XMLLoader::internName(QStringRef(&names.at(i)), id);
+                if (id != ids.at(i) || name != names.at(i)) {
+                    failed.fetchAndAddRelaxed(1);
+                }
+            }
+        }));
+        multiRun.run();
+    }
+    TEST_CHECK(failed.loadAcquire() == 0);
+
+    // Throughput.
+    TestCase::benchmark("QXmlStreamReader", iterations, [&]() -> void {
+        parseWithReader(data);
+    });
+    TestCase::benchmark("XMLLoader", iterations, [&]() -> void {
+        int count;
+        parseWithLoader(data, count);
+    });
+    TestCase::benchmark("XMLLoader, all threads", iterations, [&]() -> void {
+        MultiRun multiRun(::std::function<void()>([&]() -> void {
+            int count;
+            parseWithLoader(data, count);
+        }));
+        multiRun.run();
+    });
+
+    return true;
+}
+
+static TestCase xmlLoaderBenchmark("xml_loader_benchmark",
+                                   &runXMLLoaderBenchmark);
@@ -0,0 +1,159 @@
+#include <QtCore/QMap>
+#include <QtCore/QXmlStreamReader>
+
+#include <common/xml_loader.h>
+#include <common/xml_schema.h>
+#include <game_data/game_components.h>
+#include <game_data/game_macros.h>
+#include <game_data/vfs_fixture.h>
+#include <test.h>
+
+static constexpr const char _indexSchema[]
+    = "/index/entry@name,@value"; ///< Schema of index files.
+
+/**
+ * @brief		Generate index file.
+ *
+ * @param[in]	count		Count of entries.
+ * @param[in]	suffix		Suffix of names.
+ *
+ * @return		Data of the index file.
+ */
+static QByteArray generateIndex(int count, const QString &suffix)
+{
+    QByteArray data = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<index>\n";
+    for (int i = 0; i < count; ++i) {
+        data.append(QString("  <entry name=\"entry_%1_%2\" "
+                            "value=\"assets\\structures\\dir_%3\\entry_%1_%2\" "
+                            "/>\n")
+                        .arg(i)
+                        .arg(suffix)
+                        .arg(i % 32)
+                        .toUtf8());
+    }
+    data.append("</index>\n");
+
+    return data;
+}
+
+/**
+ * @brief		Parse index file with the schema parser.
+ *
+ * @param[in]	data		Data of the index file.
+ *
+ * @return		Entries.
+ */
+static QMap<QString, QString> parseWithSchema(const QByteArray &data)
+{
+    QMap<QString, QString> ret;
+    QXmlStreamReader       reader(data);
+    XMLSchema<_indexSchema>::parse(
+        reader, [&](const XMLSchema<_indexSchema>::Values &values) {
+            QString value = "/";
+            value.append(values[1]);
+            value.replace('\\', '/');
+            ret[values[0].toString()] = value;
+        });
+
+    return ret;
+}
+
+/**
+ * @brief		Parse index file with \c XMLLoader callbacks, the way the
+ *				index files were parsed before the schema parser.
+ *
+ * @param[in]	data		Data of the index file.
+ *
+ * @return		Entries.
+ */
+static QMap<QString, QString> parseWithLoader(const QByteArray &data)
+{
+    QMap<QString, QString>                ret;
+    QXmlStreamReader                      reader(data);
+    XMLLoader                             loader;
+    ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
+    context->setOnStartElement([&](XMLLoader &loader, XMLLoader::Context &,
+                                   const QString &name,
+                                   const XMLLoader::Attributes &) -> bool {
+        ::std::unique_ptr<XMLLoader::Context> context = loader.createContext();
+        if (name == "index") {
+            context->setOnStartElement(
+                [&](XMLLoader &loader, XMLLoader::Context &,
+                    const QString &name,
+                    const XMLLoader::Attributes &attr) -> bool {
+                    if (name == "entry") {
+                        auto nameIter  = attr.find("name");
+                        auto valueIter = attr.find("value");
+                        if (nameIter != attr.end()
+                            && valueIter != attr.end()) {
+                            QString value = "/";
+                            value.append(valueIter.value());
+                            value.replace('\\', '/');
+                            ret[nameIter.value()] = value;
+                        }
+                    }
+                    loader.pushContext(loader.createContext());
+                    return true;
+                });
+        }
+        loader.pushContext(::std::move(context));
+        return true;
+    });
+    loader.parse(reader, ::std::move(context));
+
+    return ret;
+}
+
+/**
+ * @brief		Run test, the first argument is the iterations of benchmark.
+ */
+static bool runGameIndexBenchmark(const QStringList &args)
+{
+    int        iterations = args.empty() ? 20 : args[0].toInt();
+    QByteArray macroData  = generateIndex(20000, "macro");
+
+    // Both parsers get the same entries.
+    QMap<QString, QString> entries = parseWithSchema(macroData);
+    TEST_CHECK(entries.size() == 20000);
+    TEST_CHECK(entries == parseWithLoader(macroData));
+    TEST_CHECK(entries["entry_5_macro"]
+               == "/assets/structures/dir_5/entry_5_macro");
+
+    // Load macros and components from VFS.
+    VFSFixture fixture;
+    fixture.addFile("index/macros.xml", macroData);
+    fixture.addFile("index/components.xml", generateIndex(100, "component"));
+    ::std::shared_ptr<GameVFS> vfs = fixture.create();
+    TEST_CHECK(vfs != nullptr);
+
+    auto setText = [](const QString &) -> void {};
+    ::std::shared_ptr<GameMacros> macros = GameMacros::load(vfs, setText);
+    TEST_CHECK(macros != nullptr);
+    TEST_CHECK(macros->macro("entry_7_macro")
+               == "/assets/structures/dir_7/entry_7_macro");
+    TEST_CHECK(macros->macro("missing").isEmpty());
+    ::std::shared_ptr<GameComponents> components
+        = GameComponents::load(vfs, setText);
+    TEST_CHECK(components != nullptr);
+    TEST_CHECK(components->component("entry_42_component")
+               == "/assets/structures/dir_10/entry_42_component");
+
+    // Schema parser vs generic path.
+    qInfo().noquote() << QString("Index : %1 bytes, %2 entries.")
+                             .arg(macroData.size())
+                             .arg(entries.size());
+    TestCase::benchmark("Index, XMLSchema", iterations, [&]() -> void {
+        parseWithSchema(macroData);
+    });
+    TestCase::benchmark("Index, XMLLoader", iterations, [&]() -> void {
+        parseWithLoader(macroData);
+    });
+    TestCase::benchmark("GameMacros::load()", iterations, [&]() -> void {
+        GameMacros::load(vfs, setText);
+    });
+
+    return true;
+}
+
+static TestCase gameIndexBenchmark("game_index_benchmark",
+                                   &runGameIndexBenchmark);
@@ -0,0 +1,477 @@
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMap>
+#include <QtCore/QPair>
+#include <QtCore/QRegExp>
+#include <QtCore/QSet>
+#include <QtCore/QStack>
+#include <QtCore/QVector>
+#include <QtCore/QXmlStreamReader>
+
+#include <common.h>
+#include <game_data/game_texts.h>
+#include <game_data/vfs_fixture.h>
+#include <locale/string_table.h>
+#include <test.h>
+
+/**
+ * @brief	Link of text parsed by the reference parser.
+ */
+struct ReferenceLink {
+    bool    isRef;  ///< True if the link is a reference.
+    QString text;   ///< Text.
+    qint32  pageID; ///< ID of referenced page.
+    qint32  textID; ///< ID of referenced text.
+};
+
+typedef QMap<QPair<qint32, qint32>, QVector<ReferenceLink>> ReferencePages;
+typedef QMap<quint32, ReferencePages>                       ReferenceTexts;
+
+/**
+ * @brief		Parse excape characters, copied from the regex parser.
+ *
+ * @param[in]	s		String to parse.
+ *
+ * @return		String parsed.
+ */
+static QString referenceParseEscape(const QString &s)
+{
+    QString ret = "";
+    for (auto iter = s.begin(); iter < s.end(); iter++) {
+        if (*iter == '\\') {
+            ++iter;
+            if (iter == s.end()) {
+                continue;
+            }
+            // Parse escape characters.
+            switch (iter->unicode()) {
+                case 'n':
+                    // \n
+                    ret.append('\n');
+                    break;
+
+                case 'r':
+                    // \r
+                    ret.append('\r');
+                    break;
+
+                case 't':
+                    // \t
+                    ret.append('\t');
+                    break;
+
+                case 'v':
+                    // \v
+                    ret.append('\v');
+                    break;
+
+                case 'a':
+                    // \a
+                    ret.append('\a');
+                    break;
+
+                case 'b':
+                    // \b
+                    ret.append('\b');
+                    break;
+
+                case 'f':
+                    // \f
+                    ret.append('\f');
+                    break;
+
+                case 'x':
+                    // \xhh
+                    {
+                        ushort n = 0;
+                        if (iter + 1 != s.end()
+                            && between((iter + 1)->unicode(), '0', '9')) {
+                            n = n * 0x10 + (iter->unicode() - '0');
+                        } else if (iter + 1 != s.end()
+                                   && between((iter + 1)->unicode(), 'a',
+                                              'f')) {
+                            n = n * 0x10 + (iter->unicode() - 'a');
+                        } else if (iter + 1 != s.end()
+                                   && between((iter + 1)->unicode(), 'A',
+                                              'F')) {
+                            n = n * 0x10 + (iter->unicode() - 'A');
+                        } else {
+                            break;
+                        }
+
+                        ++iter;
+                        if (iter == s.end()) {
+                            continue;
+                        }
+
+                        if (iter + 1 != s.end()
+                            && between((iter + 1)->unicode(), '0', '9')) {
+                            n = n * 0x10 + (iter->unicode() - '0');
+                        } else if (iter + 1 != s.end()
+                                   && between((iter + 1)->unicode(), 'a',
+                                              'f')) {
+                            n = n * 0x10 + (iter->unicode() - 'a');
+                        } else if (iter + 1 != s.end()
+                                   && between((iter + 1)->unicode(), 'A',
+                                              'F')) {
+                            n = n * 0x10 + (iter->unicode() - 'A');
+                        }
+                        ret.append(QChar(n));
+                    }
+                    break;
+
+                case '0':
+                    // \0
+                    if ((iter + 1) == s.end() || ! (iter + 1)->isDigit()) {
+                        ret.append('\0');
+                        break;
+                    }
+
+                default:
+                    if (iter->isDigit()) {
+                        // \ddd
+                        ushort n = iter->digitValue();
+                        if (iter + 1 != s.end() && (iter + 1)->isDigit()) {
+                            ++iter;
+                            n = n * 010 + iter->digitValue();
+                        } else {
+                            ret.append(QChar(n));
+                            break;
+                        }
+                        if (iter + 1 != s.end() && (iter + 1)->isDigit()) {
+                            ++iter;
+                            n = n * 010 + iter->digitValue();
+                        }
+                        ret.append(QChar(n));
+
+                        break;
+                    } else {
+                        ret.append(*iter);
+                    }
+            }
+        } else {
+            // Copy character.
+            ret.append(*iter);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief		Parse text with regular expressions, copied from the parser
+ *				replaced by the single-pass scanner.
+ *
+ * @param[in]	s		Text to parse.
+ *
+ * @return		Links.
+ */
+static QVector<ReferenceLink> referenceParseText(QString s)
+{
+    QVector<ReferenceLink> ret;
+    QRegExp                ignoreExp("\\(.*\\)");
+    QRegExp referenceExp("\\{\\s*(\\d+)\\s*,\\s*(\\d+)\\s*\\}");
+
+    s = s.replace(ignoreExp, "");
+    while (s != "") {
+        int index = referenceExp.indexIn(s);
+        if (index == -1) {
+            // No reference exists.
+            ret.append({false, referenceParseEscape(s), 0, 0});
+            break;
+        } else {
+            // Reference found.
+            if (index > 0) {
+                // Before
+                ret.append({false, referenceParseEscape(s.left(index)), 0, 0});
+            }
+
+            // Reference
+            ret.append({true, QString(), referenceExp.cap(1).toInt(),
+                        referenceExp.cap(2).toInt()});
+
+            // After
+            s = s.mid(index + referenceExp.cap().size());
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief		Load text file with the reference parser.
+ *
+ * @param[in]	data		Data of the text file.
+ * @param[out]	texts		Texts loaded.
+ */
+static void referenceLoad(const QByteArray &data, ReferenceTexts &texts)
+{
+    QXmlStreamReader reader(data);
+    QStack<QString>  elements;
+    ReferencePages * pages  = nullptr;
+    qint32           pageID = 0;
+    qint32           textID = 0;
+    while (! reader.atEnd()) {
+        switch (reader.readNext()) {
+            case QXmlStreamReader::TokenType::StartElement: {
+                QString              name = reader.name().toString();
+                QXmlStreamAttributes attr = reader.attributes();
+                if (elements.size() == 0 && name == "language"
+                    && attr.hasAttribute("id")) {
+                    pages = &texts[attr.value("id").toUInt()];
+                } else if (elements.size() == 1 && name == "page"
+                           && attr.hasAttribute("id")) {
+                    pageID = attr.value("id").toInt();
+                } else if (elements.size() == 2 && name == "t"
+                           && attr.hasAttribute("id")) {
+                    textID = attr.value("id").toInt();
+                } else {
+                    reader.skipCurrentElement();
+                    break;
+                }
+                elements.push(name);
+            } break;
+
+            case QXmlStreamReader::TokenType::EndElement:
+                elements.pop();
+                break;
+
+            case QXmlStreamReader::TokenType::Characters:
+                // The texts appended later overwrite the texts before.
+                if (elements.size() == 3) {
+                    (*pages)[{pageID, textID}]
+                        = referenceParseText(reader.text().toString());
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief		Resolve text loaded by the reference parser.
+ *
+ * @param[in]	texts		Texts.
+ * @param[in]	pageID		Page ID of the text.
+ * @param[in]	textID		ID of the text.
+ *
+ * @return		Text.
+ */
+static QString referenceText(const ReferenceTexts &texts,
+                             qint32                pageID,
+                             qint32                textID)
+{
+    // Current language, en_US if not found.
+    for (quint32 id : {StringTable::instance()->languageId(), (uint32_t)44}) {
+        auto pagesIter = texts.find(id);
+        if (pagesIter == texts.end()) {
+            continue;
+        }
+        auto iter = pagesIter->find({pageID, textID});
+        if (iter == pagesIter->end()) {
+            continue;
+        }
+
+        QString ret = "";
+        for (auto &link : *iter) {
+            if (link.isRef) {
+                ret.append(referenceText(texts, link.pageID, link.textID));
+            } else {
+                ret.append(link.text);
+            }
+        }
+        return ret;
+    }
+
+    return "";
+}
+
+/**
+ * @brief		Generate text file from the built-in corpus.
+ *
+ * @param[in]	pageCount	Count of the pages which use the corpus.
+ *
+ * @return		Data of the text file.
+ */
+static QByteArray generateTextFile(int pageCount)
+{
+    // Referenced texts.
+    QStringList referenced = {
+        "One",
+        "Two {1001,4}",
+        "Three (comment)",
+        "Four",
+    };
+
+    // Texts to parse.
+    QStringList corpus = {
+        "",
+        "plain text",
+        "{1001,1}",
+        "{ 1001 , 2 }",
+        "{1001,\n3}",
+        "{\t1001,1\t}",
+        QString("{") + QChar(0x00a0) + "1001,1" + QChar(0x3000) + "}",
+        "before {1001,1} after",
+        "{1001,1}{1001,2}{1001,3}",
+        "{1001,99} missing",
+        "(comment) text",
+        "text (a) middle (b) end",
+        "(unclosed text",
+        "closed) text (",
+        "{1001,1} (comment {1001,2}) tail",
+        "(comment {1001,2}",
+        "{1001,}",
+        "{,1}",
+        "{1001 1}",
+        "{{1001,1}}",
+        "{1001,1",
+        "1001,1}",
+        "{a,b}",
+        "{-1,1}",
+        "{+1001,1}",
+        "{01001,0001}",
+        "{99999999999,1}",
+        QString("{") + QChar(0x0661) + QChar(0x0660) + ",1}",
+        "a\\nb\\tc\\rd",
+        "\\101\\102\\7\\08",
+        "\\0",
+        "\\x41\\xfg\\x",
+        "trailing\\",
+        "\\{1001,1}",
+        "{1001,1}\\",
+        "\\(not a comment\\)",
+        "\\\\{1001,2}",
+    };
+
+    QString text = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                   "<language id=\"44\">\n";
+    text.append("  <page id=\"1001\">\n");
+    for (int i = 0; i < referenced.size(); ++i) {
+        text.append(QString("    <t id=\"%1\">%2</t>\n")
+                        .arg(i + 1)
+                        .arg(referenced[i].toHtmlEscaped()));
+    }
+    text.append("  </page>\n");
+    for (int page = 0; page < pageCount; ++page) {
+        text.append(QString("  <page id=\"%1\">\n").arg(2000 + page));
+        for (int i = 0; i < corpus.size(); ++i) {
+            text.append(QString("    <t id=\"%1\">%2</t>\n")
+                            .arg(i)
+                            .arg(corpus[i].toHtmlEscaped()));
+        }
+
+        // Overwritten, elements in text and unknow elements.
+        text.append("    <t id=\"0\">overwritten {1001,1}</t>\n"
+                    "    <t id=\"1000\">a<b>skipped</b>c</t>\n"
+                    "    <unknow><t id=\"1001\">skipped</t></unknow>\n");
+        text.append("  </page>\n");
+    }
+    text.append("</language>\n");
+
+    return text.toUtf8();
+}
+
+/**
+ * @brief		Compare the texts loaded by \c GameTexts with the reference
+ *				parser.
+ *
+ * @param[in]	name		Name of the text file.
+ * @param[in]	data		Data of the text file.
+ * @param[in]	iterations	Iterations of benchmark, 0 to skip.
+ *
+ * @return		If all texts are the same, true is returned. Otherwise
+ *				returns false.
+ */
+static bool compareTexts(const QString &   name,
+                         const QByteArray &data,
+                         int               iterations)
+{
+    VFSFixture fixture;
+    fixture.addFile("t/0001-l044.xml", data);
+    ::std::shared_ptr<GameVFS> vfs = fixture.create();
+    TEST_CHECK(vfs != nullptr);
+
+    auto setText = [](const QString &) -> void {};
+    ::std::shared_ptr<GameTexts> texts = GameTexts::load(vfs, setText);
+    TEST_CHECK(texts != nullptr);
+
+    ReferenceTexts referenceTexts;
+    referenceLoad(data, referenceTexts);
+
+    // Compare all texts.
+    QSet<QPair<qint32, qint32>> ids;
+    for (auto &pages : referenceTexts) {
+        for (auto iter = pages.begin(); iter != pages.end(); ++iter) {
+            ids.insert(iter.key());
+        }
+    }
+    int mismatched = 0;
+    for (auto &id : ids) {
+        QString expected = referenceText(referenceTexts, id.first, id.second);
+        QString text     = texts->text(id.first, id.second);
+        if (text != expected) {
+            if (mismatched < 10) {
+                qWarning().noquote()
+                    << QString("Text {%1,%2} mismatched : \"%3\", "
+                               "expected \"%4\".")
+                           .arg(id.first)
+                           .arg(id.second)
+                           .arg(text)
+                           .arg(expected);
+            }
+            ++mismatched;
+        }
+    }
+    qInfo().noquote() << QString("%1 : %2 texts, %3 mismatched.")
+                             .arg(name)
+                             .arg(ids.size())
+                             .arg(mismatched);
+    TEST_CHECK(! ids.empty());
+    TEST_CHECK(mismatched == 0);
+
+    // Time.
+    if (iterations > 0) {
+        TestCase::benchmark(QString("%1, regex parser").arg(name), iterations,
+                            [&]() -> void {
+                                ReferenceTexts referenceTexts;
+                                referenceLoad(data, referenceTexts);
+                            });
+        TestCase::benchmark(QString("%1, GameTexts::load()").arg(name),
+                            iterations, [&]() -> void {
+                                GameTexts::load(vfs, setText);
+                            });
+    }
+
+    return true;
+}
+
+/**
+ * @brief		Run test. The arguments are paths of text files extracted
+ *				from the game, such as "t/0001-l044.xml", they are compared
+ *				after the built-in corpus.
+ */
+static bool runGameTextsGolden(const QStringList &args)
+{
+    if (! compareTexts("Built-in corpus", generateTextFile(1), 0)
+        || ! compareTexts("Built-in corpus x200", generateTextFile(200), 10)) {
+        return false;
+    }
+
+    for (auto &path : args) {
+        QFile file(path);
+        if (! file.open(QIODevice::OpenModeFlag::ReadOnly)) {
+            qWarning() << "Failed to open" << path << ".";
+            return false;
+        }
+        if (! compareTexts(QFileInfo(path).fileName(), file.readAll(), 3)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static TestCase gameTextsGolden("game_texts_golden", &runGameTextsGolden);
@@ -0,0 +1,155 @@
+#include <QtCore/QMap>
+#include <QtCore/QPair>
+
+#include <config.h>
+#include <game_data/game_texts.h>
+#include <game_data/vfs_fixture.h>
+#include <test.h>
+
+/**
+ * @brief		Generate text files, the texts in later files overwrite the
+ *				texts with the same ID in earlier files.
+ *
+ * @param[in]	fixture		Fixture to add files to.
+ * @param[in]	fileCount	Count of files of each language.
+ * @param[in]	textCount	Count of texts in each file.
+ * @param[out]	expected	Texts expected in en_US.
+ */
+static void generateTextFiles(VFSFixture &                          fixture,
+                              int                                   fileCount,
+                              int                                   textCount,
+                              QMap<QPair<qint32, qint32>, QString> &expected)
+{
+    expected.clear();
+    for (quint32 language : {44, 49, 7}) {
+        for (int file = 0; file < fileCount; ++file) {
+            // The texts of other languages use their own pages, so the
+            // texts of en_US are used whatever current language is.
+            qint32  pageBase = language == 44 ? 1000 : 1000 * (language + 1);
+            QString text     = QString("<?xml version=\"1.0\" "
+                                   "encoding=\"utf-8\"?>\n"
+                                   "<language id=\"%1\">\n")
+                               .arg(language);
+            for (int page = 0; page < 4; ++page) {
+                text.append(
+                    QString("  <page id=\"%1\">\n").arg(pageBase + page));
+                for (int i = 0; i < textCount; ++i) {
+                    // Each file overwrites a part of the texts.
+                    qint32 textID = (i * 7 + file * 13) % (textCount * 2);
+                    QString value = QString("L%1 F%2 P%3 T%4 {%5,%6}")
+                                        .arg(language)
+                                        .arg(file)
+                                        .arg(page)
+                                        .arg(textID)
+                                        .arg(9999)
+                                        .arg(textID);
+                    text.append(QString("    <t id=\"%1\">%2</t>\n")
+                                    .arg(textID)
+                                    .arg(value.toHtmlEscaped()));
+                    if (language == 44) {
+                        expected[{pageBase + page, textID}]
+                            = QString("L%1 F%2 P%3 T%4 ")
+                                  .arg(language)
+                                  .arg(file)
+                                  .arg(page)
+                                  .arg(textID)
+                              + QString("R%1").arg(textID);
+                    }
+                }
+                text.append("  </page>\n");
+            }
+
+            // Referenced texts.
+            if (language == 44 && file == 0) {
+                text.append("  <page id=\"9999\">\n");
+                for (int i = 0; i < textCount * 2; ++i) {
+                    text.append(
+                        QString("    <t id=\"%1\">R%1</t>\n").arg(i));
+                }
+                text.append("  </page>\n");
+            }
+            text.append("</language>\n");
+
+            fixture.addFile(QString("t/%1-l%2.xml")
+                                .arg(file + 1, 4, 10, QChar('0'))
+                                .arg(language, 3, 10, QChar('0')),
+                            text.toUtf8());
+        }
+    }
+}
+
+/**
+ * @brief		Load texts and check them.
+ *
+ * @param[in]	vfs			VFS.
+ * @param[in]	expected	Texts expected.
+ *
+ * @return		If all texts are the same as expected, true is returned.
+ *				Otherwise returns false.
+ */
+static bool checkTexts(::std::shared_ptr<GameVFS>                  vfs,
+                       const QMap<QPair<qint32, qint32>, QString> &expected)
+{
+    ::std::shared_ptr<GameTexts> texts
+        = GameTexts::load(vfs, [](const QString &) -> void {});
+    TEST_CHECK(texts != nullptr);
+
+    int mismatched = 0;
+    for (auto iter = expected.begin(); iter != expected.end(); ++iter) {
+        QString text = texts->text(iter.key().first, iter.key().second);
+        if (text != iter.value()) {
+            if (mismatched < 10) {
+                qWarning().noquote()
+                    << QString("Text {%1,%2} mismatched : \"%3\", "
+                               "expected \"%4\".")
+                           .arg(iter.key().first)
+                           .arg(iter.key().second)
+                           .arg(text)
+                           .arg(iter.value());
+            }
+            ++mismatched;
+        }
+    }
+    TEST_CHECK(mismatched == 0);
+
+    return true;
+}
+
+/**
+ * @brief		Run test, the first argument is the iterations of benchmark.
+ */
+static bool runGameTextsMerge(const QStringList &args)
+{
+    int  iterations = args.empty() ? 5 : args[0].toInt();
+    bool loadAll    = Config::instance()->getBool("/textLoadAllLanguages",
+                                               false);
+    Config::instance()->setBool("/textLoadAllLanguages", true);
+
+    VFSFixture                           fixture;
+    QMap<QPair<qint32, qint32>, QString> expected;
+    generateTextFiles(fixture, 48, 500, expected);
+    ::std::shared_ptr<GameVFS> vfs = fixture.create();
+
+    // The files are parsed by different threads in each run, the result
+    // must be the same.
+    bool passed = vfs != nullptr;
+    for (int i = 0; passed && i < 10; ++i) {
+        passed = checkTexts(vfs, expected);
+    }
+
+    if (passed) {
+        qInfo().noquote() << QString("Texts : %1 files, %2 texts checked.")
+                                 .arg(48 * 3)
+                                 .arg(expected.size());
+        TestCase::benchmark("GameTexts::load(), 144 files", iterations,
+                            [&]() -> void {
+                                GameTexts::load(
+                                    vfs, [](const QString &) -> void {});
+                            });
+    }
+
+    Config::instance()->setBool("/textLoadAllLanguages", loadAll);
+    return passed;
+}
+
+static TestCase gameTextsMerge("game_texts_merge", &runGameTextsMerge);
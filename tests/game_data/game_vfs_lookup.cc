@@ -0,0 +1,142 @@
+#include <QtCore/QVector>
+
+#include <game_data/vfs_fixture.h>
+#include <test.h>
+
+/**
+ * @brief		Read packed file.
+ *
+ * @param[in]	vfs		VFS.
+ * @param[in]	path	Path of the file.
+ *
+ * @return		Data of the file, or "<null>" if the file cannot be opened.
+ */
+static QByteArray readFile(::std::shared_ptr<GameVFS> vfs, const QString &path)
+{
+    ::std::shared_ptr<GameVFS::FileReader> file = vfs->open(path);
+    if (file == nullptr) {
+        return "<null>";
+    }
+
+    return file->readAll();
+}
+
+/**
+ * @brief		Check the lookup of paths, names matches exactly win in each
+ *				directory and siblings differ only in case are all reachable.
+ */
+static bool testLookup()
+{
+    VFSFixture fixture;
+    fixture.addFile("Libraries/a.xml", "L/a");
+    fixture.addFile("Libraries/c.xml", "L/c");
+    fixture.addFile("libraries/a.xml", "l/a");
+    fixture.addFile("libraries/b.xml", "l/b");
+    fixture.addFile("libraries/sub/d.xml", "l/sub/d");
+    ::std::shared_ptr<GameVFS> vfs = fixture.create();
+    TEST_CHECK(vfs != nullptr);
+
+    // Exact paths.
+    TEST_CHECK(readFile(vfs, "Libraries/a.xml") == "L/a");
+    TEST_CHECK(readFile(vfs, "Libraries/c.xml") == "L/c");
+    TEST_CHECK(readFile(vfs, "libraries/a.xml") == "l/a");
+    TEST_CHECK(readFile(vfs, "libraries/b.xml") == "l/b");
+    TEST_CHECK(readFile(vfs, "libraries/sub/d.xml") == "l/sub/d");
+
+    // Separators.
+    TEST_CHECK(readFile(vfs, "/libraries//b.xml") == "l/b");
+    TEST_CHECK(readFile(vfs, "\\libraries\\sub\\d.xml") == "l/sub/d");
+
+    // Case-insensitive names, the first one in order is used.
+    TEST_CHECK(readFile(vfs, "libraries/A.XML") == "l/a");
+    TEST_CHECK(readFile(vfs, "LIBRARIES/A.xml") == "L/a");
+    TEST_CHECK(readFile(vfs, "LIBRARIES/c.XML") == "L/c");
+    TEST_CHECK(readFile(vfs, "libraries/SUB/D.xml") == "l/sub/d");
+
+    // Missing files and directories.
+    TEST_CHECK(vfs->open("libraries/e.xml") == nullptr);
+    TEST_CHECK(vfs->open("libraries") == nullptr);
+    TEST_CHECK(vfs->open("libraries/a.xml/f.xml") == nullptr);
+    TEST_CHECK(vfs->openDir("libraries/sub") != nullptr);
+    TEST_CHECK(vfs->openDir("Libraries") != nullptr);
+    TEST_CHECK(vfs->openDir("missing") == nullptr);
+
+    return true;
+}
+
+/**
+ * @brief		Time the lookup of a representative set of paths.
+ *
+ * @param[in]	iterations	Iterations.
+ *
+ * @return		If all paths are found as expected, true is returned.
+ *				Otherwise returns false.
+ */
+static bool benchmarkLookup(int iterations)
+{
+    // Layout similar to the game, deep paths in a few large directories.
+    VFSFixture       fixture;
+    QVector<QString> paths;
+    for (int dir = 0; dir < 32; ++dir) {
+        for (int file = 0; file < 256; ++file) {
+            QString path = QString("assets/structures/dir_%1/macros/"
+                                   "struct_%2_macro.xml")
+                               .arg(dir)
+                               .arg(file);
+            fixture.addFile(path, "x");
+            paths.append(path);
+        }
+    }
+    ::std::shared_ptr<GameVFS> vfs = fixture.create();
+    TEST_CHECK(vfs != nullptr);
+
+    QVector<QString> exactPaths;
+    QVector<QString> casePaths;
+    QVector<QString> missingPaths;
+    for (int i = 0; i < paths.size(); i += 97) {
+        exactPaths.append(paths[i]);
+        casePaths.append(paths[i].toUpper());
+        missingPaths.append(paths[i] + ".missing");
+    }
+
+    for (auto &path : exactPaths) {
+        TEST_CHECK(vfs->open(path) != nullptr);
+    }
+    for (auto &path : casePaths) {
+        TEST_CHECK(vfs->open(path) != nullptr);
+    }
+    for (auto &path : missingPaths) {
+        TEST_CHECK(vfs->open(path) == nullptr);
+    }
+
+    // The time includes the probe of the file in game directory.
+    TestCase::benchmark("open() exact path", iterations, [&]() -> void {
+        for (auto &path : exactPaths) {
+            vfs->open(path);
+        }
+    });
+    TestCase::benchmark("open() case-insensitive path", iterations,
+                        [&]() -> void {
+                            for (auto &path : casePaths) {
+                                vfs->open(path);
+                            }
+                        });
+    TestCase::benchmark("open() missing path", iterations, [&]() -> void {
+        for (auto &path : missingPaths) {
+            vfs->open(path);
+        }
+    });
+
+    return true;
+}
+
+/**
+ * @brief		Run test, the first argument is the iterations of benchmark.
+ */
+static bool runVFSLookup(const QStringList &args)
+{
+    int iterations = args.empty() ? 100 : args[0].toInt();
+    return testLookup() && benchmarkLookup(iterations);
+}
+
+static TestCase vfsLookup("vfs_lookup", &runVFSLookup);
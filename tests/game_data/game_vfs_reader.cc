@@ -0,0 +1,167 @@
+#include <QtCore/QVector>
+
+#include <config.h>
+#include <game_data/vfs_fixture.h>
+#include <test.h>
+
+/**
+ * @brief		Generate text file with lines of different length.
+ *
+ * @param[in]	lineCount	Count of lines.
+ * @param[out]	lines		Lines generated, including the line breaks.
+ *
+ * @return		Data of the file.
+ */
+static QByteArray generateText(int lineCount, QVector<QByteArray> &lines)
+{
+    // A line longer than the read-ahead buffer.
+    QByteArray data(200 * 1024, 'x');
+    data.append('\n');
+    lines.clear();
+    lines.append(data);
+
+    for (int i = 0; i < lineCount; ++i) {
+        QByteArray line = QString("<t id=\"%1\">").arg(i).toUtf8();
+        line.append(QByteArray((i * 7) % 160, 'a' + i % 26));
+        line.append("</t>");
+
+        // The last line has no line break.
+        if (i != lineCount - 1) {
+            line.append('\n');
+        }
+        data.append(line);
+        lines.append(line);
+    }
+
+    return data;
+}
+
+/**
+ * @brief		Read lines in the old way, one byte each time.
+ *
+ * @param[in]	file		File to read.
+ *
+ * @return		Data in a line.
+ */
+static QByteArray readLineByByte(GameVFS::FileReader *file)
+{
+    QByteArray line;
+    while (! file->atEnd()) {
+        char c;
+        if (file->read(&c, 1) != 1) {
+            break;
+        }
+        line.append(c);
+        if (c == '\n') {
+            break;
+        }
+    }
+
+    return line;
+}
+
+/**
+ * @brief		Check and time the reader.
+ *
+ * @param[in]	mapped		Map dat files or not.
+ * @param[in]	iterations	Iterations of benchmark.
+ *
+ * @return		If all data read are correct, true is returned. Otherwise
+ *				returns false.
+ */
+static bool testReader(bool mapped, int iterations)
+{
+    Config::instance()->setBool("/vfsMapDatFiles", mapped);
+
+    QVector<QByteArray> lines;
+    QByteArray          data = generateText(64 * 1024, lines);
+    VFSFixture          fixture;
+    fixture.addFile("t/0001-l044.xml", data);
+    ::std::shared_ptr<GameVFS> vfs = fixture.create();
+    Config::instance()->setBool("/vfsMapDatFiles", true);
+    TEST_CHECK(vfs != nullptr);
+
+    // readAll().
+    ::std::shared_ptr<GameVFS::FileReader> file = vfs->open("t/0001-l044.xml");
+    TEST_CHECK(file != nullptr);
+    TEST_CHECK(file->readAll() == data);
+    TEST_CHECK(file->atEnd());
+
+    // readLine().
+    file = vfs->open("t/0001-l044.xml");
+    for (auto &line : lines) {
+        TEST_CHECK(file->readLine() == line);
+    }
+    TEST_CHECK(file->atEnd());
+    TEST_CHECK(file->readLine().isEmpty());
+
+    // lines().
+    file    = vfs->open("t/0001-l044.xml");
+    int idx = 0;
+    for (auto &line : file->lines()) {
+        TEST_CHECK(idx < lines.size() && line == lines[idx]);
+        ++idx;
+    }
+    TEST_CHECK(idx == lines.size());
+
+    // Mix line reads with read() and seek().
+    file = vfs->open("t/0001-l044.xml");
+    TEST_CHECK(file->readLine() == lines[0]);
+    TEST_CHECK(file->readLine() == lines[1]);
+    TEST_CHECK(file->read(lines[2].size()) == lines[2]);
+    TEST_CHECK(file->readLine() == lines[3]);
+    file->seek(-lines[3].size());
+    TEST_CHECK(file->readLine() == lines[3]);
+    file->seek(0, GameVFS::FileReader::Whence::Set);
+    TEST_CHECK(file->readLine() == lines[0]);
+    file->seek(-lines.back().size(), GameVFS::FileReader::Whence::End);
+    TEST_CHECK(file->readLine() == lines.back());
+    TEST_CHECK(file->atEnd());
+
+    // Throughput.
+    QString mode = mapped ? "mapped" : "unmapped";
+    qInfo().noquote()
+        << QString("Reader (%1) : %2 bytes, %3 lines.")
+               .arg(mode)
+               .arg(data.size())
+               .arg(lines.size());
+    TestCase::benchmark(QString("readAll() (%1)").arg(mode), iterations,
+                        [&]() -> void {
+                            vfs->open("t/0001-l044.xml")->readAll();
+                        });
+    TestCase::benchmark(QString("readLine() (%1)").arg(mode), iterations,
+                        [&]() -> void {
+                            auto file = vfs->open("t/0001-l044.xml");
+                            while (! file->atEnd()) {
+                                file->readLine();
+                            }
+                        });
+    TestCase::benchmark(QString("lines() (%1)").arg(mode), iterations,
+                        [&]() -> void {
+                            auto file = vfs->open("t/0001-l044.xml");
+                            for (auto &line : file->lines()) {
+                                (void)line;
+                            }
+                        });
+    TestCase::benchmark(
+        QString("read(1) per byte (%1)").arg(mode), iterations,
+        [&]() -> void {
+            auto file = vfs->open("t/0001-l044.xml");
+            while (! file->atEnd()) {
+                readLineByByte(file.get());
+            }
+        });
+
+    return true;
+}
+
+/**
+ * @brief		Run test, the first argument is the iterations of benchmark.
+ */
+static bool runVFSReader(const QStringList &args)
+{
+    int iterations = args.empty() ? 10 : args[0].toInt();
+    return testReader(true, iterations) && testReader(false, iterations);
+}
+
+static TestCase vfsReader("vfs_reader", &runVFSReader);
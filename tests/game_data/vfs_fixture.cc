@@ -0,0 +1,64 @@
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include <game_data/vfs_fixture.h>
+
+/**
+ * @brief		Constructor.
+ */
+VFSFixture::VFSFixture() {}
+
+/**
+ * @brief		Add packed file.
+ */
+void VFSFixture::addFile(const QString &path, const QByteArray &data)
+{
+    m_files[path] = data;
+}
+
+/**
+ * @brief		Write the cat/dat files and create VFS.
+ */
+::std::shared_ptr<GameVFS> VFSFixture::create()
+{
+    if (! m_dir.isValid()) {
+        return nullptr;
+    }
+
+    QDir  dir(m_dir.path());
+    QFile catFile(dir.absoluteFilePath("01.cat"));
+    QFile datFile(dir.absoluteFilePath("01.dat"));
+    if (! catFile.open(QIODevice::OpenModeFlag::WriteOnly)
+        || ! datFile.open(QIODevice::OpenModeFlag::WriteOnly)) {
+        return nullptr;
+    }
+
+    // Each line of cat file is "path size timestamp md5".
+    for (auto iter = m_files.begin(); iter != m_files.end(); ++iter) {
+        QByteArray hash = QCryptographicHash::hash(
+            iter.value(), QCryptographicHash::Algorithm::Md5);
+        catFile.write(QString("%1 %2 0 %3\n")
+                          .arg(iter.key())
+                          .arg(iter.value().size())
+                          .arg(QString::fromLatin1(hash.toHex()))
+                          .toUtf8());
+        datFile.write(iter.value());
+    }
+    catFile.close();
+    datFile.close();
+
+    return GameVFS::create(
+        m_dir.path(), {{"01", {"01.cat", "01.dat"}}},
+        [](const QString &) -> void {},
+        [](const QString &err) -> void { qWarning() << err; });
+}
+
+/**
+ * @brief		Get path of the game directory.
+ */
+QString VFSFixture::path() const
+{
+    return m_dir.path();
+}
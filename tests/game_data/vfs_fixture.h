@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+
+#include <game_data/game_vfs.h>
+
+/**
+ * @brief	Game directory with a generated cat/dat file pair, used to
+ *			create a \c GameVFS without the game installed.
+ */
+class VFSFixture {
+  private:
+    QTemporaryDir             m_dir;   ///< Game directory.
+    QMap<QString, QByteArray> m_files; ///< Packed files, keyed by path.
+
+  public:
+    /**
+     * @brief		Constructor.
+     */
+    VFSFixture();
+
+    /**
+     * @brief		Add packed file.
+     *
+     * @param[in]	path		Path of the file.
+     * @param[in]	data		Data of the file.
+     */
+    void addFile(const QString &path, const QByteArray &data);
+
+    /**
+     * @brief		Write the cat/dat files and create VFS.
+     *
+     * @return		On success, the VFS is returned. Otherwise returns
+     *				nullptr.
+     */
+    ::std::shared_ptr<GameVFS> create();
+
+    /**
+     * @brief		Get path of the game directory.
+     *
+     * @return		Path of the game directory.
+     */
+    QString path() const;
+};
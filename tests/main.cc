@@ -0,0 +1,81 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTextCodec>
+
+#include <common.h>
+#include <config.h>
+#include <global.h>
+#include <locale/string_table.h>
+#include <test.h>
+
+/**
+ * @brief		Entery of tests and benchmarks.
+ *
+ * Usage: x4-station-calc-tests [name [arguments...]]. Without a name, all
+ * test cases are run with default arguments.
+ *
+ * @param[in]	argc		Count of arguments.
+ * @param[in]	argv		Values of arguments.
+ *
+ * @return		Exit code.
+ */
+int main(int argc, char *argv[])
+{
+    // Force UTF-8.
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    // The tests use their own config and cache files.
+    int              exitCode;
+    int              fakeArgc   = 1;
+    char *           fakeArgv[] = {argv[0], NULL};
+    char **          globalArgv = fakeArgv;
+    QCoreApplication app(fakeArgc, fakeArgv);
+    app.setApplicationName("X4 Station Calculator Tests");
+
+    // Initialize.
+    if (Global::initialize(fakeArgc, globalArgv, exitCode) == nullptr) {
+        return exitCode;
+    }
+
+    if (Config::initialize() == nullptr) {
+        return 1;
+    }
+
+    if (StringTable::initialize() == nullptr) {
+        return 1;
+    }
+
+    if (TaskPool::initialize() == nullptr) {
+        return 1;
+    }
+
+    // Select test cases.
+    QList<const TestCase *> testCases;
+    QStringList             args;
+    if (argc > 1) {
+        auto iter = TestCase::testCases().find(QString(argv[1]));
+        if (iter == TestCase::testCases().end()) {
+            qWarning() << "Unknow test case :" << argv[1] << ".";
+            return 1;
+        }
+        testCases.append(*iter);
+        for (int i = 2; i < argc; ++i) {
+            args.append(QString(argv[i]));
+        }
+    } else {
+        testCases = TestCase::testCases().values();
+    }
+
+    // Run.
+    int failed = 0;
+    for (auto testCase : testCases) {
+        qInfo().noquote() << "Running" << testCase->name() << "...";
+        if (testCase->run(args)) {
+            qInfo().noquote() << testCase->name() << "passed.";
+        } else {
+            qWarning().noquote() << testCase->name() << "failed.";
+            ++failed;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
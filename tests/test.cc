@@ -0,0 +1,70 @@
+#include <QtCore/QElapsedTimer>
+
+#include <test.h>
+
+/**
+ * @brief		Constructor, register the test case.
+ */
+TestCase::TestCase(const QString &name, Function func) :
+    m_name(name), m_func(::std::move(func))
+{
+    TestCase::registry()[name] = this;
+}
+
+/**
+ * @brief		Get name of the test case.
+ */
+const QString &TestCase::name() const
+{
+    return m_name;
+}
+
+/**
+ * @brief		Run test case.
+ */
+bool TestCase::run(const QStringList &args) const
+{
+    return m_func(args);
+}
+
+/**
+ * @brief		Get all test cases.
+ */
+const QMap<QString, const TestCase *> &TestCase::testCases()
+{
+    return TestCase::registry();
+}
+
+/**
+ * @brief		Run function repeatly and print the average time.
+ */
+qint64 TestCase::benchmark(const QString &         name,
+                           int                     iterations,
+                           ::std::function<void()> func)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        func();
+    }
+    qint64 elapsed = timer.nsecsElapsed();
+    qint64 average = iterations > 0 ? elapsed / iterations : 0;
+
+    qInfo().noquote() << QString("%1 : %2 iterations, %3 ns/iteration.")
+                             .arg(name)
+                             .arg(iterations)
+                             .arg(average);
+
+    return average;
+}
+
+/**
+ * @brief		Get registry of test cases.
+ */
+QMap<QString, const TestCase *> &TestCase::registry()
+{
+    // Constructed on first use, the test cases are registered by static
+    // objects in other translation units.
+    static QMap<QString, const TestCase *> testCases;
+    return testCases;
+}
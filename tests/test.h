@@ -0,0 +1,90 @@
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QDebug>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+/**
+ * @brief	Test case, the test cases are registered by defining static
+ *			\c TestCase objects in the test files.
+ */
+class TestCase {
+  public:
+    /**
+     * @brief	Test function, the arguments are the command line arguments
+     *			after the name of the test case.
+     */
+    typedef ::std::function<bool(const QStringList &)> Function;
+
+  private:
+    QString  m_name; ///< Name of the test case.
+    Function m_func; ///< Test function.
+
+  public:
+    /**
+     * @brief		Constructor, register the test case.
+     *
+     * @param[in]	name		Name of the test case.
+     * @param[in]	func		Test function.
+     */
+    TestCase(const QString &name, Function func);
+
+    /**
+     * @brief		Get name of the test case.
+     *
+     * @return		Name of the test case.
+     */
+    const QString &name() const;
+
+    /**
+     * @brief		Run test case.
+     *
+     * @param[in]	args		Arguments.
+     *
+     * @return		If the test passed, true is returned. Otherwise returns
+     *				false.
+     */
+    bool run(const QStringList &args) const;
+
+    /**
+     * @brief		Get all test cases.
+     *
+     * @return		Test cases, keyed by name.
+     */
+    static const QMap<QString, const TestCase *> &testCases();
+
+    /**
+     * @brief		Run function repeatly and print the average time.
+     *
+     * @param[in]	name		Name of the benchmark.
+     * @param[in]	iterations	Iterations to run.
+     * @param[in]	func		Function to run.
+     *
+     * @return		Average time of each iteration(ns).
+     */
+    static qint64 benchmark(const QString &         name,
+                            int                     iterations,
+                            ::std::function<void()> func);
+
+  private:
+    /**
+     * @brief		Get registry of test cases.
+     *
+     * @return		Test cases, keyed by name.
+     */
+    static QMap<QString, const TestCase *> &registry();
+};
+
+/**
+ * @brief	Check condition, the test function returns false if the
+ *			condition is not satisfied.
+ */
+#define TEST_CHECK(cond)                                                       \
+    if (! (cond)) {                                                            \
+        qWarning() << __FILE__ << ":" << __LINE__                              \
+                   << ": check failed :" << #cond << ".";                      \
+        return false;                                                          \
+    }